@@ -0,0 +1,63 @@
+#include <benchmark/benchmark.h>
+
+#include <oni-core/component/oni-component-geometry.h>
+#include <oni-core/component/oni-component-physics.h>
+#include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/physics/oni-physics-system.h>
+#include <oni-core/util/oni-util-thread-pool.h>
+
+namespace {
+    constexpr oni::u32 PARTICLE_COUNT = 100 * 1000;
+    constexpr oni::duration32 TICK_DT = 1 / 60.f;
+
+    void
+    BM_EntityManager_UpdateParallel(benchmark::State &state) {
+        auto workers = static_cast<oni::u16>(state.range(0));
+        auto pool = oni::ThreadPool(workers);
+        auto em = oni::EntityManager(oni::SimMode::CLIENT, nullptr);
+        em.setThreadPool(&pool);
+
+        for (oni::u32 i = 0; i < PARTICLE_COUNT; ++i) {
+            auto id = em.createEntity();
+            em.createComponent<oni::WorldP3D>(id);
+            em.createComponent<oni::Direction>(id, oni::vec2{0.6f, 0.8f});
+            em.createComponent<oni::Velocity>(id, 1.f + (i % 7), 10.f);
+            em.createComponent<oni::Acceleration>(id, -0.1f, 1.f);
+        }
+
+        // NOTE: System_PositionAndVelocity opts into EntityManager::updateParallel()
+        auto system = oni::System_PositionAndVelocity(em);
+        for (auto _ : state) {
+            system.tick(TICK_DT);
+        }
+
+        state.counters["threads"] = workers + 1;
+        state.SetItemsProcessed(state.iterations() * PARTICLE_COUNT);
+    }
+
+    void
+    BM_EntityManager_MassExpiry(benchmark::State &state) {
+        auto em = oni::EntityManager(oni::SimMode::CLIENT, nullptr);
+        auto system = oni::System_TimeToLive(em);
+
+        for (auto _ : state) {
+            state.PauseTiming();
+            for (oni::u32 i = 0; i < PARTICLE_COUNT; ++i) {
+                auto id = em.createEntity();
+                em.createComponent<oni::TimeToLive>(id, 0.f, 0.f);
+            }
+            state.ResumeTiming();
+
+            // NOTE: Every entity expires, the deletions are recorded in the command buffer and applied in
+            // postUpdate().
+            system.tick(TICK_DT);
+        }
+
+        state.SetItemsProcessed(state.iterations() * PARTICLE_COUNT);
+    }
+}
+
+BENCHMARK(BM_EntityManager_UpdateParallel)->Arg(0)->Arg(1)->Arg(3)->Arg(7)->Arg(15)
+        ->Unit(benchmark::kMicrosecond)->UseRealTime();
+
+BENCHMARK(BM_EntityManager_MassExpiry)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,199 @@
+#include <benchmark/benchmark.h>
+
+#include <oni-core/component/oni-component-geometry.h>
+#include <oni-core/component/oni-component-physics.h>
+#include <oni-core/component/oni-component-tag.h>
+#include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/entities/oni-entities-serialization.h>
+#include <oni-core/entities/oni-entities-serialization-network.h>
+#include <oni-core/util/oni-util-enum.h>
+
+namespace oni {
+    ONI_ENUM_DEF_WITH_BASE(EntityNameBench, EntityName, { 1, "bench-entity" })
+}
+
+namespace {
+    constexpr oni::u32 ENTITY_COUNT = 10 * 1000;
+    constexpr oni::u32 SNAPSHOT_ENTITY_COUNT = 1000;
+
+    void
+    populate(oni::EntityManager &em,
+             oni::u32 count) {
+        for (oni::u32 i = 0; i < count; ++i) {
+            auto id = em.createEntity();
+            auto &pos = em.createComponent<oni::WorldP3D>(id);
+            pos.x = i * 1.f;
+            pos.y = i * 2.f;
+            em.createComponent<oni::Orientation>(id);
+            em.createComponent<oni::Scale>(id);
+            em.createComponent<oni::Direction>(id);
+            em.createComponent<oni::Velocity>(id);
+            em.createComponent<oni::Acceleration>(id);
+        }
+    }
+
+    void
+    populateNetworked(oni::EntityManager &em,
+                      oni::u32 count) {
+        for (oni::u32 i = 0; i < count; ++i) {
+            auto id = em.createEntity(oni::EntityNameBench::GET("bench-entity"));
+            auto &pos = em.createComponent<oni::WorldP3D>(id);
+            pos.x = i * 1.37f;
+            pos.y = i * 2.71f;
+        }
+    }
+
+    void
+    registerEnums() {
+        oni::registerNetworkEnum<oni::EntityName, oni::EntityNameBench>();
+    }
+
+    // NOTE: Partial snapshots only pick up entities carrying the matching tag, and taking the snapshot clears it.
+    void
+    tagForSnapshot(oni::EntityManager &em,
+                   oni::SnapshotType type) {
+        auto view = em.createView<oni::WorldP3D>();
+        for (auto &&id: view) {
+            switch (type) {
+                case oni::SnapshotType::ONLY_COMPONENTS: {
+                    em.assignTag<oni::Tag_NetworkSyncComponent>(id);
+                    break;
+                }
+                case oni::SnapshotType::ONLY_NEW_ENTITIES: {
+                    em.assignTag<oni::Tag_NetworkSyncEntity>(id);
+                    break;
+                }
+                default: {
+                    break;
+                }
+            }
+        }
+    }
+
+    void
+    BM_EntityManager_CreateDeleteEntity(benchmark::State &state) {
+        auto em = oni::EntityManager(oni::SimMode::CLIENT, nullptr);
+        auto ids = std::vector<oni::EntityID>(ENTITY_COUNT);
+
+        for (auto _ : state) {
+            for (auto &&id: ids) {
+                id = em.createEntity();
+            }
+            for (auto &&id: ids) {
+                em.deleteEntity(id);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+    }
+
+    template<class... Components>
+    void
+    BM_EntityManager_View(benchmark::State &state) {
+        auto em = oni::EntityManager(oni::SimMode::CLIENT, nullptr);
+        populate(em, ENTITY_COUNT);
+
+        for (auto _ : state) {
+            auto view = em.createView<Components...>();
+            for (auto &&id: view) {
+                (benchmark::DoNotOptimize(view.template get<Components>(id)), ...);
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * ENTITY_COUNT);
+    }
+
+    void
+    BM_EntityManager_Serialize(benchmark::State &state) {
+        registerEnums();
+        auto type = static_cast<oni::SnapshotType>(state.range(0));
+        auto em = oni::EntityManager(oni::SimMode::CLIENT, nullptr);
+        populateNetworked(em, SNAPSHOT_ENTITY_COUNT);
+
+        auto bytes = oni::size{};
+        for (auto _ : state) {
+            state.PauseTiming();
+            tagForSnapshot(em, type);
+            state.ResumeTiming();
+
+            auto data = oni::serialize<oni::EntityName, oni::WorldP3D>(em, type);
+            bytes += data.size();
+            benchmark::DoNotOptimize(data);
+        }
+
+        state.SetBytesProcessed(bytes);
+        state.SetItemsProcessed(state.iterations() * SNAPSHOT_ENTITY_COUNT);
+        state.counters["payload"] = static_cast<double>(bytes) / state.iterations();
+    }
+
+    // NOTE: What serialize() used before the network archive, to compare payload sizes against.
+    void
+    BM_EntityManager_SerializePortableBinary(benchmark::State &state) {
+        auto type = static_cast<oni::SnapshotType>(state.range(0));
+        auto em = oni::EntityManager(oni::SimMode::CLIENT, nullptr);
+        populateNetworked(em, SNAPSHOT_ENTITY_COUNT);
+
+        auto bytes = oni::size{};
+        for (auto _ : state) {
+            state.PauseTiming();
+            tagForSnapshot(em, type);
+            state.ResumeTiming();
+
+            auto storage = std::ostringstream{};
+            {
+                cereal::PortableBinaryOutputArchive output{storage};
+                em.snapshot<cereal::PortableBinaryOutputArchive, oni::EntityName, oni::WorldP3D>(output, type);
+            }
+            auto data = storage.str();
+            bytes += data.size();
+            benchmark::DoNotOptimize(data);
+        }
+
+        state.SetBytesProcessed(bytes);
+        state.SetItemsProcessed(state.iterations() * SNAPSHOT_ENTITY_COUNT);
+        state.counters["payload"] = static_cast<double>(bytes) / state.iterations();
+    }
+
+    void
+    BM_EntityManager_Deserialize(benchmark::State &state) {
+        registerEnums();
+        auto type = static_cast<oni::SnapshotType>(state.range(0));
+        auto server = oni::EntityManager(oni::SimMode::CLIENT, nullptr);
+        populateNetworked(server, SNAPSHOT_ENTITY_COUNT);
+        tagForSnapshot(server, type);
+        auto data = oni::serialize<oni::EntityName, oni::WorldP3D>(server, type);
+
+        auto client = oni::EntityManager(oni::SimMode::CLIENT, nullptr);
+        for (auto _ : state) {
+            oni::deserialize<oni::EntityName, oni::WorldP3D>(client, data, type);
+        }
+
+        state.SetBytesProcessed(state.iterations() * data.size());
+        state.SetItemsProcessed(state.iterations() * SNAPSHOT_ENTITY_COUNT);
+    }
+
+    void
+    snapshotTypes(benchmark::internal::Benchmark *bench) {
+        bench->ArgName("type");
+        bench->Arg(static_cast<int64_t>(oni::SnapshotType::ONLY_COMPONENTS));
+        bench->Arg(static_cast<int64_t>(oni::SnapshotType::ONLY_NEW_ENTITIES));
+        bench->Arg(static_cast<int64_t>(oni::SnapshotType::ENTIRE_REGISTRY));
+    }
+}
+
+BENCHMARK(BM_EntityManager_CreateDeleteEntity)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_TEMPLATE(BM_EntityManager_View, oni::WorldP3D)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_EntityManager_View, oni::WorldP3D, oni::Orientation)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_EntityManager_View, oni::WorldP3D, oni::Orientation, oni::Scale)
+        ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_EntityManager_View, oni::WorldP3D, oni::Orientation, oni::Scale, oni::Direction)
+        ->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_EntityManager_View, oni::WorldP3D, oni::Orientation, oni::Scale, oni::Direction,
+                   oni::Velocity)->Unit(benchmark::kMicrosecond);
+BENCHMARK_TEMPLATE(BM_EntityManager_View, oni::WorldP3D, oni::Orientation, oni::Scale, oni::Direction,
+                   oni::Velocity, oni::Acceleration)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK(BM_EntityManager_Serialize)->Apply(snapshotTypes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EntityManager_SerializePortableBinary)->Apply(snapshotTypes)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_EntityManager_Deserialize)->Apply(snapshotTypes)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,155 @@
+#include <array>
+#include <queue>
+
+#include <benchmark/benchmark.h>
+
+#include <oni-core/component/oni-component-geometry.h>
+#include <oni-core/component/oni-component-visual.h>
+#include <oni-core/graphic/oni-graphic-particle.h>
+#include <oni-core/graphic/oni-graphic-render-queue.h>
+#include <oni-core/graphic/oni-graphic-renderer.h>
+#include <oni-core/graphic/oni-graphic-texture-manager.h>
+#include <oni-core/math/oni-math-rand.h>
+
+namespace {
+    void
+    makeSprites(oni::u32 count,
+                std::vector<oni::WorldP3D> &positions,
+                std::vector<oni::Material_Definition> &defs) {
+        auto rand = oni::Rand(1);
+        positions.resize(count);
+        defs.resize(count);
+        for (oni::u32 i = 0; i < count; ++i) {
+            positions[i].x = rand.next_r32(-100.f, 100.f);
+            positions[i].y = rand.next_r32(-100.f, 100.f);
+            positions[i].z = rand.next_r32(0.f, 1.f);
+            defs[i].finish = oni::Material_Finish::at(rand.next<oni::u32>(0, oni::Material_Finish::size()));
+            defs[i].skin.texture.id = rand.next<oni::u32>(0, 32);
+        }
+    }
+
+    // NOTE: SceneManager::submit() needs a GL context, this replays the part of it that is pure CPU: pushing
+    // Renderables into the RenderQueue and sorting it in render().
+    void
+    BM_SceneManager_RenderQueue(benchmark::State &state) {
+        auto count = static_cast<oni::u32>(state.range(0));
+        auto positions = std::vector<oni::WorldP3D>{};
+        auto defs = std::vector<oni::Material_Definition>{};
+        makeSprites(count, positions, defs);
+        auto ornt = oni::Orientation{};
+        auto scale = oni::Scale{};
+        auto queue = oni::RenderQueue{};
+
+        for (auto _ : state) {
+            queue.clear();
+            for (oni::u32 i = 0; i < count; ++i) {
+                auto renderable = oni::Renderable{};
+                renderable.id = i;
+                renderable.pos = &positions[i];
+                renderable.ornt = &ornt;
+                renderable.scale = &scale;
+                renderable.materialDef = &defs[i];
+                queue.push(defs[i].finish, renderable);
+            }
+            queue.sort();
+            benchmark::DoNotOptimize(queue.getKey(0));
+        }
+
+        state.SetItemsProcessed(state.iterations() * count);
+    }
+
+    // NOTE: What SceneManager used before RenderQueue, for comparison.
+    void
+    BM_SceneManager_PriorityQueue(benchmark::State &state) {
+        auto count = static_cast<oni::u32>(state.range(0));
+        auto positions = std::vector<oni::WorldP3D>{};
+        auto defs = std::vector<oni::Material_Definition>{};
+        makeSprites(count, positions, defs);
+        auto ornt = oni::Orientation{};
+        auto scale = oni::Scale{};
+
+        for (auto _ : state) {
+            auto queues = std::array<std::priority_queue<oni::Renderable>, oni::Material_Finish::size()>{};
+            for (oni::u32 i = 0; i < count; ++i) {
+                auto renderable = oni::Renderable{};
+                renderable.id = i;
+                renderable.pos = &positions[i];
+                renderable.ornt = &ornt;
+                renderable.scale = &scale;
+                renderable.materialDef = &defs[i];
+                queues[defs[i].finish.id].push(renderable);
+            }
+            for (auto &&queue: queues) {
+                while (!queue.empty()) {
+                    benchmark::DoNotOptimize(queue.top().id);
+                    queue.pop();
+                }
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * count);
+    }
+
+    // NOTE: Only the CPU blend, the upload done by blendAndUpdateTexture() needs a GL context.
+    void
+    BM_TextureManager_Blend(benchmark::State &state) {
+        auto brushSize = static_cast<oni::u32>(state.range(0));
+        constexpr oni::u32 textureSize = 1024;
+        constexpr oni::u32 elementsInRGBA = 4;
+
+        auto texture = oni::Image{};
+        texture.width = textureSize;
+        texture.height = textureSize;
+        auto brush = oni::Image{};
+        brush.width = brushSize;
+        brush.height = brushSize;
+
+        auto storageTexture = std::vector<oni::u8>(textureSize * textureSize * elementsInRGBA, 64);
+        auto storageBrush = std::vector<oni::u8>(brushSize * brushSize * elementsInRGBA, 200);
+        auto subImage = std::vector<oni::u8>{};
+        auto brushPos = oni::vec3{textureSize / 2.f, textureSize / 2.f, 0.f};
+
+        for (auto _ : state) {
+            oni::oniGLint xOffset{};
+            oni::oniGLint yOffset{};
+            oni::oniGLint width{};
+            oni::oniGLint height{};
+            oni::TextureManager::blend(texture, brush, storageTexture, storageBrush, brushPos,
+                                       subImage, xOffset, yOffset, width, height);
+            benchmark::DoNotOptimize(subImage.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * brushSize * brushSize);
+    }
+
+    // NOTE: Steady state, the time to live is long enough that nothing dies and compaction only scans.
+    void
+    BM_ParticlePool_Update(benchmark::State &state) {
+        auto count = static_cast<oni::u32>(state.range(0));
+        auto rand = oni::Rand(1);
+        auto emitter = oni::ParticleEmitter{};
+        emitter.acc = -1.f;
+        emitter.growth.period = 1.f;
+        emitter.growth.factor = 0.1f;
+        emitter.growth.maxSize = {2.f, 2.f, 1.f};
+        emitter.ttlMin = 1000.f;
+        emitter.ttlMax = 2000.f;
+
+        auto pool = oni::ParticlePool(emitter);
+        pool.spawn(emitter, {}, count, rand);
+
+        for (auto _ : state) {
+            pool.update(0.001f);
+            benchmark::DoNotOptimize(pool.getX());
+        }
+
+        state.SetItemsProcessed(state.iterations() * count);
+    }
+}
+
+BENCHMARK(BM_SceneManager_RenderQueue)->Arg(10 * 1000)->Arg(100 * 1000)->Arg(500 * 1000)
+        ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SceneManager_PriorityQueue)->Arg(10 * 1000)->Arg(100 * 1000)->Arg(500 * 1000)
+        ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ParticlePool_Update)->Arg(10 * 1000)->Arg(100 * 1000)->Arg(500 * 1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_TextureManager_Blend)->Arg(16)->Arg(64)->Arg(256)->Unit(benchmark::kMicrosecond);
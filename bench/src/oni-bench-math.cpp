@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+
+#include <oni-core/math/oni-math-mat4.h>
+#include <oni-core/math/oni-math-rand.h>
+#include <oni-core/math/oni-math-spatial-grid.h>
+#include <oni-core/math/oni-math-vec3.h>
+#include <oni-core/util/oni-util-hash.h>
+
+namespace {
+    constexpr oni::u32 BATCH_SIZE = 1024;
+
+    void
+    BM_Mat4_Multiply(benchmark::State &state) {
+        auto left = oni::mat4::rotation(0.3f, oni::vec3{0.f, 0.f, 1.f}) * oni::mat4::translation(1.f, 2.f, 3.f);
+        auto right = oni::mat4::scale(2.f, 2.f, 1.f);
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(left);
+            benchmark::DoNotOptimize(right);
+            auto result = left * right;
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    void
+    BM_Mat4_Inverse(benchmark::State &state) {
+        auto m = oni::mat4::rotation(0.3f, oni::vec3{0.f, 0.f, 1.f}) * oni::mat4::translation(1.f, 2.f, 3.f);
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(m);
+            auto result = m.inverse();
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    void
+    BM_Rand_NextR32(benchmark::State &state) {
+        auto rand = oni::Rand(1);
+
+        for (auto _ : state) {
+            for (oni::u32 i = 0; i < BATCH_SIZE; ++i) {
+                benchmark::DoNotOptimize(rand.next_r32());
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+    }
+
+    void
+    BM_Rand_FillR32(benchmark::State &state) {
+        auto rand = oni::Rand(1);
+        auto values = std::vector<oni::r32>(BATCH_SIZE);
+
+        for (auto _ : state) {
+            rand.fill_r32(values.data(), values.size(), 0.f, 1.f);
+            benchmark::DoNotOptimize(values.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+    }
+
+    void
+    BM_Rand_NextBounded(benchmark::State &state) {
+        auto rand = oni::Rand(1);
+
+        for (auto _ : state) {
+            for (oni::u32 i = 0; i < BATCH_SIZE; ++i) {
+                benchmark::DoNotOptimize(rand.next<oni::u32>(3, 1000));
+            }
+        }
+
+        state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+    }
+
+    void
+    BM_Rand_FillU32(benchmark::State &state) {
+        auto rand = oni::Rand(1);
+        auto values = std::vector<oni::u32>(BATCH_SIZE);
+
+        for (auto _ : state) {
+            rand.fill_u32(values.data(), values.size(), 3, 1000);
+            benchmark::DoNotOptimize(values.data());
+        }
+
+        state.SetItemsProcessed(state.iterations() * BATCH_SIZE);
+    }
+
+    // NOTE: Every string after the first is already interned, which is the common case at runtime.
+    void
+    BM_HashedString_MakeFromCStr(benchmark::State &state) {
+        const oni::c8 *value = "oni-bench-hashed-string-with-a-realistic-length";
+
+        for (auto _ : state) {
+            benchmark::DoNotOptimize(value);
+            auto result = oni::HashedString::makeFromCStr(value);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+
+    // NOTE: One entity per 4 square meters whatever the count, so a 16x9 view always sees about 36 of them.
+    std::vector<oni::r32>
+    makeGridPositions(oni::u32 count) {
+        auto rand = oni::Rand(1);
+        auto side = std::sqrt(static_cast<oni::r32>(count)) * 2.f;
+        auto positions = std::vector<oni::r32>(count * 2);
+        for (auto &&p: positions) {
+            p = rand.next_r32(0.f, side);
+        }
+        return positions;
+    }
+
+    void
+    updateGrid(oni::SpatialGrid &grid,
+               const std::vector<oni::r32> &positions) {
+        for (oni::u32 i = 0; i < positions.size() / 2; ++i) {
+            grid.update(i, positions[i * 2], positions[i * 2 + 1], 0.5f);
+        }
+        grid.removeStale();
+    }
+
+    // NOTE: What SceneManager::submit() pays per frame for entities that didn't change cell.
+    void
+    BM_SpatialGrid_Update(benchmark::State &state) {
+        auto count = static_cast<oni::u32>(state.range(0));
+        auto positions = makeGridPositions(count);
+        auto grid = oni::SpatialGrid(8.f);
+        updateGrid(grid, positions);
+
+        for (auto _ : state) {
+            updateGrid(grid, positions);
+        }
+
+        state.SetItemsProcessed(state.iterations() * count);
+    }
+
+    void
+    BM_SpatialGrid_Query(benchmark::State &state) {
+        auto count = static_cast<oni::u32>(state.range(0));
+        auto grid = oni::SpatialGrid(8.f);
+        updateGrid(grid, makeGridPositions(count));
+        auto center = std::sqrt(static_cast<oni::r32>(count));
+
+        for (auto _ : state) {
+            auto found = oni::u32{0};
+            grid.query(center - 8.f, center - 4.5f, center + 8.f, center + 4.5f, [&](oni::EntityID) { ++found; });
+            benchmark::DoNotOptimize(found);
+        }
+    }
+}
+
+BENCHMARK(BM_Mat4_Multiply);
+BENCHMARK(BM_Mat4_Inverse);
+BENCHMARK(BM_Rand_NextR32);
+BENCHMARK(BM_Rand_FillR32);
+BENCHMARK(BM_Rand_NextBounded);
+BENCHMARK(BM_Rand_FillU32);
+BENCHMARK(BM_HashedString_MakeFromCStr);
+BENCHMARK(BM_SpatialGrid_Update)->Arg(10 * 1000)->Arg(100 * 1000)->Arg(500 * 1000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SpatialGrid_Query)->Arg(10 * 1000)->Arg(100 * 1000)->Arg(500 * 1000);
@@ -0,0 +1,39 @@
+#include <benchmark/benchmark.h>
+
+#include <oni-core/component/oni-component-geometry.h>
+#include <oni-core/component/oni-component-physics.h>
+#include <oni-core/io/oni-io-input-structure.h>
+#include <oni-core/physics/oni-physics-car.h>
+
+namespace {
+    constexpr oni::r64 TICK_DT = 1 / 60.0;
+    constexpr oni::u32 TICKS_PER_RUN = 600;
+
+    void
+    BM_Physics_TickCar(benchmark::State &state) {
+        auto car = oni::Car{};
+        auto pos = oni::WorldP3D{};
+        auto ornt = oni::Orientation{};
+        auto config = oni::CarConfig{};
+        auto input = oni::CarInput{};
+        input.throttle = 1.f;
+        input.left = 0.5f;
+
+        auto ticks = oni::u32{};
+        for (auto _ : state) {
+            // NOTE: Start over every few seconds of sim time so the car doesn't drift into a regime no real game
+            // would ever see.
+            if (++ticks == TICKS_PER_RUN) {
+                ticks = 0;
+                car = {};
+                pos = {};
+                ornt = {};
+            }
+            oni::tickCar(car, pos, ornt, config, input, TICK_DT);
+            benchmark::DoNotOptimize(car);
+            benchmark::DoNotOptimize(pos);
+        }
+    }
+}
+
+BENCHMARK(BM_Physics_TickCar);
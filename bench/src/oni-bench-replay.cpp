@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include <oni-core/entities/oni-entities-replay.h>
+
+namespace {
+    constexpr oni::u32 NUM_PLAYERS = 32;
+    constexpr oni::u32 TICK_RATE = 60;
+    // NOTE: 10 minutes
+    constexpr oni::u32 NUM_TICKS = 10 * 60 * TICK_RATE;
+    constexpr oni::r64 TICK_DT = 1.0 / TICK_RATE;
+    // NOTE: Out of the way of whatever directory the bench runs from
+    const std::string REPLAY_PATH = (std::filesystem::temp_directory_path() / "oni-bench-replay.onir").string();
+
+    // NOTE: Players hold a key combination for a while and then switch, like they would steering a car.
+    oni::Input
+    playerInput(oni::u32 player,
+                oni::u32 tick) {
+        auto input = oni::Input{};
+        auto phase = (tick / (15 + player % 20) + player) % 4;
+        input.setPressed(static_cast<oni::oniKeyPress>(87));
+        if (phase == 1) {
+            input.setPressed(static_cast<oni::oniKeyPress>(65));
+        } else if (phase == 2) {
+            input.setPressed(static_cast<oni::oniKeyPress>(68));
+        } else if (phase == 3) {
+            input.setReleased(static_cast<oni::oniKeyPress>(87));
+        }
+        return input;
+    }
+
+    void
+    recordSession() {
+        auto recorder = oni::ReplayRecorder{};
+        recorder.open(REPLAY_PATH);
+        recorder.recordWorld(std::string(64 * 1024, 'w'));
+        for (oni::u32 i = 0; i < NUM_PLAYERS; ++i) {
+            recorder.recordClientJoined("player-" + std::to_string(i), i + 1);
+        }
+        for (oni::u32 tick = 0; tick < NUM_TICKS; ++tick) {
+            for (oni::u32 i = 0; i < NUM_PLAYERS; ++i) {
+                recorder.recordInput("player-" + std::to_string(i), playerInput(i, tick));
+            }
+            recorder.endTick(TICK_DT);
+        }
+    }
+
+    void
+    BM_Replay_Record(benchmark::State &state) {
+        for (auto _ : state) {
+            recordSession();
+        }
+        state.counters["ticks"] = benchmark::Counter(static_cast<double>(state.iterations()) * NUM_TICKS,
+                                                     benchmark::Counter::kIsRate);
+    }
+
+    // NOTE: Only the file side of a playback, the simulation on top of it is measured with
+    // ServerGame::runReplay() against a real world.
+    void
+    BM_Replay_Read(benchmark::State &state) {
+        recordSession();
+
+        auto tick = oni::ReplayTick{};
+        auto events = oni::u64{0};
+        for (auto _ : state) {
+            auto reader = oni::ReplayReader{};
+            reader.open(REPLAY_PATH);
+            while (reader.next(tick)) {
+                events += tick.events.size();
+            }
+            benchmark::DoNotOptimize(events);
+        }
+        state.counters["ticks"] = benchmark::Counter(static_cast<double>(state.iterations()) * NUM_TICKS,
+                                                     benchmark::Counter::kIsRate);
+        std::remove(REPLAY_PATH.c_str());
+    }
+}
+
+BENCHMARK(BM_Replay_Record)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_Replay_Read)->Unit(benchmark::kMillisecond)->UseRealTime();
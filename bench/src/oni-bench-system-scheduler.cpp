@@ -0,0 +1,147 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <oni-core/component/oni-component-geometry.h>
+#include <oni-core/component/oni-component-physics.h>
+#include <oni-core/component/oni-component-visual.h>
+#include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/physics/oni-physics-system.h>
+#include <oni-core/system/oni-system.h>
+#include <oni-core/system/oni-system-scheduler.h>
+#include <oni-core/util/oni-util-thread-pool.h>
+
+namespace {
+    constexpr oni::u32 WORLD_SIZE = 100 * 1000;
+    constexpr oni::duration32 TICK_DT = 1 / 60.f;
+
+    // NOTE: Synthetic systems with a bit of math in them, each touching a disjoint set of components so the
+    // scheduler can run them side by side.
+    class System_BenchAge : public oni::SystemTemplate<oni::TimeToLive> {
+    public:
+        explicit System_BenchAge(oni::EntityManager &em) : SystemTemplate(em) {}
+
+    protected:
+        void
+        update(oni::EntityTickContext &etc,
+               oni::TimeToLive &ttl) override {
+            ttl.currentAge = std::fmod(ttl.currentAge + static_cast<oni::r32>(etc.dt), ttl.maxAge);
+        }
+
+        void
+        postUpdate(oni::EntityManager &,
+                   oni::duration32) override {}
+    };
+
+    class System_BenchSpin : public oni::SystemTemplate<oni::Orientation, const oni::Velocity> {
+    public:
+        explicit System_BenchSpin(oni::EntityManager &em) : SystemTemplate(em) {}
+
+    protected:
+        void
+        update(oni::EntityTickContext &etc,
+               oni::Orientation &ornt,
+               const oni::Velocity &velocity) override {
+            ornt.value = std::fmod(ornt.value + std::sin(velocity.current) * static_cast<oni::r32>(etc.dt),
+                                   oni::r32(6.2831853f));
+        }
+
+        void
+        postUpdate(oni::EntityManager &,
+                   oni::duration32) override {}
+    };
+
+    class System_BenchPulse : public oni::SystemTemplate<oni::Scale, const oni::TimeToLive> {
+    public:
+        explicit System_BenchPulse(oni::EntityManager &em) : SystemTemplate(em) {}
+
+    protected:
+        void
+        update(oni::EntityTickContext &,
+               oni::Scale &scale,
+               const oni::TimeToLive &ttl) override {
+            auto t = ttl.currentAge / ttl.maxAge;
+            scale.x = 1.f + 0.5f * std::sin(t * 6.2831853f);
+            scale.y = scale.x;
+        }
+
+        void
+        postUpdate(oni::EntityManager &,
+                   oni::duration32) override {}
+    };
+
+    class System_BenchTint : public oni::SystemTemplate<oni::Color, const oni::WorldP3D> {
+    public:
+        explicit System_BenchTint(oni::EntityManager &em) : SystemTemplate(em) {}
+
+    protected:
+        void
+        update(oni::EntityTickContext &,
+               oni::Color &color,
+               const oni::WorldP3D &pos) override {
+            auto d = std::sqrt(pos.x * pos.x + pos.y * pos.y);
+            color.set_a(1.f / (1.f + d * 0.01f));
+        }
+
+        void
+        postUpdate(oni::EntityManager &,
+                   oni::duration32) override {}
+    };
+
+    void
+    populate(oni::EntityManager &em) {
+        for (oni::u32 i = 0; i < WORLD_SIZE; ++i) {
+            auto id = em.createEntity();
+            auto &pos = em.createComponent<oni::WorldP3D>(id);
+            pos.x = static_cast<oni::r32>(i % 1000);
+            pos.y = static_cast<oni::r32>(i / 1000);
+            em.createComponent<oni::Orientation>(id);
+            em.createComponent<oni::Scale>(id);
+            em.createComponent<oni::Direction>(id, oni::vec2{1.f, 0.f});
+            em.createComponent<oni::Velocity>(id, 1.f + (i % 7), 10.f);
+            em.createComponent<oni::Acceleration>(id, 0.1f, 1.f);
+            em.createComponent<oni::TimeToLive>(id, 0.f, 1.f + (i % 5));
+            em.createComponent<oni::Color>(id);
+        }
+    }
+
+    void
+    BM_SystemScheduler_Tick(benchmark::State &state) {
+        auto workers = static_cast<oni::u16>(state.range(0));
+        auto em = oni::EntityManager(oni::SimMode::CLIENT, nullptr);
+        populate(em);
+
+        auto pool = oni::ThreadPool(workers);
+        auto scheduler = oni::SystemScheduler(pool);
+
+        auto systems = std::vector<std::unique_ptr<oni::System>>();
+        systems.emplace_back(std::make_unique<oni::System_PositionAndVelocity>(em));
+        systems.emplace_back(std::make_unique<System_BenchAge>(em));
+        systems.emplace_back(std::make_unique<System_BenchSpin>(em));
+        systems.emplace_back(std::make_unique<System_BenchPulse>(em));
+        systems.emplace_back(std::make_unique<System_BenchTint>(em));
+        for (auto &&system: systems) {
+            scheduler.add(system.get());
+        }
+
+        for (auto _ : state) {
+            scheduler.tick(TICK_DT);
+        }
+
+        state.counters["threads"] = workers + 1;
+        state.counters["ticks"] = benchmark::Counter(static_cast<double>(state.iterations()),
+                                                     benchmark::Counter::kIsRate);
+    }
+
+    void
+    schedulerThreadCounts(benchmark::internal::Benchmark *b) {
+        auto maxWorkers = oni::ThreadPool::defaultWorkerCount();
+        for (oni::u16 workers = 0; workers <= maxWorkers; workers = workers ? workers * 2 : 1) {
+            b->Arg(workers);
+        }
+    }
+}
+
+BENCHMARK(BM_SystemScheduler_Tick)->Apply(schedulerThreadCounts)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -5,8 +5,8 @@
 
 namespace oni {
     class System_CarEnginePitch : public SystemTemplate<
-            Car,
-            Sound,
+            const Car,
+            const Sound,
             SoundPitch> {
     public:
         explicit System_CarEnginePitch(EntityManager &);
@@ -14,8 +14,8 @@ namespace oni {
     protected:
         void
         update(EntityTickContext &context,
-               Car &,
-               Sound &,
+               const Car &,
+               const Sound &,
                SoundPitch &) override;
 
         void
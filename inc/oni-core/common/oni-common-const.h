@@ -1,5 +1,7 @@
 #pragma once
 
+#include <limits>
+
 #include <oni-core/common/oni-common-typedef.h>
 
 
@@ -14,6 +16,13 @@ namespace oni {
     static constexpr i64 i64Max = std::numeric_limits<i64>::max();
     static constexpr u64 u64Max = std::numeric_limits<u64>::max();
     static constexpr u32 maxNumTextureSamplers{32};
+    // NOTE: Parallel entity updates aim for chunks whose components fit in L1, but never smaller than the minimum
+    // so the scheduling overhead doesn't eat the gains.
+    static constexpr size PARALLEL_CHUNK_BYTES = 32 * 1024;
+    static constexpr size PARALLEL_CHUNK_MIN_ENTITIES = 256;
+    // NOTE: Number of component snapshots the server and the clients keep around as delta baselines. A client
+    // that hasn't acknowledged anything for this many snapshots gets a full one.
+    static constexpr u32 NETWORK_SNAPSHOT_HISTORY = 64;
     static constexpr r32 PI = 3.14159265358979323846f;
     static constexpr r32 HALF_PI = 3.14159265358979323846f / 2.f;
     static constexpr r32 TWO_PI = PI * 2;
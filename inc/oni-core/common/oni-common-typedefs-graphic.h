@@ -2,6 +2,9 @@
 
 #include <cstddef>
 
+// NOTE: Same as GLsync, declared here to keep GL headers out
+struct __GLsync;
+
 namespace oni {
     typedef unsigned int oniGLenum;
     typedef unsigned int oniGLbitfield;
@@ -22,4 +25,5 @@ namespace oni {
     typedef void oniGLvoid;
     typedef std::ptrdiff_t oniGLintptr;
     typedef std::ptrdiff_t oniGLsizeiptr;
+    typedef ::__GLsync *oniGLsync;
 }
@@ -26,6 +26,7 @@ namespace oni {
     struct Quad;
     struct Rectangle;
     struct WorldP3D_History;
+    struct WorldTransform;
 
     /// Physics
     struct Acceleration;
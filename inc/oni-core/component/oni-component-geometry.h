@@ -157,6 +157,19 @@ namespace oni {
         EntityID id{};
     };
 
+    struct WorldTransform {
+        // NOTE: Pose of an attached entity in the world, resolved by System_WorldTransform. Like the parent
+        // transforms it replaces, z is the entity's own.
+        WorldP3D pos{};
+        Orientation ornt{};
+
+        // NOTE: Inputs of the last resolve, the entity is dirty when any of them differ
+        WorldP3D localPos{};
+        Orientation localOrnt{};
+        WorldP3D parentPos{};
+        Orientation parentOrnt{};
+    };
+
     struct Quad {
         /**
          *    b +---+ c
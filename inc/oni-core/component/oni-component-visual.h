@@ -395,6 +395,9 @@ namespace oni {
         r32 orientMin = 0.f;
         r32 orientMax = TWO_PI;
         r32 acc = 0.f;
+        // NOTE: Seconds, particles live a random time in this range
+        r32 ttlMin = 1.f;
+        r32 ttlMax = 2.f;
         u8 count = 1;
         GrowOverTime growth{};
     };
@@ -4,12 +4,21 @@
 #include <mutex>
 
 #include <oni-core/io/oni-io-input.h>
+#include <oni-core/entities/oni-entities-fwd.h>
 
 
 namespace oni {
+    struct InputSequence {
+        // NOTE: Sequence of the input held for the car, 0 if the client doesn't predict
+        u32 received{0};
+        // NOTE: Sequence of the last input System_CarInput applied to the car
+        u32 applied{0};
+    };
+
     typedef std::map<std::string, EntityID> ClientToCarEntity;
     typedef std::map<EntityID, std::string> CarEntityToClient;
     typedef std::map<EntityID, Input> CarEntityToInput;
+    typedef std::map<EntityID, InputSequence> CarEntityToInputSequence;
     typedef std::vector<std::string> ClientList;
     typedef std::vector<EntityID> CarEntities;
 
@@ -26,19 +35,33 @@ namespace oni {
         void
         deleteClient(const std::string &clientID);
 
+        // NOTE: sequence is the one the client sent along with the input, see Server::getInputSequence().
         void
         setClientInput(const std::string &clientID,
-                       const Input &input);
+                       const Input &input,
+                       u32 sequence = 0);
 
         const Input *
         getClientInput(const EntityID &entityID) const;
 
+        // NOTE: Called by System_CarInput once it applied the input of the car. Only touches the entry of the
+        // car, so it is safe from a parallel update.
+        void
+        markInputApplied(EntityID entityID);
+
+        // NOTE: 0 if no input with a sequence was applied yet.
+        u32
+        getAppliedInputSequence(const std::string &clientID) const;
+
         void
         resetClientsInput();
 
         CarEntities
         getCarEntities() const;
 
+        const ClientToCarEntity &
+        getClientCarEntities() const;
+
         size_t
         getNumClients() const;
 
@@ -48,6 +71,11 @@ namespace oni {
         std::unique_lock<std::mutex>
         scopedLock();
 
+        // NOTE: Joins, leaves and inputs from here on are recorded, clients already in are recorded as joined.
+        // Pass nullptr to stop.
+        void
+        setRecorder(ReplayRecorder *recorder);
+
 /*            void lock();
 
             void unlock();*/
@@ -56,7 +84,9 @@ namespace oni {
         ClientToCarEntity mClientToCarEntity{};
         CarEntityToClient mCarEntityToClient{};
         CarEntityToInput mCarEntityToInput{};
+        CarEntityToInputSequence mCarEntityToInputSequence{};
         ClientList mClients{};
+        ReplayRecorder *mRecorder{};
 
         std::mutex mMutex{};
         std::unique_lock<std::mutex> mLock{};
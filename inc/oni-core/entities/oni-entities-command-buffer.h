@@ -0,0 +1,213 @@
+#pragma once
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <entt/entity/registry.hpp>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/entities/oni-entities-structure.h>
+
+
+namespace oni {
+    // NOTE: Records structural changes, creating and destroying entities and adding and removing components, so
+    // they can be applied in one pass at a sync point instead of reshuffling the registry in the middle of an
+    // iteration. Commands live in a linear arena made of fixed size blocks, the blocks are kept around after
+    // playback so a buffer that is reused every tick stops allocating once it reached its high-water mark.
+    // A buffer is meant to be filled by a single thread, use EntityManager::acquireCommandBuffer() to get one
+    // buffer per thread and play them back in a fixed order to keep the outcome deterministic.
+    class EntityCommandBuffer {
+    public:
+        struct PendingEntity {
+            u32 index{};
+        };
+
+    public:
+        EntityCommandBuffer();
+
+        ~EntityCommandBuffer();
+
+        EntityCommandBuffer(const EntityCommandBuffer &) = delete;
+
+        EntityCommandBuffer &
+        operator=(const EntityCommandBuffer &) = delete;
+
+        PendingEntity
+        create();
+
+        PendingEntity
+        create(const EntityName &);
+
+        // NOTE: Destroying the same entity more than once is fine, later commands for an entity that is no longer
+        // valid are skipped.
+        void
+        destroy(EntityID);
+
+        // NOTE: The returned reference points into the arena and stays valid until playback, so it is safe to keep
+        // filling in the component after recording it.
+        template<class Component, class... Args>
+        Component &
+        add(EntityID id,
+            Args &&... args) {
+            auto *cmd = push<Command_Add<Component>>(id, false, std::forward<Args>(args)...);
+            return cmd->component;
+        }
+
+        template<class Component, class... Args>
+        Component &
+        add(PendingEntity pending,
+            Args &&... args) {
+            auto *cmd = push<Command_Add<Component>>(pending.index, true, std::forward<Args>(args)...);
+            return cmd->component;
+        }
+
+        template<class Component>
+        void
+        remove(EntityID id) {
+            push<Command_Remove<Component>>(id);
+        }
+
+        // NOTE: For everything else that has to wait for the sync point, such as enqueuing events.
+        template<class Func>
+        void
+        invoke(Func &&func) {
+            push<Command_Invoke<std::decay_t<Func>>>(std::forward<Func>(func));
+        }
+
+        bool
+        empty() const;
+
+        // NOTE: Applies and then clears all the commands in the order they were recorded.
+        void
+        playback(EntityManager &,
+                 const EntityOperationPolicy &);
+
+        void
+        clear();
+
+    private:
+        using Registry = entt::basic_registry<EntityID>;
+
+        struct PlaybackContext {
+            EntityManager &mng;
+            Registry &registry;
+            const EntityOperationPolicy &policy;
+            std::vector<EntityID> &created;
+        };
+
+        struct Command {
+            void (*apply)(Command &,
+                          PlaybackContext &){};
+            void (*dispose)(Command &){};
+            Command *next{};
+        };
+
+        template<class Component>
+        struct Command_Add : public Command {
+            template<class... Args>
+            Command_Add(EntityID id_,
+                        bool pending_,
+                        Args &&... args) : id(id_), pending(pending_),
+                                           component(Component{std::forward<Args>(args)...}) {
+                static_assert(std::is_aggregate_v<Component> || std::is_enum_v<Component>);
+            }
+
+            static void
+            run(Command &base,
+                PlaybackContext &ctx) {
+                auto &cmd = static_cast<Command_Add &>(base);
+                auto id = cmd.pending ? ctx.created[cmd.id] : cmd.id;
+                if (!ctx.registry.valid(id)) {
+                    return;
+                }
+                // NOTE: Same as EntityManager::createComponent(), adding a component twice is a bug
+                if constexpr (std::is_empty_v<Component>) {
+                    ctx.registry.assign<Component>(id);
+                } else {
+                    ctx.registry.assign<Component>(id, std::move(cmd.component));
+                }
+            }
+
+            EntityID id{};
+            bool pending{false};
+            Component component;
+        };
+
+        template<class Component>
+        struct Command_Remove : public Command {
+            explicit Command_Remove(EntityID id_) : id(id_) {}
+
+            static void
+            run(Command &base,
+                PlaybackContext &ctx) {
+                auto &cmd = static_cast<Command_Remove &>(base);
+                if (ctx.registry.valid(cmd.id) && ctx.registry.has<Component>(cmd.id)) {
+                    ctx.registry.remove<Component>(cmd.id);
+                }
+            }
+
+            EntityID id{};
+        };
+
+        template<class Func>
+        struct Command_Invoke : public Command {
+            template<class F>
+            explicit Command_Invoke(F &&f) : func(std::forward<F>(f)) {}
+
+            static void
+            run(Command &base,
+                PlaybackContext &) {
+                static_cast<Command_Invoke &>(base).func();
+            }
+
+            Func func;
+        };
+
+        struct Command_Create;
+        struct Command_Destroy;
+
+        template<class T>
+        static void
+        disposeCommand(Command &base) {
+            static_cast<T &>(base).~T();
+        }
+
+        template<class T, class... Args>
+        T *
+        push(Args &&... args) {
+            auto *memory = allocate(sizeof(T), alignof(T));
+            auto *cmd = new(memory) T(std::forward<Args>(args)...);
+            cmd->apply = &T::run;
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                cmd->dispose = &disposeCommand<T>;
+            }
+            link(cmd);
+            return cmd;
+        }
+
+        void *
+        allocate(size bytes,
+                 size alignment);
+
+        void
+        link(Command *);
+
+    private:
+        struct Block {
+            std::unique_ptr<u8[]> data{};
+            size capacity{};
+        };
+
+        std::vector<Block> mBlocks{};
+        size mBlockIdx{0};
+        size mOffset{0};
+
+        Command *mHead{};
+        Command *mTail{};
+
+        u32 mPendingCount{0};
+        std::vector<EntityID> mCreated{};
+    };
+}
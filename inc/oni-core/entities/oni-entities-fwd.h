@@ -4,10 +4,13 @@
 
 namespace oni {
     class ClientDataManager;
+    class EntityCommandBuffer;
     class EntityFactory;
     class EntityFactory_Client;
     class EntityFactory_Server;
     class EntityManager;
+    class ReplayReader;
+    class ReplayRecorder;
 
     struct BindLifetimeParent;
     struct BindLifetimeChild;
@@ -16,6 +19,10 @@ namespace oni {
     struct EntityContext;
     struct ComponentName;
     struct EntityName;
+    struct EntitySnapshot;
+    struct WorldSnapshot;
+    struct ReplayEvent;
+    struct ReplayTick;
 
     enum class SimMode : u8;
     enum class SnapshotType;
@@ -1,14 +1,21 @@
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <tuple>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 
 #include <entt/entt.hpp>
 
+#include <oni-core/common/oni-common-const.h>
 #include <oni-core/common/oni-common-typedef.h>
 #include <oni-core/component/oni-component-tag.h>
 #include <oni-core/component/oni-component-visual.h>
+#include <oni-core/entities/oni-entities-command-buffer.h>
 #include <oni-core/entities/oni-entities-structure.h>
 #include <oni-core/entities/oni-entities-view.h>
 #include <oni-core/entities/oni-entities-group.h>
@@ -18,6 +25,7 @@
 #include <oni-core/game/oni-game-event-rate-limiter.h>
 #include <oni-core/physics/oni-physics-fwd.h>
 #include <oni-core/entities/oni-entities-structure.h>
+#include <oni-core/util/oni-util-thread-pool.h>
 
 
 namespace oni {
@@ -104,15 +112,38 @@ namespace oni {
         SimMode
         getSimMode();
 
+        // NOTE: Without a pool updateParallel() falls back to the serial update().
+        void
+        setThreadPool(ThreadPool *);
+
     public:
         void
         markForDeletion(EntityID);
 
+        // NOTE: Played back by flushCommands(). Called from updateParallel() it is the buffer of the chunk being
+        // processed, which is queued to be played back by flushCommands() as well.
+        EntityCommandBuffer &
+        getCommandBuffer();
+
+        // NOTE: Thread-safe, buffers are recycled so their arena is reused between frames.
+        std::unique_ptr<EntityCommandBuffer>
+        acquireCommandBuffer();
+
+        void
+        releaseCommandBuffer(std::unique_ptr<EntityCommandBuffer> &&);
+
         void
-        flushDeletions(const EntityOperationPolicy &);
+        playback(EntityCommandBuffer &);
 
         void
-        flushDeletions();
+        playback(EntityCommandBuffer &,
+                 const EntityOperationPolicy &);
+
+        void
+        flushCommands(const EntityOperationPolicy &);
+
+        void
+        flushCommands();
 
         void
         deleteEntity(EntityID);
@@ -269,6 +300,15 @@ namespace oni {
             }
         }
 
+        // NOTE: Components of the given entities only, restore() it as SnapshotType::ONLY_COMPONENTS.
+        template<class Archive, class... ArchiveComponents, class It>
+        void
+        snapshot(Archive &archive,
+                 It first,
+                 It last) {
+            mRegistry->snapshot().template component<ArchiveComponents...>(archive, first, last);
+        }
+
 //        std::unique_lock<std::mutex>
 //        scopedLock() {
 //            return std::unique_lock<std::mutex>(mMutex);
@@ -314,6 +354,14 @@ namespace oni {
         template<class Event, class... Args>
         void
         enqueueEvent(Args &&...args) {
+            if (isDeferring()) {
+                tDeferred.buffer->invoke([this, params = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                    std::apply([this](auto &&... p) {
+                        enqueueEvent<Event>(std::move(p)...);
+                    }, std::move(params));
+                });
+                return;
+            }
             // TODO: Inefficient, as not all the dispatchers are interested in all event types! But it works for now.
             for (auto i = 0; i < NumEventDispatcher; ++i) {
                 auto type = EventDispatcherType(i);
@@ -326,6 +374,10 @@ namespace oni {
         template<class Event>
         void
         enqueueEvent() {
+            if (isDeferring()) {
+                tDeferred.buffer->invoke([this]() { enqueueEvent<Event>(); });
+                return;
+            }
             for (auto i = 0; i < NumEventDispatcher; ++i) {
                 mDispatcher[i]->enqueue<Event>();
             }
@@ -350,6 +402,72 @@ namespace oni {
             }
         }
 
+        // NOTE: Splits the view into chunks and runs them on the thread pool, each chunk with its own context.
+        // f is called concurrently so it must only touch the components passed to it. markForNetSync(),
+        // createComponent(), removeComponent(), assignTag() and enqueueEvent() called from f record into a command
+        // buffer per chunk that is played back once every chunk is done, where update() would apply them right
+        // away. markForDeletion() and getCommandBuffer() record into a second buffer per chunk that waits for
+        // flushCommands(), same as in update(). Buffers are played back in chunk order, so the outcome doesn't
+        // depend on which thread ran what. Creating entities directly and using getRand() from f is not
+        // supported, use getCommandBuffer().create() instead.
+        template<class ...Component, class Func>
+        void
+        updateParallel(Func f,
+                       duration32 d) {
+            if (!mThreadPool) {
+                update<Component...>(std::move(f), d);
+                return;
+            }
+
+            constexpr auto bytesPerEntity = (sizeof(EntityID) + ... + sizeof(Component));
+            constexpr auto chunkSize = std::max(PARALLEL_CHUNK_MIN_ENTITIES, PARALLEL_CHUNK_BYTES / bytesPerEntity);
+
+            auto view = createView<Component...>();
+            // NOTE: Multi-component views can only be walked forward, so take a copy of the matching entities to
+            // be able to hand out random access ranges.
+            auto entities = std::vector<EntityID>(view.begin(), view.end());
+            auto count = entities.size();
+            auto chunkCount = static_cast<u32>((count + chunkSize - 1) / chunkSize);
+            if (chunkCount < 2) {
+                update<Component...>(std::move(f), d);
+                return;
+            }
+
+            auto buffers = std::vector<std::unique_ptr<EntityCommandBuffer>>(chunkCount);
+            auto flushBuffers = std::vector<std::unique_ptr<EntityCommandBuffer>>(chunkCount);
+            for (u32 c = 0; c < chunkCount; ++c) {
+                buffers[c] = acquireCommandBuffer();
+                flushBuffers[c] = acquireCommandBuffer();
+            }
+
+            auto remaining = std::atomic<u32>{chunkCount};
+            for (u32 c = 0; c < chunkCount; ++c) {
+                mThreadPool->submit([&, c]() {
+                    auto previous = tDeferred;
+                    tDeferred = {this, buffers[c].get(), flushBuffers[c].get()};
+
+                    auto context = EntityTickContext{*this, 0, d};
+                    auto end = std::min(count, (c + 1) * chunkSize);
+                    for (auto i = c * chunkSize; i < end; ++i) {
+                        context.id = entities[i];
+                        f(context, view.template get<Component>(context.id)...);
+                    }
+
+                    tDeferred = previous;
+                    --remaining;
+                });
+            }
+            mThreadPool->helpUntil(remaining);
+
+            for (auto &&buffer: buffers) {
+                playback(*buffer);
+                releaseCommandBuffer(std::move(buffer));
+            }
+            for (auto &&buffer: flushBuffers) {
+                queueCommandBuffer(std::move(buffer));
+            }
+        }
+
     public:
         EntityID
         createEntity();
@@ -362,12 +480,19 @@ namespace oni {
         createComponent(EntityID entityID,
                         Args &&... args) {
             static_assert(std::is_aggregate_v<Component> || std::is_enum_v<Component>);
+            if (isDeferring()) {
+                return tDeferred.buffer->add<Component>(entityID, std::forward<Args>(args)...);
+            }
             return mRegistry->assign<Component>(entityID, std::forward<Args>(args)...);
         }
 
         template<class Component>
         void
         removeComponent(EntityID entityID) {
+            if (isDeferring()) {
+                tDeferred.buffer->remove<Component>(entityID);
+                return;
+            }
             mRegistry->remove<Component>(entityID);
         }
 
@@ -388,6 +513,10 @@ namespace oni {
         template<class Tag>
         void
         assignTag(EntityID id) {
+            if (isDeferring()) {
+                tDeferred.buffer->add<Tag>(id);
+                return;
+            }
             mRegistry->assign<Tag>(id);
         }
 
@@ -406,9 +535,28 @@ namespace oni {
         }
 
     private:
+        friend class EntityCommandBuffer;
+
+        struct DeferredTarget {
+            const EntityManager *owner{};
+            // NOTE: Played back at the end of updateParallel()
+            EntityCommandBuffer *buffer{};
+            // NOTE: Played back by flushCommands()
+            EntityCommandBuffer *flushBuffer{};
+        };
+
+        bool
+        isDeferring() const {
+            return tDeferred.owner == this;
+        }
+
         void
         removePhysicalBody(EntityID);
 
+        // NOTE: Played back by flushCommands() after what is already recorded in mCommandBuffer.
+        void
+        queueCommandBuffer(std::unique_ptr<EntityCommandBuffer> &&);
+
         template<class Component, class... Args>
         void
         accommodate(EntityID entityID,
@@ -449,7 +597,15 @@ namespace oni {
         SimMode mSimMode{SimMode::CLIENT};
         EntityOperationPolicy mEntityOperationPolicy{};
 
-        std::unordered_set<EntityID> mEntitiesToDelete{};
+        ThreadPool *mThreadPool{};
+        // NOTE: Set while a chunk of updateParallel() runs on the current thread.
+        inline static thread_local DeferredTarget tDeferred{};
+
+        std::unique_ptr<EntityCommandBuffer> mCommandBuffer{};
+        // NOTE: Recorded before what is in mCommandBuffer, in order.
+        std::vector<std::unique_ptr<EntityCommandBuffer>> mQueuedCommandBuffers{};
+        std::vector<std::unique_ptr<EntityCommandBuffer>> mFreeCommandBuffers{};
+        std::mutex mCommandBufferMutex{};
         std::vector<DeletedEntity> mDeletedEntities{};
         std::unique_ptr<EventRateLimiter> mEventRateLimiter;
     };
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/io/oni-io-input.h>
+
+
+namespace oni {
+    enum class ReplayEventType : u8 {
+        CLIENT_JOINED,
+        CLIENT_LEFT,
+        CLIENT_INPUT,
+
+        LAST
+    };
+
+    struct ReplayEvent {
+        ReplayEventType type{ReplayEventType::CLIENT_INPUT};
+        std::string clientID{};
+        // NOTE: Only for CLIENT_JOINED
+        EntityID carEntity{};
+        // NOTE: Only for CLIENT_INPUT
+        Input input{};
+    };
+
+    struct ReplayTick {
+        r64 dt{0};
+        // NOTE: In the order they happened during the tick
+        std::vector<ReplayEvent> events{};
+    };
+
+    /**
+     * Append-only recording of a server session: the whole registry when recording starts, then per tick the
+     * client joins, leaves and inputs as ClientDataManager saw them, and the dt of the tick. Give it to
+     * ClientDataManager::setRecorder() and call endTick() once the tick is simulated.
+     *
+     * Clients are numbered on first sight and an input equal to the previous one of the same client is a single
+     * bit, so a tick with nothing new costs a few bytes. Each tick is flushed, a crash loses at most the tick in
+     * flight.
+     */
+    class ReplayRecorder {
+    public:
+        ReplayRecorder();
+
+        ~ReplayRecorder();
+
+        // NOTE: Returns false if the file can't be created. randMasterSeed goes in the header, see
+        // getRandMasterSeed().
+        bool
+        open(const std::string &path,
+             u64 randMasterSeed);
+
+        void
+        close();
+
+        bool
+        isOpen() const;
+
+        // NOTE: Has to come first, serialize the registry with SnapshotType::ENTIRE_REGISTRY.
+        void
+        recordWorld(const std::string &registry);
+
+        void
+        recordClientJoined(const std::string &clientID,
+                           EntityID carEntity);
+
+        void
+        recordClientLeft(const std::string &clientID);
+
+        void
+        recordInput(const std::string &clientID,
+                    const Input &input);
+
+        void
+        endTick(r64 dt);
+
+        u64
+        getTickCount() const;
+
+    private:
+        struct PendingEvent {
+            ReplayEventType type{};
+            u32 client{};
+            bool newClient{};
+            EntityID carEntity{};
+        };
+
+        u32
+        clientIndex(const std::string &clientID,
+                    bool &newClient);
+
+        void
+        writeRecord(c8 kind,
+                    const std::string &payload);
+
+    private:
+        std::ofstream mOut{};
+        bool mWorldRecorded{false};
+        u64 mTicks{0};
+
+        std::unordered_map<std::string, u32> mClients{};
+        std::vector<std::string> mClientIDs{};
+        // NOTE: Serialized, indexed by client
+        std::vector<std::string> mLastInput{};
+
+        std::vector<PendingEvent> mEvents{};
+        // NOTE: Serialized, one per CLIENT_INPUT event
+        std::vector<std::string> mPendingInputs{};
+        std::ostringstream mPayload{};
+    };
+
+    // NOTE: Reads back what ReplayRecorder wrote. A truncated last tick, for example from a crash, ends the replay
+    // early instead of failing.
+    class ReplayReader {
+    public:
+        // NOTE: Returns false if the file can't be read or doesn't start with a world record.
+        bool
+        open(const std::string &path);
+
+        // NOTE: Serialized with SnapshotType::ENTIRE_REGISTRY, restore it before the first tick.
+        const std::string &
+        getWorld() const;
+
+        // NOTE: Seed of the recorded session, set it with setRandMasterSeed() before the managers are created.
+        u64
+        getRandMasterSeed() const;
+
+        // NOTE: Returns false once there are no more complete ticks.
+        bool
+        next(ReplayTick &tick);
+
+        u64
+        getTickCount() const;
+
+    private:
+        bool
+        readRecord(c8 &kind,
+                   std::string &payload);
+
+    private:
+        std::ifstream mIn{};
+        std::string mWorld{};
+        std::string mPayload{};
+        u64 mRandMasterSeed{0};
+        u64 mTicks{0};
+
+        std::vector<std::string> mClientIDs{};
+        std::vector<std::string> mLastInput{};
+    };
+}
@@ -216,8 +216,26 @@ namespace oni {
 
     template<class Archive>
     void
-    serialize(Archive &archive,
-              ParticleEmitter &data) {
+    save(Archive &archive,
+         const ParticleEmitter &data) {
+        archive("particle", data.particle);
+        archive("material", data.material);
+        archive("size", data.size);
+        archive("initialVMin", data.initialVMin);
+        archive("initialVMax", data.initialVMax);
+        archive("orientMin", data.orientMin);
+        archive("orientMax", data.orientMax);
+        archive("acc", data.acc);
+        archive("ttlMin", data.ttlMin);
+        archive("ttlMax", data.ttlMax);
+        archive("count", data.count);
+        archive("growth", data.growth);
+    }
+
+    template<class Archive>
+    void
+    load(Archive &archive,
+         ParticleEmitter &data) {
         archive("particle", data.particle);
         archive("material", data.material);
         archive("size", data.size);
@@ -226,8 +244,19 @@ namespace oni {
         archive("orientMin", data.orientMin);
         archive("orientMax", data.orientMax);
         archive("acc", data.acc);
+        archive("ttlMin", data.ttlMin);
+        archive("ttlMax", data.ttlMax);
         archive("count", data.count);
         archive("growth", data.growth);
+
+        // NOTE: Particles die once their age passes the lifetime, a particle with none would never be seen and
+        // 1 / ttl would blow up on spawn.
+        if (data.ttlMin <= 0 || data.ttlMax < data.ttlMin) {
+            assert(false);
+            auto defaults = ParticleEmitter{};
+            data.ttlMin = defaults.ttlMin;
+            data.ttlMax = defaults.ttlMax;
+        }
     }
 
     template<class Archive>
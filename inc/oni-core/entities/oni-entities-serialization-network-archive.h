@@ -0,0 +1,246 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+
+#include <cereal/cereal.hpp>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/util/oni-util-bit-stream.h>
+
+
+namespace oni {
+    // NOTE: Quantized floats are rounded to a multiple of these steps, 0 sends them at full precision. Both ends
+    // have to use the same values.
+    struct NetworkPrecision {
+        r32 position{0.01f};
+        r32 orientation{0.001f};
+    };
+
+    namespace detail {
+        inline u64
+        zigzagEncode(i64 value) {
+            return (static_cast<u64>(value) << 1) ^ static_cast<u64>(value >> 63);
+        }
+
+        inline i64
+        zigzagDecode(u64 value) {
+            return static_cast<i64>(value >> 1) ^ -static_cast<i64>(value & 1);
+        }
+    }
+
+    /**
+     * Bit packed cereal archive for network snapshots, plugs into EntityManager::snapshot() and restore() the same
+     * way cereal::PortableBinaryOutputArchive does.
+     *
+     * bool takes a bit, bytes take 8 bits, other integers, entity ids and container sizes are written with as
+     * many bits as they need plus a short width prefix and signed integers are zigzag encoded first so small
+     * negative values stay small. Floats are written as is unless the serializer asks for quantization, see
+     * archiveQuantized(). Nothing is written until the archive goes out of scope.
+     */
+    class NetworkOutputArchive : public cereal::OutputArchive<NetworkOutputArchive, cereal::AllowEmptyClassElision> {
+    public:
+        explicit NetworkOutputArchive(std::ostream &stream,
+                                      const NetworkPrecision &precision = {});
+
+        ~NetworkOutputArchive() CEREAL_NOEXCEPT;
+
+        void
+        saveBits(u32 value,
+                 u8 bits);
+
+        void
+        saveVarBits(u64 value);
+
+        void
+        saveR32(r32 value);
+
+        void
+        saveR64(r64 value);
+
+        void
+        saveQuantized(r32 value,
+                      r32 step);
+
+        const NetworkPrecision &
+        getPrecision() const;
+
+    private:
+        std::ostream &mStream;
+        NetworkPrecision mPrecision{};
+        BitWriter mWriter{};
+    };
+
+    // NOTE: Reading past the end of the data throws cereal::Exception, same as the cereal binary archives.
+    class NetworkInputArchive : public cereal::InputArchive<NetworkInputArchive, cereal::AllowEmptyClassElision> {
+    public:
+        // NOTE: Reads the data in place, it has to outlive the archive.
+        NetworkInputArchive(const void *data,
+                            size size,
+                            const NetworkPrecision &precision = {});
+
+        // NOTE: Takes everything left in the stream.
+        explicit NetworkInputArchive(std::istream &stream,
+                                     const NetworkPrecision &precision = {});
+
+        u32
+        loadBits(u8 bits);
+
+        u64
+        loadVarBits();
+
+        r32
+        loadR32();
+
+        r64
+        loadR64();
+
+        r32
+        loadQuantized(r32 step);
+
+        size
+        getBitsLeft() const;
+
+        const NetworkPrecision &
+        getPrecision() const;
+
+    private:
+        void
+        check() const;
+
+    private:
+        std::vector<u8> mStorage{};
+        BitReader mReader;
+        NetworkPrecision mPrecision{};
+    };
+
+    // NOTE: Only the network archive quantizes, other archives store the value as is.
+    template<class Archive>
+    void
+    archiveQuantized(Archive &archive,
+                     r32 &value,
+                     r32 NetworkPrecision::*step) {
+        if constexpr (std::is_same_v<Archive, NetworkOutputArchive>) {
+            archive.saveQuantized(value, archive.getPrecision().*step);
+        } else if constexpr (std::is_same_v<Archive, NetworkInputArchive>) {
+            value = archive.loadQuantized(archive.getPrecision().*step);
+        } else {
+            archive(value);
+        }
+    }
+
+    template<class T>
+    inline typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+    CEREAL_SAVE_FUNCTION_NAME(NetworkOutputArchive &archive,
+                              const T &value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            archive.saveBits(value ? 1 : 0, 1);
+        } else if constexpr (std::is_floating_point_v<T>) {
+            static_assert(sizeof(T) == sizeof(r32) || sizeof(T) == sizeof(r64));
+            if constexpr (sizeof(T) == sizeof(r32)) {
+                archive.saveR32(value);
+            } else {
+                archive.saveR64(value);
+            }
+        } else if constexpr (sizeof(T) == 1) {
+            archive.saveBits(static_cast<u8>(value), 8);
+        } else if constexpr (std::is_signed_v<T>) {
+            archive.saveVarBits(detail::zigzagEncode(value));
+        } else {
+            archive.saveVarBits(value);
+        }
+    }
+
+    template<class T>
+    inline typename std::enable_if<std::is_arithmetic<T>::value, void>::type
+    CEREAL_LOAD_FUNCTION_NAME(NetworkInputArchive &archive,
+                              T &value) {
+        if constexpr (std::is_same_v<T, bool>) {
+            value = archive.loadBits(1) != 0;
+        } else if constexpr (std::is_floating_point_v<T>) {
+            static_assert(sizeof(T) == sizeof(r32) || sizeof(T) == sizeof(r64));
+            if constexpr (sizeof(T) == sizeof(r32)) {
+                value = archive.loadR32();
+            } else {
+                value = archive.loadR64();
+            }
+        } else if constexpr (sizeof(T) == 1) {
+            value = static_cast<T>(archive.loadBits(8));
+        } else if constexpr (std::is_signed_v<T>) {
+            value = static_cast<T>(detail::zigzagDecode(archive.loadVarBits()));
+        } else {
+            value = static_cast<T>(archive.loadVarBits());
+        }
+    }
+
+    template<class Archive, class T>
+    inline CEREAL_ARCHIVE_RESTRICT(NetworkInputArchive, NetworkOutputArchive)
+    CEREAL_SERIALIZE_FUNCTION_NAME(Archive &archive,
+                                   cereal::NameValuePair<T> &data) {
+        archive(data.value);
+    }
+
+    template<class T>
+    inline void
+    CEREAL_SAVE_FUNCTION_NAME(NetworkOutputArchive &archive,
+                              const cereal::SizeTag<T> &data) {
+        archive.saveVarBits(data.size);
+    }
+
+    template<class T>
+    inline void
+    CEREAL_LOAD_FUNCTION_NAME(NetworkInputArchive &archive,
+                              cereal::SizeTag<T> &data) {
+        auto value = archive.loadVarBits();
+        // NOTE: Containers are resized before their elements are read, don't let a bad packet allocate gigabytes.
+        if (value > archive.getBitsLeft()) {
+            throw cereal::Exception("Container size larger than the remaining data");
+        }
+        data.size = static_cast<std::remove_reference_t<T>>(value);
+    }
+
+    // NOTE: Strings and vectors of arithmetic types end up here, elements wider than a byte go through the same
+    // packing as single values.
+    template<class T>
+    inline void
+    CEREAL_SAVE_FUNCTION_NAME(NetworkOutputArchive &archive,
+                              const cereal::BinaryData<T> &data) {
+        using Element = std::remove_cv_t<std::remove_pointer_t<T>>;
+        if constexpr (std::is_arithmetic_v<Element> && sizeof(Element) > 1) {
+            const auto *elements = static_cast<const Element *>(data.data);
+            for (size i = 0; i < data.size / sizeof(Element); ++i) {
+                CEREAL_SAVE_FUNCTION_NAME(archive, elements[i]);
+            }
+        } else {
+            const auto *bytes = static_cast<const u8 *>(static_cast<const void *>(data.data));
+            for (size i = 0; i < data.size; ++i) {
+                archive.saveBits(bytes[i], 8);
+            }
+        }
+    }
+
+    template<class T>
+    inline void
+    CEREAL_LOAD_FUNCTION_NAME(NetworkInputArchive &archive,
+                              cereal::BinaryData<T> &data) {
+        using Element = std::remove_cv_t<std::remove_pointer_t<T>>;
+        if constexpr (std::is_arithmetic_v<Element> && sizeof(Element) > 1) {
+            auto *elements = static_cast<Element *>(data.data);
+            for (size i = 0; i < data.size / sizeof(Element); ++i) {
+                CEREAL_LOAD_FUNCTION_NAME(archive, elements[i]);
+            }
+        } else {
+            auto *bytes = static_cast<u8 *>(static_cast<void *>(data.data));
+            for (size i = 0; i < data.size; ++i) {
+                bytes[i] = static_cast<u8>(archive.loadBits(8));
+            }
+        }
+    }
+}
+
+CEREAL_REGISTER_ARCHIVE(oni::NetworkOutputArchive)
+CEREAL_REGISTER_ARCHIVE(oni::NetworkInputArchive)
+
+CEREAL_SETUP_ARCHIVE_TRAITS(oni::NetworkInputArchive, oni::NetworkOutputArchive)
@@ -1,23 +1,72 @@
 #pragma once
 
+#include <type_traits>
+
 #include <oni-core/common/oni-common-typedef.h>
 #include <oni-core/component/oni-component-audio.h>
 #include <oni-core/component/oni-component-geometry.h>
 #include <oni-core/component/oni-component-visual.h>
 #include <oni-core/entities/oni-entities-serialization-hashed-string.h>
+#include <oni-core/entities/oni-entities-serialization-network-archive.h>
 #include <oni-core/entities/oni-entities-structure.h>
 #include <oni-core/game/oni-game-event.h>
 #include <oni-core/network/oni-network-packet.h>
 
 namespace oni {
-    // NOTE: This version is for json where a user defined ENUM of EnumBase sub-type is required
+    // NOTE: The core only knows base types such as EntityName, the values are defined by the game with
+    // ONI_ENUM_DEF_WITH_BASE. Once the definition is registered the network archive sends the id alone and looks
+    // the name back up on receipt, both ends have to register the same definition.
+    template<class ENUM>
+    struct NetworkEnumTable {
+        static inline bool (*find)(i32 id,
+                                   ENUM &out) = nullptr;
+    };
+
+    template<class ENUM, class DEFINITION>
+    void
+    registerNetworkEnum() {
+        for (auto a = DEFINITION::begin(); a != DEFINITION::end(); ++a) {
+            for (auto b = a + 1; b != DEFINITION::end(); ++b) {
+                if (a->id == b->id) {
+                    // NOTE: Duplicate ids can't be told apart, these keep being sent with their names.
+                    assert(false);
+                    return;
+                }
+            }
+        }
+
+        NetworkEnumTable<ENUM>::find = [](i32 id,
+                                          ENUM &out) {
+            for (auto it = DEFINITION::begin(); it != DEFINITION::end(); ++it) {
+                if (it->id == id) {
+                    out.id = it->id;
+                    out.name = it->name;
+                    return true;
+                }
+            }
+            return false;
+        };
+    }
+
     // NOTE: This is for network serialization where we have a specific ENUM with correct id
     template<class Archive, class ENUM>
     void
     loadEnum(Archive &archive,
              ENUM &data) {
-        archive(data.id);
-        loadHashedString(archive, 0, data.name);
+        if constexpr (std::is_same_v<Archive, NetworkInputArchive>) {
+            auto byID = bool{};
+            archive(byID, data.id);
+            if (byID) {
+                auto find = NetworkEnumTable<ENUM>::find;
+                if (!find || !find(data.id, data)) {
+                    throw cereal::Exception("Unknown network enum id");
+                }
+                return;
+            }
+        } else {
+            archive(data.id);
+        }
+        loadHashedString(archive, {}, data.name);
     }
 
     // NOTE: This is for network serialization where we have a specific ENUM with correct id
@@ -25,8 +74,16 @@ namespace oni {
     void
     saveEnum(Archive &archive,
              ENUM &data) {
-        archive(data.id);
-        saveHashedString(archive, 0, data.name);
+        if constexpr (std::is_same_v<Archive, NetworkOutputArchive>) {
+            auto byID = NetworkEnumTable<std::remove_const_t<ENUM>>::find != nullptr;
+            archive(byID, data.id);
+            if (byID) {
+                return;
+            }
+        } else {
+            archive(data.id);
+        }
+        saveHashedString(archive, {}, data.name);
     }
 }
 
@@ -96,9 +153,16 @@ namespace oni {
     void
     serialize(Archive &archive,
               WorldP3D &data) {
-        archive(data.x);
-        archive(data.y);
-        archive(data.z);
+        archiveQuantized(archive, data.x, &NetworkPrecision::position);
+        archiveQuantized(archive, data.y, &NetworkPrecision::position);
+        archiveQuantized(archive, data.z, &NetworkPrecision::position);
+    }
+
+    template<class Archive>
+    void
+    serialize(Archive &archive,
+              Orientation &data) {
+        archiveQuantized(archive, data.value, &NetworkPrecision::orientation);
     }
 
     template<class Archive>
@@ -115,6 +179,27 @@ namespace oni {
         archive(packet.entity);
     }
 
+    template<class Archive>
+    void
+    serialize(Archive &archive,
+              Packet_SnapshotAck &packet) {
+        archive(packet.sequence);
+    }
+
+    template<class Archive>
+    void
+    serialize(Archive &archive,
+              Packet_InputSequence &packet) {
+        archive(packet.sequence);
+    }
+
+    template<class Archive>
+    void
+    serialize(Archive &archive,
+              Packet_InputAck &packet) {
+        archive(packet.sequence);
+    }
+
     template<class Archive>
     void
     serialize(Archive &archive,
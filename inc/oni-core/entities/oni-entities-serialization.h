@@ -1,6 +1,7 @@
 #pragma once
 
 #include <sstream>
+#include <string_view>
 
 #include <cereal/archives/portable_binary.hpp>
 #include <cereal/types/string.hpp>
@@ -10,40 +11,73 @@
 #include <cereal/types/map.hpp>
 
 #include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/entities/oni-entities-serialization-network-archive.h>
+#include <oni-core/util/oni-util-memory-stream.h>
+#include <oni-core/util/oni-util-profiler.h>
 
 namespace oni {
+    // NOTE: The stream versions write straight into the destination, for example OutboundPacket::stream(), the
+    // std::string versions are for when the data has to be kept around. Entity snapshots use the compact
+    // NetworkOutputArchive, construct one directly and pass it to EntityManager::snapshot() for a different
+    // NetworkPrecision.
+    template<class ...Components>
+    void
+    serialize(EntityManager &manager,
+              SnapshotType snapshotType,
+              std::ostream &storage) {
+        ONI_PROFILE_ZONE("serialize(EntityManager)");
+        NetworkOutputArchive output{storage};
+        manager.snapshot<NetworkOutputArchive, Components...>(output, snapshotType);
+    }
+
     template<class ...Components>
     std::string
     serialize(EntityManager &manager,
               SnapshotType snapshotType) {
-        auto storage = std::stringstream{};
-        {
-            cereal::PortableBinaryOutputArchive output{storage};
-            manager.snapshot<cereal::PortableBinaryOutputArchive, Components...>(output, snapshotType);
-        }
+        auto storage = std::ostringstream{};
+        serialize<Components...>(manager, snapshotType, storage);
+        return storage.str();
+    }
 
+    // NOTE: Only the given entities, deserialize() with SnapshotType::ONLY_COMPONENTS creates the ones the
+    // receiver doesn't have yet.
+    template<class ...Components>
+    void
+    serialize(EntityManager &manager,
+              const std::vector<EntityID> &entities,
+              std::ostream &storage) {
+        ONI_PROFILE_ZONE("serialize(EntityManager, entities)");
+        NetworkOutputArchive output{storage};
+        manager.snapshot<NetworkOutputArchive, Components...>(output, entities.begin(), entities.end());
+    }
+
+    template<class ...Components>
+    std::string
+    serialize(EntityManager &manager,
+              const std::vector<EntityID> &entities) {
+        auto storage = std::ostringstream{};
+        serialize<Components...>(manager, entities, storage);
         return storage.str();
     }
 
+    // NOTE: data is read in place, it only has to outlive the call.
     template<class ...Components, class... Type, class... Member>
     void
     deserialize(oni::EntityManager &manager,
-                const std::string &data,
+                std::string_view data,
                 SnapshotType snapshotType,
                 Member Type::*... member) {
-        auto storage = std::stringstream{};
-        storage.str(data);
-        {
-            cereal::PortableBinaryInputArchive input{storage};
-            manager.restore<cereal::PortableBinaryInputArchive, Components...>(snapshotType, input, member...);
-        }
+        ONI_PROFILE_ZONE("deserialize(EntityManager)");
+        NetworkInputArchive input{data.data(), data.size()};
+        manager.restore<NetworkInputArchive, Components...>(snapshotType, input, member...);
     }
 
     template<class T>
     T
-    deserialize(const std::string &data) {
-        std::istringstream storage;
-        storage.str(data);
+    deserialize(const u8 *data,
+                size_t size) {
+        auto buffer = MemoryInputBuffer(data, size);
+        auto storage = std::istream(&buffer);
 
         T result;
         {
@@ -55,29 +89,23 @@ namespace oni {
 
     template<class T>
     T
-    deserialize(const u8 *data,
-                size_t size) {
-        std::istringstream storage;
-        storage.str(std::string(reinterpret_cast<const char *>(data), size));
-
-        T result;
-        {
-            cereal::PortableBinaryInputArchive input{storage};
-            input(result);
-        }
-        return result;
+    deserialize(std::string_view data) {
+        return deserialize<T>(reinterpret_cast<const u8 *>(data.data()), data.size());
     }
 
+    template<class T>
+    void
+    serialize(const T &data,
+              std::ostream &storage) {
+        cereal::PortableBinaryOutputArchive output{storage};
+        output(data);
+    }
 
     template<class T>
     std::string
     serialize(const T &data) {
         std::ostringstream storage;
-        {
-            cereal::PortableBinaryOutputArchive output{storage};
-
-            output(data);
-        }
+        serialize(data, storage);
         return storage.str();
     }
-}
\ No newline at end of file
+}
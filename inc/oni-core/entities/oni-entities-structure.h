@@ -89,6 +89,25 @@ namespace oni {
         // NOTE: Mostly useful for debugging
         EntityContext parent;
     };
+
+    struct EntitySnapshot {
+        EntityID id{};
+        // NOTE: Bit i is set if the i-th component of the captured set is present, the components are stored
+        // back to back in that order.
+        u32 componentMask{};
+        u32 offset{};
+        // NOTE: In bytes, always a multiple of 4.
+        u32 size{};
+    };
+
+    // NOTE: Raw copy of a fixed set of trivially copyable components, sorted by entity id. Unlike cereal
+    // snapshots the layout of an entity only depends on which components it has, so two snapshots of the same
+    // world can be diffed byte for byte.
+    struct WorldSnapshot {
+        u32 sequence{};
+        std::vector<EntitySnapshot> entities{};
+        std::vector<u8> data{};
+    };
 }
 
 DEFINE_STD_HASH_FUNCTIONS(oni::ComponentName)
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+#include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/entities/oni-entities-structure.h>
+#include <oni-core/util/oni-util-profiler.h>
+
+namespace oni {
+    // NOTE: Components are copied byte for byte, padding would go out on the wire with whatever was in memory and
+    // show up as changes in the deltas. Every captured component opts in by specialising this with the sum of the
+    // sizes of all its members, for example:
+    //
+    //     template<>
+    //     struct SnapshotComponent<WorldP3D> {
+    //         static constexpr size memberSize = sizeof(WorldP3D::x) + sizeof(WorldP3D::y) + sizeof(WorldP3D::z);
+    //     };
+    //
+    // Members that are structs themselves have to be free of padding as well.
+    template<class Component>
+    struct SnapshotComponent;
+
+    namespace detail {
+        template<class Component>
+        constexpr bool
+        isWithoutPadding() {
+            return sizeof(Component) == SnapshotComponent<Component>::memberSize;
+        }
+
+        template<class Component>
+        void
+        captureComponent(EntityManager &manager,
+                         EntityID id,
+                         u32 bit,
+                         EntitySnapshot &entity,
+                         std::vector<u8> &data) {
+            if (!manager.has<Component>(id)) {
+                return;
+            }
+            entity.componentMask |= 1u << bit;
+            const auto &component = manager.get<Component>(id);
+            auto offset = data.size();
+            data.resize(offset + sizeof(Component));
+            std::memcpy(data.data() + offset, &component, sizeof(Component));
+        }
+
+        template<class Component>
+        void
+        restoreComponent(EntityManager &manager,
+                         EntityID id,
+                         u32 bit,
+                         const EntitySnapshot &entity,
+                         const u8 *&data) {
+            if (!(entity.componentMask & (1u << bit))) {
+                return;
+            }
+            if (!manager.has<Component>(id)) {
+                manager.createComponent<Component>(id);
+            }
+            std::memcpy(&manager.get<Component>(id), data, sizeof(Component));
+            data += sizeof(Component);
+        }
+
+        template<class... Components, size... Bits>
+        u32
+        entitySize(u32 componentMask,
+                   std::index_sequence<Bits...>) {
+            auto result = u32{0};
+            ((result += (componentMask & (1u << Bits)) ? sizeof(Components) : 0), ...);
+            return (result + 3) & ~u32{3};
+        }
+
+        template<class... Components, size... Bits>
+        void
+        captureEntity(EntityManager &manager,
+                      EntityID id,
+                      EntitySnapshot &entity,
+                      std::vector<u8> &data,
+                      std::index_sequence<Bits...>) {
+            (captureComponent<Components>(manager, id, Bits, entity, data), ...);
+        }
+
+        template<class... Components, size... Bits>
+        void
+        restoreEntity(EntityManager &manager,
+                      EntityID id,
+                      const EntitySnapshot &entity,
+                      const u8 *data,
+                      std::index_sequence<Bits...>) {
+            (restoreComponent<Components>(manager, id, Bits, entity, data), ...);
+        }
+    }
+
+    // NOTE: Captures every entity that has at least one of the Components. Used by the server to build the
+    // snapshots that are delta compressed per client, see Server::sendComponentsDelta().
+    // Components are stored in the byte order and layout of the build, a snapshot is only valid between builds of
+    // the same endianness.
+    template<class... Components>
+    void
+    captureWorld(EntityManager &manager,
+                 WorldSnapshot &snapshot) {
+        static_assert(sizeof...(Components) <= 32);
+        static_assert((std::is_trivially_copyable_v<Components> && ...));
+        static_assert((detail::isWithoutPadding<Components>() && ...), "Padding in a snapshot component");
+        ONI_PROFILE_ZONE("captureWorld");
+
+        auto ids = std::vector<EntityID>{};
+        ([&]() {
+            auto view = manager.createView<Components>();
+            ids.insert(ids.end(), view.begin(), view.end());
+        }(), ...);
+        std::sort(ids.begin(), ids.end());
+        ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+
+        snapshot.entities.clear();
+        snapshot.data.clear();
+        snapshot.entities.reserve(ids.size());
+        for (auto &&id: ids) {
+            auto &entity = snapshot.entities.emplace_back();
+            entity.id = id;
+            entity.offset = static_cast<u32>(snapshot.data.size());
+            detail::captureEntity<Components...>(manager, id, entity, snapshot.data,
+                                                 std::index_sequence_for<Components...>{});
+            // NOTE: Deltas work on 4 byte words
+            snapshot.data.resize((snapshot.data.size() + 3) & ~size{3}, 0);
+            entity.size = static_cast<u32>(snapshot.data.size()) - entity.offset;
+        }
+    }
+
+    // NOTE: Entity ids in the snapshot are server ids, they are mapped to local ids the same way restore() does.
+    // Entities the client doesn't know about yet are skipped, they arrive with their full state through the new
+    // entities snapshot.
+    template<class... Components>
+    void
+    restoreWorld(EntityManager &manager,
+                 const WorldSnapshot &snapshot) {
+        static_assert(sizeof...(Components) <= 32);
+        static_assert((std::is_trivially_copyable_v<Components> && ...));
+        static_assert((detail::isWithoutPadding<Components>() && ...), "Padding in a snapshot component");
+        ONI_PROFILE_ZONE("restoreWorld");
+
+        for (auto &&entity: snapshot.entities) {
+            auto id = manager.map(entity.id);
+            if (id == EntityManager::nullEntity() || !manager.valid(id)) {
+                continue;
+            }
+            // NOTE: Snapshots come off the wire, don't trust the layout
+            if (entity.offset + entity.size > snapshot.data.size() ||
+                entity.size != detail::entitySize<Components...>(entity.componentMask,
+                                                                 std::index_sequence_for<Components...>{})) {
+                assert(false);
+                continue;
+            }
+            detail::restoreEntity<Components...>(manager, id, entity, snapshot.data.data() + entity.offset,
+                                                 std::index_sequence_for<Components...>{});
+        }
+    }
+}
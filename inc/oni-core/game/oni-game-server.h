@@ -0,0 +1,134 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/entities/oni-entities-fwd.h>
+#include <oni-core/util/oni-util-tick-stats.h>
+#include <oni-core/util/oni-util-timer.h>
+
+namespace oni {
+    enum class TickPacing : u8 {
+        // NOTE: sleep_until() the deadline, cheapest but wakes up late by the scheduler's slack.
+        SLEEP,
+        // NOTE: Sleeps until shortly before the deadline and spins the rest, burns part of a core for accuracy.
+        HYBRID_SPIN,
+        // NOTE: clock_nanosleep() on an absolute deadline, falls back to HYBRID_SPIN where not available.
+        ABSOLUTE_DEADLINE,
+    };
+
+    // NOTE: Game loop for dedicated servers, there is no render stage. Ticks are paced against absolute
+    // deadlines so the tick rate doesn't drift, and tick time is reported as percentiles instead of averages.
+    class ServerGame {
+    public:
+        explicit ServerGame(u16 tickRate);
+
+        virtual ~ServerGame();
+
+        ServerGame(const ServerGame &) = delete;
+
+        ServerGame &
+        operator=(const ServerGame &) = delete;
+
+        void
+        run();
+
+        // NOTE: Headless playback of a session recorded with setRecording(), ticks back to back as fast as they
+        // simulate instead of at the tick rate. The master seed of the recording is set before initSystems().
+        // Returns ticks per second, 0 if the replay can't be read.
+        r64
+        runReplay(const std::string &path);
+
+    protected:
+        r32
+        getTickFrequency() const;
+
+        // NOTE: The following have to be set before run().
+        void
+        setPacing(TickPacing);
+
+        // NOTE: How long before the deadline HYBRID_SPIN stops sleeping and starts spinning.
+        void
+        setSpinThreshold(std::chrono::microseconds);
+
+        // NOTE: Pins the thread calling run() to the given core, negative means no pinning.
+        void
+        setSimCore(i32 core);
+
+        // NOTE: Client joins, leaves and inputs are recorded from and replayed into it.
+        void
+        setClientDataManager(ClientDataManager &);
+
+        // NOTE: run() records the session to path, see ReplayRecorder. Needs setClientDataManager() and
+        // _saveWorld().
+        void
+        setRecording(const std::string &path);
+
+        virtual bool
+        shouldTerminate() = 0;
+
+        virtual void
+        initSystems();
+
+        virtual void
+        _poll() = 0;
+
+        virtual void
+        _sim(r64 dt) = 0;
+
+        virtual void
+        _finish() = 0;
+
+        // NOTE: Serialize the registry with SnapshotType::ENTIRE_REGISTRY. Called by run() after initSystems()
+        // when recording, returns false if it can't be serialized and nothing is recorded.
+        virtual bool
+        _saveWorld(std::string &registry);
+
+        // NOTE: Restore the registry _saveWorld() serialized. Called by runReplay() after initSystems(), returns
+        // false if it can't be restored. Client cars that join after recording started are not in it, the
+        // simulation has to create them as it did when recording.
+        virtual bool
+        _restoreWorld(const std::string &registry);
+
+        // NOTE: Called once a second. tickTime is the time spent in poll, sim and finish, wakeLateness is how
+        // far past its deadline each tick started.
+        virtual void
+        showTickStats(const TickStatsSummary &tickTime,
+                      const TickStatsSummary &wakeLateness,
+                      u64 overruns);
+
+    private:
+        void
+        pinToCore();
+
+        void
+        waitUntil(std::chrono::steady_clock::time_point deadline);
+
+        void
+        startRecording();
+
+        void
+        stopRecording();
+
+        void
+        applyReplayTick(const ReplayTick &);
+
+    private:
+        const r32 mTickS{1 / 60.0f};
+
+        TickPacing mPacing{TickPacing::ABSOLUTE_DEADLINE};
+        std::chrono::microseconds mSpinThreshold{200};
+        i32 mSimCore{-1};
+
+        TickStats mTickTime;
+        TickStats mWakeLateness;
+        u64 mOverruns{0};
+        Timer mReportTimer{};
+
+        ClientDataManager *mClientDataMng{};
+        std::string mRecordingPath{};
+        std::unique_ptr<ReplayRecorder> mRecorder{};
+    };
+}
@@ -1,9 +1,23 @@
 #pragma once
 
+#include <atomic>
+#include <thread>
+
 #include <oni-core/common/oni-common-typedef.h>
 #include <oni-core/util/oni-util-timer.h>
 
 namespace oni {
+    enum class GameLoopMode : u8 {
+        // NOTE: One poll, sim and render per frame, sleeps off what is left of the tick.
+        LOCKSTEP,
+        // NOTE: Sim steps at the tick rate driven by an accumulator, as many as needed to catch up but no more
+        // than the catch-up cap. Render runs once per frame, in between sim steps, and interpolates.
+        FIXED_STEP,
+        // NOTE: Same as FIXED_STEP but render and display run on their own thread. The render thread may only
+        // read what _publish() handed over.
+        FIXED_STEP_RENDER_THREAD,
+    };
+
     class Game {
     public:
         Game();
@@ -19,6 +33,21 @@ namespace oni {
         r32
         getTickFrequency();
 
+        // NOTE: Has to be set before run().
+        void
+        setLoopMode(GameLoopMode);
+
+        void
+        setMaxSimStepsPerFrame(u8);
+
+        // NOTE: How far into the next sim tick the frame being rendered is, in [0, 1]. Valid in _render().
+        r32
+        getRenderAlpha() const;
+
+        // NOTE: Sim time that was thrown away because the catch-up cap was hit.
+        r64
+        getDroppedSimTime() const;
+
         virtual bool
         shouldTerminate() = 0;
 
@@ -43,6 +72,24 @@ namespace oni {
         virtual void
         _finish() = 0;
 
+        // NOTE: Called on the sim thread after the last sim step of a frame, hand the render state over here,
+        // see SnapshotBuffer. Only used by the FIXED_STEP modes.
+        virtual void
+        _publish();
+
+        // NOTE: Called on the sim thread right before the last sim step of a frame, record the state _publish()
+        // interpolates from here, see SceneManager::capturePrevious(). Has to be overridden for the FIXED_STEP
+        // modes.
+        virtual void
+        _capturePrevious();
+
+        // NOTE: Called on the render thread before its first and after its last frame.
+        virtual void
+        _attachRenderContext();
+
+        virtual void
+        _detachRenderContext();
+
         virtual void
         showFPS(i16);
 
@@ -62,6 +109,21 @@ namespace oni {
         showPT(i16);
 
     private:
+        void
+        runLockstep();
+
+        void
+        runFixedStep();
+
+        void
+        runFixedStepRenderThread();
+
+        void
+        renderLoop();
+
+        u8
+        stepSim(r64 &accumulator);
+
         void
         sim();
 
@@ -81,6 +143,16 @@ namespace oni {
         // 60Hz
         const r32 mTickS{1 / 60.0f};
 
+        GameLoopMode mLoopMode{GameLoopMode::LOCKSTEP};
+        u8 mMaxSimStepsPerFrame{5};
+        r32 mRenderAlpha{1.f};
+        r64 mDroppedSimTime{0.0};
+
+        std::thread mRenderThread{};
+        std::atomic<bool> mRenderThreadRunning{false};
+        // NOTE: steady_clock time of the last _publish() in nanoseconds, the render thread derives its alpha from it.
+        std::atomic<i64> mLastPublishNS{0};
+
     protected:
         Timer mSimTimer{};
         Timer mSimLoopTimer{};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/common/oni-common-typedefs-graphic.h>
+
+namespace oni {
+    struct StreamBufferStats {
+        u32 batches{0};
+        // NOTE: Regions that had to be waited on before being written to again
+        u32 fenceWaits{0};
+        // NOTE: Fence waits where the GPU was still using the region
+        u32 stalls{0};
+        u64 stallNs{0};
+    };
+
+    /**
+     * Vertex buffer that stays mapped for its whole lifetime, created with glBufferStorage and the persistent and
+     * coherent map bits. It is a ring of regions, each as big as the largest batch. Batches are written back to
+     * back at increasing offsets, so one region can hold many small batches, and the draw of a batch starts at
+     * the vertex returned by end().
+     *
+     * A region is fenced once all the draws that read it are issued and the fence is waited on before the region
+     * is written to again. Nothing else synchronizes with the GPU, unlike mapping the buffer for every batch.
+     */
+    class StreamBuffer {
+    public:
+        static constexpr u8 DefaultRegionCount = 3;
+
+        StreamBuffer(oniGLsizeiptr regionSize,
+                     oniGLsizei vertexSize,
+                     u8 regionCount = DefaultRegionCount);
+
+        ~StreamBuffer();
+
+        StreamBuffer &
+        operator=(const StreamBuffer &) = delete;
+
+        StreamBuffer(const StreamBuffer &) = delete;
+
+        // NOTE: Needs glBufferStorage and glDrawElementsBaseVertex, queried from the current context.
+        static bool
+        isSupported();
+
+        // NOTE: Returns room for regionSize bytes. Regions written to by the previous batches must have had
+        // their draws issued.
+        void *
+        begin();
+
+        // NOTE: head is one past the last byte written since begin(), returns the first vertex of the batch.
+        oniGLint
+        end(const void *head);
+
+        void
+        bind();
+
+        void
+        unbind();
+
+        const StreamBufferStats &
+        getStats() const;
+
+        void
+        resetStats();
+
+    private:
+        void
+        acquire(u8 region);
+
+        void
+        release(u8 region);
+
+    private:
+        oniGLuint mBufferID{0};
+        u8 *mData{nullptr};
+
+        oniGLsizeiptr mRegionSize{0};
+        oniGLsizei mVertexSize{0};
+        u8 mRegionCount{0};
+
+        std::vector<oniGLsync> mFences{};
+        std::vector<bool> mHeld{};
+
+        oniGLsizeiptr mHead{0};
+        oniGLsizeiptr mBatchBegin{0};
+
+        StreamBufferStats mStats{};
+    };
+}
@@ -7,9 +7,11 @@
 
 namespace oni {
     class Buffer;
+    class StreamBuffer;
 
     class VertexArray {
     public:
+        // NOTE: Backed by a StreamBuffer when the context supports it, maxBufferSize is then the size of a region.
         VertexArray(
                 const std::vector<BufferStructure> &,
                 oniGLsizei maxBufferSize);
@@ -28,9 +30,14 @@ namespace oni {
         void
         unbindVBO() const;
 
+        // NOTE: nullptr when the vertex buffer has to be mapped for every batch
+        StreamBuffer *
+        getStreamBuffer() const;
+
     private:
         oniGLuint mArrayID{0};
         std::unique_ptr<Buffer> mVertexBuffers;
+        std::unique_ptr<StreamBuffer> mStreamBuffer;
         std::vector<BufferStructure> mBufferStructure;
         oniGLsizei mMaxBufferSize{0};
     };
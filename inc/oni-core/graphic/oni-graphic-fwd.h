@@ -3,6 +3,8 @@
 namespace oni {
     class DebugDrawBox2D;
     class FontManager;
+    class ParticleManager;
+    class ParticlePool;
     class Renderer;
     class Renderer_OpenGL_Quad;
     class Renderer_OpenGL_Strip;
@@ -10,8 +12,11 @@ namespace oni {
     class SceneManager;
     class System_GrowOverTime;
     class System_MaterialTransition;
+    class System_ParticleEmitter;
     class TextureManager;
     class Window;
 
     struct Brush;
+    struct RenderSnapshot;
+    struct RenderSnapshotEntry;
 }
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/component/oni-component-visual.h>
+#include <oni-core/graphic/oni-graphic-fwd.h>
+#include <oni-core/math/oni-math-fwd.h>
+#include <oni-core/util/oni-util-aligned-allocator.h>
+
+
+namespace oni {
+    /**
+     * Particles of one emitter as a structure of arrays, no entities involved. Arrays are padded to
+     * NumParticleLanes so update() runs whole AVX2 blocks. Dead particles are swap-removed, so the order changes.
+     *
+     * Motion follows System_PositionAndVelocity, growth is GrowOverTime spread over its period instead of in
+     * steps, and the alpha fades linearly over the lifetime.
+     */
+    class ParticlePool {
+    public:
+        static constexpr u8 NumParticleLanes = 8;
+
+        explicit ParticlePool(const ParticleEmitter &);
+
+        void
+        spawn(const ParticleEmitter &,
+              const WorldP3D &,
+              u32 count,
+              Rand &);
+
+        // NOTE: Ages and moves every particle, then removes the ones past their time to live.
+        void
+        update(r32 dt);
+
+        void
+        clear();
+
+        u32
+        getCount() const;
+
+        Material_Definition &
+        getMaterial();
+
+        const Material_Definition &
+        getMaterial() const;
+
+        const r32 *
+        getX() const;
+
+        const r32 *
+        getY() const;
+
+        const r32 *
+        getZ() const;
+
+        const r32 *
+        getOrientation() const;
+
+        const r32 *
+        getSize() const;
+
+        // NOTE: 1 at spawn down to 0 at the end of the time to live
+        const r32 *
+        getAlpha() const;
+
+    private:
+        void
+        reserve(u32 count);
+
+        void
+        compact();
+
+    private:
+        using Array = std::vector<r32, AlignedAllocator<r32, 32>>;
+
+        Array mX{};
+        Array mY{};
+        Array mZ{};
+        Array mDirX{};
+        Array mDirY{};
+        Array mSpeed{};
+        Array mOrientation{};
+        Array mSize{};
+        Array mAge{};
+        Array mInvMaxAge{};
+        Array mAlpha{};
+        u32 mCount{0};
+
+        Material_Definition mMaterial{};
+        r32 mAcc{0};
+        r32 mGrowthRate{0};
+        r32 mMaxSize{0};
+    };
+
+    /**
+     * Owns a ParticlePool per emitter entity. System_ParticleEmitter spawns into it and SceneManager streams it to
+     * the renderer.
+     */
+    class ParticleManager {
+    public:
+        explicit ParticleManager(TextureManager &);
+
+        void
+        spawn(EntityID emitter,
+              const ParticleEmitter &,
+              const WorldP3D &,
+              Rand &);
+
+        // NOTE: Pools of emitters that didn't spawn since the last update are dropped once they run empty.
+        void
+        update(r32 dt);
+
+        void
+        clear();
+
+        size
+        getParticleCount() const;
+
+        template<class Func>
+        void
+        forEachPool(Func &&func) const {
+            for (auto &&pool: mPools) {
+                func(pool.second.pool);
+            }
+        }
+
+    private:
+        struct Entry {
+            ParticlePool pool;
+            bool spawned{true};
+        };
+
+        TextureManager &mTextureManager;
+        std::unordered_map<EntityID, Entry> mPools{};
+    };
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/graphic/oni-graphic-renderer.h>
+
+
+namespace oni {
+    /**
+     * Renderables of a frame ordered by a 64-bit key, from the most to the least significant bits:
+     *
+     *   finish (2) | z-bucket (14) | texture (16) | entity id (32)
+     *
+     * z is clamped to [0, 1] and bucketed finer than ZLayerManager's minor layer delta, so distinct layers keep
+     * their back to front order. Within a bucket the texture keeps draws that share a sampler together and the
+     * entity id keeps the order stable between frames.
+     *
+     * sort() is an LSD radix sort, linear in the number of renderables, over buffers that are kept between frames.
+     */
+    class RenderQueue {
+    public:
+        static constexpr u8 FinishBits = 2;
+        static constexpr u8 ZBits = 14;
+        static constexpr u8 TextureBits = 16;
+        static constexpr u8 IDBits = 32;
+
+        static u64
+        makeKey(u8 finish,
+                r32 z,
+                u32 texture,
+                EntityID id);
+
+        static u8
+        getFinish(u64 key);
+
+        // NOTE: The finish is explicit as text has no Material_Definition.
+        void
+        push(const Material_Finish &,
+             const Renderable &);
+
+        void
+        sort();
+
+        // NOTE: Drops the renderables but keeps the memory for the next frame.
+        void
+        clear();
+
+        size
+        getCount() const;
+
+        // NOTE: In key order once sorted, in push order before that.
+        const Renderable &
+        get(size index) const;
+
+        u64
+        getKey(size index) const;
+
+    private:
+        struct Entry {
+            u64 key{};
+            u32 index{};
+        };
+
+        std::vector<Renderable> mRenderables{};
+        std::vector<Entry> mEntries{};
+        std::vector<Entry> mScratch{};
+    };
+}
@@ -17,6 +17,11 @@ namespace oni {
         void
         submit(const Renderable &) override;
 
+        // NOTE: Streams particles starting at first straight into the vertex buffer, returns how many fit.
+        u32
+        submit(const ParticlePool &,
+               u32 first);
+
     protected:
         oniGLsizei
         getIndexCount() override;
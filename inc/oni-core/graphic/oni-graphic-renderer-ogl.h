@@ -7,6 +7,7 @@
 #include <oni-core/graphic/buffer/oni-graphic-frame-buffer.h>
 #include <oni-core/graphic/buffer/oni-graphic-buffer.h>
 #include <oni-core/graphic/buffer/oni-graphic-index-buffer.h>
+#include <oni-core/graphic/buffer/oni-graphic-stream-buffer.h>
 #include <oni-core/graphic/buffer/oni-graphic-vertex-array.h>
 #include <oni-core/graphic/oni-graphic-renderer.h>
 
@@ -21,6 +22,13 @@ namespace oni {
 
         ~Renderer_OpenGL() override;
 
+        // NOTE: All zero when the vertex buffer isn't streamed.
+        StreamBufferStats
+        getStreamStats() const;
+
+        void
+        resetStreamStats();
+
     protected:
         void
         _begin(const RenderSpec &spec,
@@ -46,12 +54,12 @@ namespace oni {
         virtual void
         disableShader();
 
-        // TODO: checkout texture arrays.
         /**
-         * There are 0, 1, ..., mMaxNumTextureSamplers texture samplers available.
+         * There are 0, 1, ..., mMaxNumTextureSamplers - 1 texture samplers available.
          * Each texture is assigned one and the id to the sampler is saved as part of vertex data
          * in the vertex buffer. During rendering in the shader the proper sampler is selected based
-         * on the sampler id in the buffer.
+         * on the sampler id in the buffer. TextureManager packs the images into atlases so a batch needs
+         * one sampler per atlas, not per image.
          */
         oniGLint
         getSamplerID(oniGLuint textureID);
@@ -98,9 +106,14 @@ namespace oni {
 
     protected:
         void *mBuffer{nullptr};
+        // NOTE: Where the batch starts in the vertex buffer, the stream buffer writes batches back to back
+        oniGLint mFirstVertex{0};
+
+        // NOTE: Size of the sampler arrays in the shaders
+        static constexpr oniGLint MaxNumShaderSamplers{32};
 
-        // TODO: Arbitrary number, query the graphics card for it
-        oniGLint mMaxNumTextureSamplers{32};
+        // NOTE: Limited by the texture units of the fragment stage as well
+        oniGLint mMaxNumTextureSamplers{MaxNumShaderSamplers};
 
         std::unique_ptr<Shader> mShader{};
         std::unique_ptr<VertexArray> mVertexArray{nullptr};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <oni-core/common/oni-common-typedef.h>
 #include <oni-core/component/oni-component-visual.h>
 #include <oni-core/component/oni-component-fwd.h>
@@ -43,6 +45,26 @@ namespace oni {
         const MaterialTransition_Def *trans{};
     };
 
+    // NOTE: Copy of what a Renderable points to, taken on the sim thread so the render thread never reads the
+    // registry. Transforms are in world space with the parent transforms already applied.
+    struct RenderSnapshotEntry {
+        EntityID id{};
+
+        WorldP3D pos{};
+        WorldP3D prevPos{};
+        Orientation ornt{};
+        Orientation prevOrnt{};
+        Scale scale{};
+
+        Material_Definition materialDef{};
+        MaterialTransition_Def trans{};
+        bool hasTrans{false};
+    };
+
+    struct RenderSnapshot {
+        std::vector<RenderSnapshotEntry> entries{};
+    };
+
     struct RenderSpec {
         mat4 model{};
         mat4 view{};
@@ -1,19 +1,23 @@
 #pragma once
 
 #include <map>
-#include <queue>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include <oni-core/asset/oni-asset-fwd.h>
 #include <oni-core/component/oni-component-fwd.h>
 #include <oni-core/component/oni-component-visual.h>
 #include <oni-core/entities/oni-entities-fwd.h>
+#include <oni-core/graphic/buffer/oni-graphic-stream-buffer.h>
 #include <oni-core/graphic/oni-graphic-camera.h>
+#include <oni-core/graphic/oni-graphic-render-queue.h>
 #include <oni-core/graphic/oni-graphic-renderer.h>
 #include <oni-core/graphic/oni-graphic-fwd.h>
 #include <oni-core/math/oni-math-mat4.h>
 #include <oni-core/math/oni-math-fwd.h>
 #include <oni-core/math/oni-math-function.h>
+#include <oni-core/math/oni-math-spatial-grid.h>
 
 class b2World;
 
@@ -28,9 +32,34 @@ namespace oni {
 
         ~SceneManager();
 
+        // NOTE: Only entities in view are queued, the grid that finds them is kept across calls so submit a single
+        // EntityManager per frame.
         void
         submit(EntityManager &);
 
+        // NOTE: Records the transforms the next capture() interpolates from. Call it right before the last sim step
+        // that goes into the capture, see Game::_capturePrevious(), so the two are one sim step apart.
+        void
+        capturePrevious(EntityManager &);
+
+        // NOTE: Copies everything submit() would queue, except text, into the snapshot. Previous transforms come
+        // from the last capturePrevious(), entities that didn't exist then start from their current transform.
+        void
+        capture(EntityManager &,
+                RenderSnapshot &);
+
+        // NOTE: alpha blends from the previous to the latest captured transforms, the snapshot must outlive the
+        // following render() call.
+        void
+        submit(const RenderSnapshot &,
+               r32 alpha);
+
+        // NOTE: Particle pools are streamed to the renderer by the next render(), after the entities of the same
+        // finish. The manager must not change until then, RenderSnapshot doesn't carry particles yet so this isn't
+        // safe with a render thread.
+        void
+        submit(const ParticleManager &);
+
         void
         render();
 
@@ -85,12 +114,17 @@ namespace oni {
         u16
         getSpritesPerFrame() const;
 
-        u16
+        u32
         getParticlesPerFrame() const;
 
         u16
         getTexturesPerFrame() const;
 
+        // NOTE: Summed over the renderers, stalls are the times the CPU waited for the GPU to free a vertex
+        // buffer region. Empty without persistent mapping support.
+        StreamBufferStats
+        getStreamStatsPerFrame() const;
+
         const ScreenBounds &
         getScreenBounds() const;
 
@@ -122,6 +156,8 @@ namespace oni {
             Orientation ornt;
         };
 
+        // NOTE: The pose System_WorldTransform resolved for attached entities, walks up the parents only for the
+        // ones attached since its last tick.
         // TODO: Move somewhere else
         static SceneManager::WorldP3DAndOrientation
         applyParentTransforms(const EntityContext &context,
@@ -130,6 +166,9 @@ namespace oni {
 
 
     private:
+        void
+        renderParticles(const RenderSpec &);
+
         void
         renderStrip(EntityManager &,
                     r32 viewWidth,
@@ -185,11 +224,18 @@ namespace oni {
 
         u16 mRenderedSpritesPerFrame{0};
         u16 mRenderedTexturesPerFrame{0};
-        u16 mRenderedParticlesPerFrame{0};
+        u32 mRenderedParticlesPerFrame{0};
 
         ZLayerManager &mZLayerManager;
 
-        using RenderableQueue = std::priority_queue<Renderable>;
-        std::array<RenderableQueue, Material_Finish::size()> mRenderables{};
+        RenderQueue mRenderQueue{};
+        // NOTE: Half the view width at zoom 1, most sprites fit in half a cell
+        SpatialGrid mRenderGrid{8.f};
+        const ParticleManager *mParticles{};
+
+        // NOTE: Transforms recorded by capturePrevious(), used as the previous state by the next capture().
+        std::unordered_map<EntityID, WorldP3DAndOrientation> mPreviousTransforms{};
+        // NOTE: Interpolated transforms the queued Renderables point to.
+        std::vector<WorldP3DAndOrientation> mInterpolatedTransforms{};
     };
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <vector>
+
 #include <oni-core/system/oni-system.h>
 #include <oni-core/component/oni-component-visual.h>
 #include <oni-core/component/oni-component-geometry.h>
@@ -54,27 +56,27 @@ namespace oni {
     };
 
     class System_ParticleEmitter : public SystemTemplate<
-            ParticleEmitter,
-            WorldP3D> {
+            const ParticleEmitter,
+            const WorldP3D> {
     public:
-        System_ParticleEmitter(EntityManager &tickEm,
-                               EntityManager &storageEm,
-                               SceneManager &,
-                               EntityFactory &);
+        // NOTE: Particles are spawned into the ParticleManager, not as entities, and the pools are advanced in
+        // postUpdate().
+        System_ParticleEmitter(EntityManager &,
+                               ParticleManager &,
+                               SceneManager &);
 
     protected:
         void
         update(EntityTickContext &context,
-               ParticleEmitter &,
-               WorldP3D &) override;
+               const ParticleEmitter &,
+               const WorldP3D &) override;
 
         void
         postUpdate(EntityManager &mng,
                    duration32 dt) override;
 
     private:
-        EntityManager &mEntityManager;
+        ParticleManager &mParticleManager;
         SceneManager &mSceneManager;
-        EntityFactory &mEntityFactory;
     };
 }
\ No newline at end of file
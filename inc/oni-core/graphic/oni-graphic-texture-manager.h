@@ -51,6 +51,24 @@ namespace oni {
                               std::vector<u8> &storageImage,
                               const vec3 &brushTexturePos);
 
+        /**
+         * CPU half of blendAndUpdateTexture(), blends the brush into storageTexture and copies the touched
+         * region of the texture into subImage. Doesn't touch the GPU.
+         *
+         * @return false if the brush doesn't overlap the texture, region is left untouched in that case
+         */
+        static bool
+        blend(const Image &textureImage,
+              const Image &brush,
+              std::vector<u8> &storageTexture,
+              const std::vector<u8> &storageImage,
+              const vec3 &brushTexturePos,
+              std::vector<u8> &subImage,
+              oniGLint &xOffset,
+              oniGLint &yOffset,
+              oniGLint &subImageWidth,
+              oniGLint &subImageHeight);
+
         void
         initTexture(Texture &);
 
@@ -68,6 +86,7 @@ namespace oni {
         static oniGLuint
         load(const FontManager &fontManager);
 
+        // NOTE: Images are packed into atlases, Texture::uv of each is the region it occupies.
         void
         cacheAllAssets();
 
@@ -91,6 +110,22 @@ namespace oni {
         void
         _cacheTexture(const ImageName &);
 
+        void
+        _cacheAtlases();
+
+        struct AtlasSlot {
+            const Image *image{};
+            // NOTE: Corner of the image in the atlas, the gutter is around it
+            u32 x{};
+            u32 y{};
+        };
+
+        // NOTE: width is a power of two, usedHeight is rounded up to one.
+        void
+        _initAtlas(const std::vector<AtlasSlot> &,
+                   u32 width,
+                   u32 usedHeight);
+
         void
         _initTexture(Texture &);
 
@@ -102,7 +137,9 @@ namespace oni {
         std::unordered_map<Hash, Image> mImageMap{};
         std::unordered_map<Hash, std::vector<u8>> mImageDataMap{};
 
-        const u8 mElementsInRGBA{4};
+        static constexpr u8 mElementsInRGBA{4};
+        // NOTE: Upper bound of the atlas width and height, GL_MAX_TEXTURE_SIZE might lower it
+        static constexpr u32 mMaxAtlasSize{4096};
         oni::AssetFilesIndex &mAssetManager;
 
         std::vector<std::vector<UV>> mAnimationUVs{};
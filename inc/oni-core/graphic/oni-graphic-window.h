@@ -30,6 +30,14 @@ namespace oni {
         void
         display();
 
+        // NOTE: The GL context can only be current on one thread at a time, detach it from the thread that
+        // created the window before attaching it to the render thread.
+        void
+        attachContext();
+
+        void
+        detachContext();
+
         bool
         closed() const;
 
@@ -1,3 +1,7 @@
+#pragma once
+
+#include <cassert>
+
 #include <oni-core/common/oni-common-typedef.h>
 
 // TODO: drop this and remove the template function that uses it
@@ -5,27 +9,79 @@
 
 
 namespace oni {
+    // NOTE: Independent streams handed out by makeRandStream(), one per system so the order systems are created
+    // in, or how much one of them draws, doesn't change what the others get.
+    enum class RandStream : u8 {
+        ENTITIES,
+        PHYSICS,
+        SCENE,
+
+        LAST
+    };
+
     class Rand {
     public:
+        static constexpr u8 NumRandLanes = 8;
+
+        // NOTE: Zero for either seed seeds from std::random_device.
         Rand(u64 seed_a,
              u64 seed_b);
 
+        // NOTE: Zero seeds from std::random_device, otherwise the whole state is expanded from the seed.
+        explicit Rand(u64 seed);
+
+        // NOTE: Advances the generator by 2^64 draws, the streams before and after a jump never overlap in
+        // practice.
+        void
+        jump();
+
+        // NOTE: Returns a generator at the current state and jumps this one past it.
+        Rand
+        split();
+
         template<class T>
         T
         next(T lowerBoundInclusive,
              T upperBoundExclusive) {
             static_assert(std::is_integral_v<T> && std::is_unsigned_v<T>);
             assert(upperBoundExclusive > lowerBoundInclusive);
-            auto n = next_u64();
             auto d = upperBoundExclusive - lowerBoundInclusive;
-            // TODO: To avoid modulo operator see: https://arxiv.org/pdf/1805.10941.pdf
-            // I think it will be: auto result = lowerBoundInclusive + ((n * d) >> 64); 
-            // Although I would need a 128 bit uint to hold the intermediate results. 
-            // Example: https://github.com/colmmacc/s2n/blob/7ad9240c8b9ade0cc3a403a732ba9f1289934abd/utils/s2n_random.c#L483
-            auto result = lowerBoundInclusive + (n % d);
-            return result;
+            if constexpr (sizeof(T) <= sizeof(u32)) {
+                return lowerBoundInclusive + static_cast<T>(next_bounded_u32(d));
+            } else {
+                return lowerBoundInclusive + static_cast<T>(next_bounded_u64(d));
+            }
         }
 
+        // NOTE: Uniform in [0, range) without modulo, see https://arxiv.org/pdf/1805.10941.pdf
+        u32
+        next_bounded_u32(u32 range);
+
+        u64
+        next_bounded_u64(u64 range);
+
+        // NOTE: Batch versions for filling thousands of values in one go, for example particle spawning. They draw
+        // from NumRandLanes interleaved xoshiro128+ streams, with AVX2 where the CPU has it, and give the same
+        // values with or without it. The lanes are seeded from a hash of this generator's state on first use, apart
+        // from every stream makeRandStream() and split() hand out.
+        void
+        fill_u32(u32 *out,
+                 size count,
+                 u32 lowerBoundInclusive,
+                 u32 upperBoundExclusive);
+
+        void
+        fill_r32(r32 *out,
+                 size count,
+                 r32 lowerBoundInclusive,
+                 r32 upperBoundExclusive);
+
+        void
+        fill_norm(r32 *out,
+                  size count,
+                  r32 mean,
+                  r32 stddev);
+
         u32
         next_u32();
 
@@ -69,6 +125,20 @@ namespace oni {
         rotl_64(u64 x,
                 u32 k);
 
+        void
+        seedFrom(u64 seed);
+
+        void
+        seedFromDevice();
+
+        void
+        seedLanes();
+
+        // NOTE: count raw values, a multiple of NumRandLanes.
+        void
+        nextLanes(u32 *out,
+                  size count);
+
     private:
         union _r32 {
             u32 _int{};
@@ -82,10 +152,26 @@ namespace oni {
 
     private:
         u64 mSeed_u64[2]{};
-        u64 mSeed_u32[4]{};
+        u32 mSeed_u32[4]{};
         r64 mZ1_r64{0};
         r32 mZ1_r32{0};
         bool mGenerate_r32{false};
         bool mGenerate_r64{false};
+
+        // NOTE: Lane state, structure of arrays: mLanes[word][lane]
+        alignas(32) u32 mLanes[4][NumRandLanes]{};
+        bool mLanesSeeded{false};
     };
+
+    // NOTE: Deterministic mode. With a non-zero master seed every makeRandStream() of the same stream starts
+    // from the same state, on every run and on both client and server. Set it before the EntityManager, Physics
+    // and SceneManager are created. Zero, the default, keeps seeding from std::random_device.
+    void
+    setRandMasterSeed(u64 seed);
+
+    u64
+    getRandMasterSeed();
+
+    Rand
+    makeRandStream(RandStream);
 }
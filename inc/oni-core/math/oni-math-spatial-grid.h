@@ -0,0 +1,155 @@
+#pragma once
+
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+
+
+namespace oni {
+    /**
+     * Loose uniform grid of entities, each a point with a radius. An entity lives only in the cell of its center
+     * and queries reach half a cell further out, so anything with a radius up to half a cell is found without
+     * being added to more than one cell. Bigger entities are kept aside and tested by every query.
+     *
+     * update() only touches the cells when an entity moves to another cell. Entities that weren't updated since
+     * the previous removeStale() are dropped by it, so the owner can feed every entity once per frame without
+     * tracking destruction, and pays for the sweep only in frames where something disappeared. Feeding them in
+     * the same order as the previous frame, as iterating a view does, skips the hash lookup of the entity.
+     */
+    class SpatialGrid {
+    public:
+        explicit SpatialGrid(r32 cellSize);
+
+        // NOTE: Inserts or moves the entity.
+        void
+        update(EntityID,
+               r32 x,
+               r32 y,
+               r32 radius);
+
+        void
+        remove(EntityID);
+
+        void
+        removeStale();
+
+        void
+        clear();
+
+        size
+        getCount() const;
+
+        r32
+        getCellSize() const;
+
+        // NOTE: Calls func(EntityID) for each entity whose bounding square overlaps the rectangle, in no
+        // particular order.
+        template<class Func>
+        void
+        query(r32 minX,
+              r32 minY,
+              r32 maxX,
+              r32 maxY,
+              Func &&func) const {
+            auto visit = [&](const std::vector<Entry> &entries) {
+                for (auto &&entry: entries) {
+                    if (entry.x + entry.radius >= minX && entry.x - entry.radius <= maxX &&
+                        entry.y + entry.radius >= minY && entry.y - entry.radius <= maxY) {
+                        func(entry.id);
+                    }
+                }
+            };
+
+            visit(mLarge);
+
+            auto loose = mCellSize * 0.5f;
+            auto cellMinX = toCell(minX - loose);
+            auto cellMaxX = toCell(maxX + loose);
+            auto cellMinY = toCell(minY - loose);
+            auto cellMaxY = toCell(maxY + loose);
+
+            // NOTE: Zoomed far out the rectangle can span more cells than there are occupied ones
+            auto spanned = (static_cast<r64>(cellMaxX) - cellMinX + 1) * (static_cast<r64>(cellMaxY) - cellMinY + 1);
+            if (spanned > mCells.size()) {
+                for (auto &&cell: mCells) {
+                    visit(cell.second);
+                }
+                return;
+            }
+
+            for (auto cx = cellMinX; cx <= cellMaxX; ++cx) {
+                for (auto cy = cellMinY; cy <= cellMaxY; ++cy) {
+                    auto cell = mCells.find(cellKey(cx, cy));
+                    if (cell != mCells.end()) {
+                        visit(cell->second);
+                    }
+                }
+            }
+        }
+
+    private:
+        static constexpr u32 NoOrder = ~u32{0};
+
+        struct Entry {
+            EntityID id{};
+            r32 x{};
+            r32 y{};
+            r32 radius{};
+        };
+
+        struct Record {
+            // NOTE: Copy of the entry, most entities don't move and comparing here saves reaching into the cell
+            Entry entry{};
+            u64 cell{};
+            // NOTE: Values of unordered_map don't move on rehash, and a cell isn't erased while it has entries
+            std::vector<Entry> *entries{};
+            u32 slot{};
+            u32 stamp{};
+            // NOTE: Index of the update() call that last saw it in mOrder
+            u32 order{NoOrder};
+            bool large{false};
+        };
+
+        struct Hint {
+            EntityID id{};
+            // NOTE: nullptr once the record is gone
+            Record *record{};
+        };
+
+        i32
+        toCell(r32 value) const {
+            return static_cast<i32>(std::floor(value / mCellSize));
+        }
+
+        static u64
+        cellKey(i32 x,
+                i32 y) {
+            return (u64{static_cast<u32>(x)} << 32) | static_cast<u32>(y);
+        }
+
+        void
+        insert(Record &,
+               const Entry &);
+
+        void
+        erase(const Record &);
+
+        void
+        forget(const Record &);
+
+    private:
+        r32 mCellSize{};
+        std::unordered_map<u64, std::vector<Entry>> mCells{};
+        std::vector<Entry> mLarge{};
+        std::unordered_map<EntityID, Record> mRecords{};
+
+        u32 mStamp{1};
+        size mUpdated{0};
+
+        // NOTE: Records in the order of the update() calls since the last removeStale()
+        std::vector<Hint> mOrder{};
+        u32 mNext{0};
+    };
+}
@@ -40,6 +40,13 @@ namespace oni {
     localToWorldTranslation(const mat4 &trans,
                             const WorldP3D &operand);
 
+    // NOTE: Moves the operand from the local space of a parent to the space the parent lives in, z is left as is.
+    void
+    localToWorldTransform(const WorldP3D &parentPos,
+                          const Orientation &parentOrnt,
+                          WorldP3D &pos,
+                          Orientation &ornt);
+
     void
     localToTextureTranslation(r32 ratio,
                               WorldP3D &operand);
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include <oni-core/io/oni-io-fwd.h>
+#include <oni-core/common/oni-common-const.h>
+#include <oni-core/entities/oni-entities-fwd.h>
 #include <oni-core/network/oni-network-peer.h>
+#include <oni-core/network/oni-network-snapshot-delta.h>
 
 namespace oni {
     namespace utils {
@@ -28,12 +32,22 @@ namespace oni {
         void
         sendMessage(std::string &&message);
 
+        // NOTE: With a sequence from CarPrediction::predict() the input is sent even if it is empty so the server
+        // acknowledges every predicted tick.
         void
-        sendInput(const Input *input);
+        sendInput(const Input *input,
+                  u32 sequence = 0);
 
         void
         requestZLevelDelta();
 
+        // NOTE: Called with every component snapshot received from the server, see restoreWorld(), and the
+        // sequence of the last input the server applied to it. Pass both to CarPrediction::reconcile().
+        // Remote entities go into an InterpolationBuffer from here and are sampled from it when rendering.
+        void
+        registerSnapshotHandler(std::function<void(const WorldSnapshot &,
+                                                   u32 inputSequence)> &&handler);
+
     private:
         void
         handle(ENetPeer *peer,
@@ -50,8 +64,19 @@ namespace oni {
         void
         requestSessionSetup();
 
+        void
+        handleComponentsDelta(const u8 *data,
+                              size size);
+
     private:
         ENetPeer *mEnetServer;
         std::unique_ptr<Timer> mTimer{};
+
+        SnapshotHistory mSnapshotHistory{NETWORK_SNAPSHOT_HISTORY};
+        u32 mLatestSnapshot{0};
+        // NOTE: Only the first drop of a streak is logged, the rest are counted in NetworkStats
+        bool mDroppingDeltas{false};
+        std::function<void(const WorldSnapshot &,
+                           u32)> mSnapshotHandler{};
     };
 }
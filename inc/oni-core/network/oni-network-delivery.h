@@ -0,0 +1,55 @@
+#pragma once
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/math/oni-math-function.h>
+#include <oni-core/network/oni-network-packet-type.h>
+
+
+namespace oni {
+    enum class DeliveryMode : oni::u8 {
+        // NOTE: Resent until acknowledged and delivered in order, a lost packet stalls the rest of its channel.
+        RELIABLE,
+        // NOTE: Never resent, anything older than the newest packet received on the channel is dropped.
+        UNRELIABLE_SEQUENCED,
+        // NOTE: Never resent and delivered in whatever order it arrives.
+        UNRELIABLE,
+    };
+
+    // NOTE: Each channel is sequenced independently, so a stalled reliable packet doesn't hold back state.
+    enum class NetworkChannel : oni::u8 {
+        RELIABLE = 0,
+        STATE = 1,
+        EVENT = 2,
+
+        LAST
+    };
+
+    constexpr auto NumNetworkChannels = enumCast(NetworkChannel::LAST);
+
+    struct PacketDelivery {
+        NetworkChannel channel{NetworkChannel::RELIABLE};
+        DeliveryMode mode{DeliveryMode::RELIABLE};
+    };
+
+    inline constexpr PacketDelivery
+    defaultPacketDelivery(PacketType type) {
+        switch (type) {
+            // NOTE: Per-tick state, deltas are encoded against the last snapshot the client acknowledged so the
+            // next one covers a lost one.
+            case PacketType::REGISTRY_COMPONENT_DELTA:
+            case PacketType::SNAPSHOT_ACK: {
+                return {NetworkChannel::STATE, DeliveryMode::UNRELIABLE_SEQUENCED};
+            }
+            // NOTE: Cosmetic, nobody misses the odd spark or sound.
+            case PacketType::EVENT_COLLISION:
+            case PacketType::EVENT_SOUND_PLAY: {
+                return {NetworkChannel::EVENT, DeliveryMode::UNRELIABLE};
+            }
+            // NOTE: Built from dirty flags that are cleared once sent, a lost one would be lost for good.
+            case PacketType::REGISTRY_ONLY_COMPONENT_UPDATE:
+            default: {
+                return {NetworkChannel::RELIABLE, DeliveryMode::RELIABLE};
+            }
+        }
+    }
+}
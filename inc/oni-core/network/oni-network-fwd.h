@@ -2,7 +2,14 @@
 
 namespace oni {
     class Client;
+    class InterestManager;
+    class InterpolationBuffer;
+    class NetworkStats;
+    class OutboundPacket;
+    class ReplicationScheduler;
     class Server;
 
     struct Address;
+    struct ConnectionStats;
+    struct PacketTypeStats;
 }
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/entities/oni-entities-fwd.h>
+#include <oni-core/entities/oni-entities-structure.h>
+
+
+namespace oni {
+    struct InterestConfig {
+        r32 cellSize{64.f};
+        // NOTE: Entities closer than enterRadius to the car of a client become relevant to it and stay relevant
+        // until they are further than exitRadius, so entities on the border don't flicker in and out.
+        r32 enterRadius{150.f};
+        r32 exitRadius{180.f};
+    };
+
+    struct ClientInterest {
+        // NOTE: All sorted by id
+        std::vector<EntityID> relevant{};
+        std::vector<EntityID> entered{};
+        std::vector<EntityID> left{};
+    };
+
+    /**
+     * Area of interest of each client, centered on its car. Entities are bucketed into a uniform grid once per
+     * update and each client only looks at the cells around its car, so the per client cost grows with the
+     * local density rather than the number of entities in the world.
+     *
+     * When used the server should send entered entities with Server::sendEntitiesEntered() instead of
+     * broadcasting new entities, and left ones with Server::sendEntitiesLeft().
+     */
+    class InterestManager {
+    public:
+        explicit InterestManager(const InterestConfig &);
+
+        // NOTE: Attached entities share the relevance of their root.
+        void
+        update(EntityManager &,
+               const ClientDataManager &);
+
+        // NOTE: nullptr if the client wasn't part of the last update.
+        const ClientInterest *
+        find(const std::string &clientID) const;
+
+        // NOTE: Copies the relevant entities of the client out of world, entities of world without a position are
+        // not copied. Unknown clients get an empty snapshot.
+        void
+        filter(const std::string &clientID,
+               const WorldSnapshot &world,
+               WorldSnapshot &out) const;
+
+    private:
+        struct GridEntry {
+            EntityID id{};
+            r32 x{};
+            r32 y{};
+        };
+
+        i32
+        toCell(r32) const;
+
+        static u64
+        cellKey(i32 x,
+                i32 y);
+
+        void
+        updateClient(ClientInterest &,
+                     r32 x,
+                     r32 y);
+
+    private:
+        InterestConfig mConfig{};
+        std::unordered_map<u64, std::vector<GridEntry>> mGrid{};
+        std::map<std::string, ClientInterest> mClients{};
+        std::vector<EntityID> mScratch{};
+    };
+}
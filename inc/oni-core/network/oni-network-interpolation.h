@@ -0,0 +1,87 @@
+#pragma once
+
+#include <deque>
+#include <unordered_map>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/component/oni-component-geometry.h>
+
+
+namespace oni {
+    struct InterpolationConfig {
+        // NOTE: Remote entities are shown this far in the past so there is usually a snapshot on both sides of
+        // the render time. Has to cover the send interval of the server plus the packet jitter.
+        r64 delay{0.1};
+        // NOTE: When the newest snapshot is older than the render time the entity keeps moving with its last
+        // velocity for at most this long, then it stops and waits.
+        r64 maxExtrapolation{0.25};
+        // NOTE: Snapshots kept per entity
+        u32 capacity{32};
+    };
+
+    struct InterpolationStats {
+        u64 interpolated{0};
+        u64 extrapolated{0};
+        // NOTE: Samples where the render time was past the extrapolation limit
+        u64 starved{0};
+        // NOTE: Snapshots dropped for arriving after a newer one
+        u64 outOfOrder{0};
+    };
+
+    /**
+     * Client side buffer of timestamped positions and orientations of remote entities. Snapshots are pushed as
+     * they are received and sampled at now - delay when rendering, interpolating between the two snapshots
+     * around the render time, so remote cars move smoothly even though the server sends at a lower rate than
+     * the client renders at.
+     *
+     * Times are in seconds and only have to be consistent between push() and sample(), the receive time of the
+     * snapshot on the client works.
+     */
+    class InterpolationBuffer {
+    public:
+        explicit InterpolationBuffer(const InterpolationConfig & = {});
+
+        // NOTE: Snapshots not newer than the latest one of the entity are dropped.
+        void
+        push(EntityID,
+             r64 time,
+             const WorldP3D &,
+             const Orientation &);
+
+        // NOTE: Returns false if there is nothing buffered for the entity.
+        bool
+        sample(EntityID,
+               r64 now,
+               WorldP3D &,
+               Orientation &);
+
+        // NOTE: Drops snapshots that no render time from now on will need, call once per frame.
+        void
+        prune(r64 now);
+
+        // NOTE: Call when the entity is deleted or leaves the area of interest.
+        void
+        remove(EntityID);
+
+        void
+        clear();
+
+        r64
+        getRenderTime(r64 now) const;
+
+        const InterpolationStats &
+        getStats() const;
+
+    private:
+        struct Sample {
+            r64 time{0};
+            WorldP3D pos{};
+            Orientation ornt{};
+        };
+
+    private:
+        InterpolationConfig mConfig{};
+        InterpolationStats mStats{};
+        std::unordered_map<EntityID, std::deque<Sample>> mSamples{};
+    };
+}
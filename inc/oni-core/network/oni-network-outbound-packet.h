@@ -0,0 +1,69 @@
+#pragma once
+
+#include <ostream>
+#include <streambuf>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/network/oni-network-packet-type.h>
+
+
+struct _ENetPacket;
+typedef struct _ENetPacket ENetPacket;
+
+namespace oni {
+    /**
+     * Packet that is written in place. The ENet packet is allocated up front with the header byte already in
+     * place and archives write straight into it through stream(), so there is no intermediate string and no
+     * copy when it is handed to ENet.
+     *
+     * Neither copyable nor movable, get one from Peer::beginPacket() and pass it to one of the Peer send
+     * functions.
+     */
+    class OutboundPacket : private std::streambuf {
+    public:
+        OutboundPacket(PacketType type,
+                       u32 enetFlags,
+                       size capacity);
+
+        ~OutboundPacket() override;
+
+        OutboundPacket(const OutboundPacket &) = delete;
+
+        OutboundPacket &
+        operator=(const OutboundPacket &) = delete;
+
+        std::ostream &
+        stream();
+
+        void
+        write(const void *data,
+              size size);
+
+        PacketType
+        getType() const;
+
+        // NOTE: Including the header
+        size
+        getSize() const;
+
+        // NOTE: Trims the packet to what was written, the caller owns the result.
+        ENetPacket *
+        release();
+
+    private:
+        int_type
+        overflow(int_type c) override;
+
+        std::streamsize
+        xsputn(const char_type *data,
+               std::streamsize count) override;
+
+        void
+        grow(size minCapacity);
+
+    private:
+        ENetPacket *mPacket{};
+        PacketType mType{PacketType::UNKNOWN};
+        std::ostream mStream;
+    };
+}
@@ -20,5 +20,10 @@ namespace oni {
         EVENT_SOUND_PLAY = 10,
         EVENT_COLLISION = 11,
         EVENT_ROCKET_LAUNCH = 12,
+
+        REGISTRY_COMPONENT_DELTA = 13,
+        SNAPSHOT_ACK = 14,
+        REGISTRY_ENTITIES_ENTERED = 15,
+        REGISTRY_ENTITIES_LEFT = 16,
     };
 }
@@ -13,4 +13,19 @@ namespace oni {
     struct Packet_Data {
         std::string data{};
     };
+
+    struct Packet_SnapshotAck {
+        u32 sequence{0};
+    };
+
+    // NOTE: Precedes the Input in CLIENT_INPUT packets, 0 when the client doesn't predict.
+    struct Packet_InputSequence {
+        u32 sequence{0};
+    };
+
+    // NOTE: Last input sequence the server applied for the client, precedes the delta in REGISTRY_COMPONENT_DELTA
+    // packets.
+    struct Packet_InputAck {
+        u32 sequence{0};
+    };
 }
@@ -1,13 +1,19 @@
 #pragma once
 
+#include <array>
 #include <cassert>
 #include <map>
 #include <functional>
+#include <string_view>
+#include <vector>
 
 #include <oni-core/common/oni-common-typedef.h>
 #include <oni-core/network/oni-network-address.h>
+#include <oni-core/network/oni-network-delivery.h>
+#include <oni-core/network/oni-network-outbound-packet.h>
 #include <oni-core/network/oni-network-packet.h>
 #include <oni-core/network/oni-network-packet-type.h>
+#include <oni-core/network/oni-network-stats.h>
 #include <oni-core/util/oni-util-timer.h>
 
 
@@ -46,21 +52,49 @@ namespace oni {
         void
         flush();
 
+        // NOTE: The data view points into the received packet and is only valid during the call, copy it if it
+        // has to outlive the handler.
         void
         registerPacketHandler(PacketType type,
                               std::function<
                                       void(const std::string &,
-                                           const std::string &)> &&handler);
+                                           std::string_view)> &&handler);
 
         void
         registerPostDisconnectHook(std::function<void(const std::string &)> &&handler);
 
+        // NOTE: Overrides defaultPacketDelivery(), both ends should agree on the channel of a packet type.
+        void
+        setPacketDelivery(PacketType,
+                          const PacketDelivery &);
+
+        const PacketDelivery &
+        getPacketDelivery(PacketType) const;
+
+        // NOTE: Allocates the packet with room for what the last packet of the same type needed, write the
+        // payload with OutboundPacket::stream() or OutboundPacket::write() and pass it to send() or broadcast().
+        OutboundPacket
+        beginPacket(PacketType);
+
         r32
         getDownloadKBPS() const;
 
         r32
         getUploadKBPS() const;
 
+        const NetworkStats &
+        getStats() const;
+
+        // NOTE: Returns false if the peer is not connected.
+        bool
+        getConnectionStats(const std::string &peerID,
+                           ConnectionStats &) const;
+
+        // NOTE: Prints the traffic per packet type and the connection of each peer from poll() every so often, 0
+        // turns it off.
+        void
+        setStatsLogInterval(r64 seconds);
+
     protected:
         virtual void
         handle(ENetPeer *peer,
@@ -74,12 +108,12 @@ namespace oni {
         PacketType
         getHeader(const u8 *data) const;
 
-        // TODO: Add support for different types of send modes, for example unreliable, or none allocating packets
         void
         send(PacketType type,
              std::string &data,
              ENetPeer *peer);
 
+        // NOTE: data must start with the PacketType header and outlive the packet, it is not copied.
         void
         send(const u8 *data,
              size size,
@@ -89,22 +123,58 @@ namespace oni {
         broadcast(PacketType type,
                   std::string &&data);
 
+        void
+        send(OutboundPacket &&packet,
+             ENetPeer *peer);
+
+        void
+        broadcast(OutboundPacket &&packet);
+
+        // NOTE: For packets the handler received but couldn't use, shows up in getStats() and the stats log.
+        void
+        recordDropped(PacketType);
+
+        // NOTE: Same packet to several peers, ENet reference counts it so it is only allocated once.
+        void
+        multicast(OutboundPacket &&packet,
+                  const std::vector<ENetPeer *> &peers);
+
         virtual void
         postConnectHook(const ENetEvent *event) = 0;
 
         virtual void
         postDisconnectHook(const ENetEvent *event) = 0;
 
+    private:
+        void
+        initPacketDelivery();
+
+        ENetPacket *
+        createPacket(const void *data,
+                     size size,
+                     const PacketDelivery &delivery,
+                     u32 extraFlags);
+
+        void
+        updateSizeHint(const OutboundPacket &packet);
+
+        void
+        logStats();
+
     protected:
         ENetHost *mEnetHost{};
         std::map<std::string, ENetPeer *> mPeers{};
         std::map<
                 PacketType, std::function<
-                        void(std::string,
-                             const std::string &)>> mPacketHandlers{};
+                        void(const std::string &,
+                             std::string_view)>> mPacketHandlers{};
         std::function<void(const std::string &)> mPostDisconnectHook{};
 
     private:
+        std::array<PacketDelivery, 256> mPacketDelivery{};
+        // NOTE: Size of the last packet sent per type, new packets are allocated big enough to avoid resizing.
+        std::array<u32, 256> mPacketSizeHints{};
+
         u64 mTotalDownload{}; // Number of bytes received
         u64 mTotalUpload{}; // Number of bytes sent
 
@@ -113,5 +183,9 @@ namespace oni {
 
         r32 mDownloadBPS{};
         r32 mUploadBPS{};
+
+        NetworkStats mStats{};
+        Timer mStatsLogTimer{};
+        r64 mStatsLogInterval{0};
     };
 }
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/entities/oni-entities-fwd.h>
+#include <oni-core/entities/oni-entities-structure.h>
+
+
+namespace oni {
+    struct ReplicationConfig {
+        // NOTE: Snapshots per second, independent of the simulation tick rate.
+        r64 sendRate{20};
+        // NOTE: Per client per send, estimated from the delta encoding before anything is written.
+        u32 bytesPerSend{1200};
+        // NOTE: Priority drops to half at this distance from the car of the client.
+        r32 distanceScale{50.f};
+        // NOTE: Extra priority per unit of speed, fast movers look worse when their updates are late.
+        r32 speedWeight{0.05f};
+    };
+
+    struct ReplicationStats {
+        u64 sends{0};
+        u64 entitiesSent{0};
+        // NOTE: Changed entities that didn't fit the budget and rolled over to the next send
+        u64 entitiesDeferred{0};
+        u64 estimatedBytes{0};
+    };
+
+    /**
+     * Decides what goes into each snapshot a client receives, see Server::sendComponentsDelta(). Runs at its own
+     * send rate and gives each client a byte budget per send.
+     *
+     * Every entity with changes the client hasn't been sent yet collects priority each send: more for entities
+     * close to the car of the client and fast ones, and the longer it waits the more it collects. The changes are
+     * sent in priority order until the budget is used up, the rest keep their priority and roll over. Entities
+     * that are not picked repeat what was sent last, which costs the client next to nothing once acknowledged.
+     */
+    class ReplicationScheduler {
+    public:
+        explicit ReplicationScheduler(const ReplicationConfig &);
+
+        // NOTE: Call every simulation tick, returns true when it is time to capture and send a snapshot.
+        bool
+        tick(r64 dt);
+
+        // NOTE: Call before sending, collects the positions and speeds the priorities are based on.
+        void
+        update(EntityManager &,
+               const ClientDataManager &);
+
+        // NOTE: Fills out with the part of world to send to the client this time. baseline is the snapshot the
+        // delta will be encoded against, nullptr if there is none.
+        void
+        select(const std::string &clientID,
+               const WorldSnapshot &world,
+               const WorldSnapshot *baseline,
+               WorldSnapshot &out);
+
+        // NOTE: For example a smaller budget for a client on a congested link, 0 to go back to the default.
+        void
+        setClientBudget(const std::string &clientID,
+                        u32 bytesPerSend);
+
+        void
+        removeClient(const std::string &clientID);
+
+        // NOTE: nullptr if nothing was sent to the client yet.
+        const ReplicationStats *
+        getStats(const std::string &clientID) const;
+
+    private:
+        struct EntityInfo {
+            r32 x{};
+            r32 y{};
+            r32 speed{};
+        };
+
+        struct Candidate {
+            r32 priority{};
+            u32 index{};
+        };
+
+        struct ClientState {
+            // NOTE: What was sent last for each entity, sorted by id
+            WorldSnapshot view{};
+            // NOTE: Accumulated priority of the entities with unsent changes, sorted by id
+            std::vector<std::pair<EntityID, r32>> priorities{};
+            u32 bytesPerSend{0};
+            bool hasFocus{false};
+            r32 x{};
+            r32 y{};
+            ReplicationStats stats{};
+        };
+
+        r32
+        priority(const ClientState &,
+                 EntityID) const;
+
+    private:
+        ReplicationConfig mConfig{};
+        r64 mElapsed{0};
+        r64 mInterval{0};
+        std::unordered_map<EntityID, EntityInfo> mEntities{};
+        std::map<std::string, ClientState> mClients{};
+
+        std::vector<Candidate> mCandidates{};
+        std::vector<u8> mSelected{};
+        std::vector<i64> mExtraBits{};
+        std::vector<std::pair<EntityID, r32>> mPriorities{};
+    };
+}
@@ -1,15 +1,21 @@
 #pragma once
 
 #include <map>
+#include <string>
+#include <vector>
 
+#include <oni-core/common/oni-common-const.h>
 #include <oni-core/common/oni-common-typedef.h>
 #include <oni-core/component/oni-component-visual.h>
 #include <oni-core/entities/oni-entities-fwd.h>
 #include <oni-core/game/oni-game-fwd.h>
 #include <oni-core/network/oni-network-address.h>
+#include <oni-core/network/oni-network-fwd.h>
 #include <oni-core/network/oni-network-packet.h>
 #include <oni-core/network/oni-network-peer.h>
+#include <oni-core/network/oni-network-snapshot-delta.h>
 #include <oni-core/physics/oni-physics-fwd.h>
+#include <oni-core/util/oni-util-bit-stream.h>
 
 
 namespace oni {
@@ -24,17 +30,75 @@ namespace oni {
         void
         sendEntitiesAll(EntityManager &, std::string &&data);
 
+        // NOTE: The OutboundPacket overloads take a packet from beginPacket() with the matching type that the
+        // caller serialized into, see serialize(manager, snapshotType, packet.stream()).
+        void
+        sendEntitiesAll(OutboundPacket &&packet);
+
         void
         sendComponentsUpdate(EntityManager &,
                              std::string &&data);
 
+        void
+        sendComponentsUpdate(OutboundPacket &&packet);
+
+        // NOTE: Sends each client only what changed since the last snapshot it acknowledged, or everything if it
+        // hasn't acknowledged any of the recent ones. Capture the snapshot with captureWorld(), the sequence is
+        // assigned here.
+        void
+        sendComponentsDelta(WorldSnapshot &&snapshot);
+
+        // NOTE: Same as above but each client only gets the entities in its area of interest.
+        void
+        sendComponentsDelta(WorldSnapshot &&snapshot,
+                            const InterestManager &interest);
+
+        // NOTE: Each client gets what the scheduler picks for it within its budget, call it when
+        // ReplicationScheduler::tick() says so rather than every simulation tick.
+        void
+        sendComponentsDelta(WorldSnapshot &&snapshot,
+                            ReplicationScheduler &scheduler);
+
+        void
+        sendComponentsDelta(WorldSnapshot &&snapshot,
+                            const InterestManager &interest,
+                            ReplicationScheduler &scheduler);
+
+        // NOTE: Entities that came into the area of interest of the client, serialized with
+        // serialize<Components...>(manager, entities).
+        void
+        sendEntitiesEntered(const std::string &clientID,
+                            std::string &&data);
+
+        void
+        sendEntitiesEntered(const std::string &clientID,
+                            OutboundPacket &&packet);
+
+        // NOTE: Entities that left the area of interest of the client, unlike deleted entities they still exist.
+        void
+        sendEntitiesLeft(const std::string &clientID,
+                         const std::vector<EntityID> &entities);
+
         void
         sendNewEntities(EntityManager &,
                         std::string &&data);
 
+        void
+        sendNewEntities(OutboundPacket &&packet);
+
         void
         broadcastDeletedEntities(EntityManager &);
 
+        // NOTE: Sequence of the last input received from the client, pass it to ClientDataManager::setClientInput()
+        // from the CLIENT_INPUT handler.
+        u32
+        getInputSequence(const std::string &peerID) const;
+
+        // NOTE: Takes the sequence of the last input System_CarInput applied for each client, it is sent along with
+        // the component deltas. Call it after the tick is simulated and before its snapshot goes out.
+        void
+        setAppliedInputs(const ClientDataManager &);
+
         void
         sendCarEntityID(EntityID,
                         const std::string &);
@@ -64,6 +128,42 @@ namespace oni {
         void
         postDisconnectHook(const ENetEvent *) override;
 
+        void
+        handleSnapshotAck(const std::string &peerID,
+                          u32 sequence);
+
+        u32
+        nextSnapshotSequence();
+
+        // NOTE: Encodes a delta per client against its own history, either or both of interest and scheduler can be
+        // nullptr.
+        void
+        sendComponentsDeltaPerPeer(WorldSnapshot &&snapshot,
+                                   const InterestManager *interest,
+                                   ReplicationScheduler *scheduler);
+
+        void
+        handleInputSequence(const std::string &peerID,
+                            u32 sequence);
+
+        u32
+        getAppliedInputSequence(const std::string &peerID) const;
+
+        // NOTE: Payload of REGISTRY_COMPONENT_DELTA, the delta is what mDeltaWriter holds
+        void
+        writeComponentsDelta(u32 inputSequence,
+                             OutboundPacket &packet);
+
     private:
+        SnapshotHistory mSnapshotHistory{NETWORK_SNAPSHOT_HISTORY};
+        // NOTE: With interest management each client has its own view of the world, and so its own baselines.
+        std::map<std::string, SnapshotHistory> mPeerSnapshotHistory{};
+        u32 mSnapshotSequence{0};
+        BitWriter mDeltaWriter{};
+        WorldSnapshot mFiltered{};
+        std::map<std::string, u32> mAckedSnapshots{};
+        // NOTE: Last input received and last input applied per client
+        std::map<std::string, u32> mInputSequences{};
+        std::map<std::string, u32> mAppliedInputSequences{};
     };
 }
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/entities/oni-entities-structure.h>
+#include <oni-core/util/oni-util-fwd.h>
+
+
+namespace oni {
+    // NOTE: Ring of the most recent snapshots indexed by sequence, sequence 0 is never stored and means "no
+    // snapshot".
+    class SnapshotHistory {
+    public:
+        explicit SnapshotHistory(u32 capacity);
+
+        void
+        push(WorldSnapshot &&);
+
+        // NOTE: nullptr if the snapshot was never stored or has been overwritten since.
+        const WorldSnapshot *
+        find(u32 sequence) const;
+
+        void
+        clear();
+
+    private:
+        std::vector<WorldSnapshot> mSnapshots{};
+    };
+
+    // NOTE: Wraps around, a is newer than b if it is less than half the range ahead of it.
+    inline bool
+    isNewerSequence(u32 a,
+                    u32 b) {
+        return static_cast<i32>(a - b) > 0;
+    }
+
+    /**
+     * Encodes current relative to baseline. Each entity costs a few bits when it didn't change, otherwise every
+     * 4 byte word is XOR-ed with the baseline and only the significant bits of the XOR are written, so small
+     * changes to a float or a counter take a handful of bits instead of 32.
+     *
+     * @param baseline last snapshot the receiver acknowledged, nullptr to encode everything
+     * @param current
+     * @param out cleared and filled with the encoded packet payload, reuse it between calls to avoid allocating
+     */
+    void
+    encodeSnapshotDelta(const WorldSnapshot *baseline,
+                        const WorldSnapshot &current,
+                        BitWriter &out);
+
+    // NOTE: Bits encodeSnapshotDelta() spends on the data of entity, not counting its id. base is the data of the
+    // same entity in the baseline, nullptr if it is sent in full.
+    u32
+    entityDeltaBits(const u8 *base,
+                    const EntitySnapshot &entity,
+                    const u8 *data);
+
+    // NOTE: Looks up the baseline the sender used in history, returns false if it is missing or the data is
+    // malformed.
+    bool
+    decodeSnapshotDelta(const SnapshotHistory &history,
+                        const u8 *data,
+                        size size,
+                        WorldSnapshot &out);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/network/oni-network-packet-type.h>
+
+
+namespace oni {
+    // NOTE: Bucket 0 counts empty payloads, bucket i sizes in [2^(i-1), 2^i) bytes and the last one everything
+    // bigger.
+    constexpr u8 NumPacketSizeBuckets = 16;
+
+    u8
+    packetSizeBucket(size bytes);
+
+    const c8 *
+    packetTypeName(PacketType);
+
+    struct PacketTypeStats {
+        u64 packetsSent{0};
+        u64 bytesSent{0};
+        u64 packetsReceived{0};
+        u64 bytesReceived{0};
+        // NOTE: Time spent in Peer::handle() for this type
+        u64 handleNS{0};
+        // NOTE: Received but thrown away by the handler, for example a delta against a baseline that is gone
+        u64 packetsDropped{0};
+        std::array<u32, NumPacketSizeBuckets> sentSizes{};
+        std::array<u32, NumPacketSizeBuckets> receivedSizes{};
+    };
+
+    // NOTE: As ENet measures it, see Peer::getConnectionStats().
+    struct ConnectionStats {
+        u32 roundTripTimeMS{0};
+        u32 lowestRoundTripTimeMS{0};
+        // NOTE: Mean deviation of the round trip time
+        u32 jitterMS{0};
+        // NOTE: 0 to 1
+        r32 packetLoss{0};
+        // NOTE: Share of unreliable packets ENet lets through, 1 when the link keeps up, 0 to 1
+        r32 packetThrottle{1};
+        u32 packetsSent{0};
+        u32 packetsLost{0};
+    };
+
+    /**
+     * Packet and byte counters per PacketType, payload size histograms and handler time. Keeps totals since
+     * creation for queries and a window since the last summarize() for periodic logging.
+     */
+    class NetworkStats {
+    public:
+        // NOTE: bytes includes the header byte, count is the number of peers the packet went to.
+        void
+        recordSent(PacketType,
+                   size bytes,
+                   u32 count = 1);
+
+        void
+        recordReceived(PacketType,
+                       size bytes,
+                       u64 handleNS);
+
+        void
+        recordDropped(PacketType);
+
+        const PacketTypeStats &
+        get(PacketType) const;
+
+        // NOTE: One line with the busiest packet types of the window first, starts a new window.
+        std::string
+        summarize(r64 elapsedSeconds);
+
+        void
+        reset();
+
+    private:
+        std::array<PacketTypeStats, 256> mTotal{};
+        std::array<PacketTypeStats, 256> mWindow{};
+    };
+}
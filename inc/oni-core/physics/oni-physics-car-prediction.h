@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/component/oni-component-geometry.h>
+#include <oni-core/component/oni-component-physics.h>
+#include <oni-core/io/oni-io-input-structure.h>
+
+
+namespace oni {
+    struct CarState {
+        Car car{};
+        WorldP3D pos{};
+        Orientation ornt{};
+    };
+
+    struct CarPredictionStats {
+        u64 reconciliations{0};
+        u64 mispredictions{0};
+        // NOTE: Reconciliations where the acknowledged input was no longer in the history, the prediction is
+        // replaced with the server state.
+        u64 historyMisses{0};
+        // NOTE: Distance between the predicted and the authoritative position of the acknowledged input
+        r64 lastCorrection{0};
+        r64 maxCorrection{0};
+        r64 totalCorrection{0};
+    };
+
+    /**
+     * Client side prediction of the car of the player. Every client tick the local input is stamped with a
+     * sequence number, sent to the server with Client::sendInput() and applied right away to a local copy of the
+     * car with stepCar(), so controls respond without waiting for the round trip.
+     *
+     * When a server snapshot arrives it carries the last input sequence the server applied to it, see
+     * Client::registerSnapshotHandler(). The prediction made for that input is compared with the server state and
+     * if they disagree the car is rewound to the server state and the inputs the server hasn't seen yet are
+     * replayed on top of it.
+     */
+    class CarPrediction {
+    public:
+        // NOTE: historySize is the number of unacknowledged inputs kept around, it has to cover the round trip.
+        // Sequences count up from firstSequence and wrap around, skipping 0.
+        explicit CarPrediction(u32 historySize = 128,
+                               r64 tolerance = 0.01,
+                               u32 firstSequence = 1);
+
+        // NOTE: Starts over from the given state, for example when the car is (re)spawned.
+        void
+        reset(const CarState &state);
+
+        // NOTE: Returns the sequence number of the input, send it along with the input.
+        u32
+        predict(const CarConfig &config,
+                const CarInput &input,
+                r64 dt);
+
+        void
+        reconcile(u32 ackedSequence,
+                  const CarState &authoritative,
+                  const CarConfig &config);
+
+        const CarState &
+        getState() const;
+
+        const CarPredictionStats &
+        getStats() const;
+
+        // NOTE: Inputs sent but not acknowledged by the server yet
+        u32
+        getPendingCount() const;
+
+    private:
+        struct Entry {
+            u32 sequence{0};
+            CarInput input{};
+            r64 dt{0};
+            // NOTE: State right after the input was applied
+            CarState predicted{};
+        };
+
+        Entry *
+        find(u32 sequence);
+
+    private:
+        std::vector<Entry> mHistory{};
+        // NOTE: Oldest entry that is not acknowledged yet
+        u32 mFirst{0};
+        u32 mCount{0};
+        u32 mNextSequence{1};
+        u32 mLastAcked{0};
+        r64 mTolerance{};
+
+        CarState mState{};
+        CarPredictionStats mStats{};
+    };
+}
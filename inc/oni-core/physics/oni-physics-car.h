@@ -13,6 +13,24 @@
  */
 
 namespace oni {
+    // NOTE: One simulation step of a car including steering and nitro. System_Car and the client side prediction
+    // both go through this so the same input produces the same result on both ends.
+    //
+    // Floating point rules for bit identical results between runs, and between client and server in lockstep:
+    // - Same binary, or at least same compiler, flags and libm. std::sin, std::cos and std::atan2 are not
+    //   correctly rounded and differ between implementations.
+    // - No -ffast-math, and no FMA contraction, oni-core-physics and oni-core-math build with -ffp-contract=off.
+    // - Keep the order of operations and the r32/r64 mix as it is, (a + b) + c is not a + (b + c).
+    // - dt is the fixed tick, never the measured frame time.
+    // - Randomness only from makeRandStream() with a master seed set, see setRandMasterSeed().
+    void
+    stepCar(Car &car,
+            WorldP3D &,
+            Orientation &,
+            const CarConfig &config,
+            const CarInput &input,
+            r64 dt);
+
     void
     tickCar(Car &car,
             WorldP3D &,
@@ -31,4 +49,9 @@ namespace oni {
     applySafeSteer(const Car &car,
                    r64 steerInput);
 
+    // NOTE: Key bindings of the car, used by System_CarInput on the server and by prediction on the client.
+    void
+    mapCarInput(const Input &input,
+                CarInput &carInput);
+
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 namespace oni {
+    class CarPrediction;
     class CollisionListener;
     class Physics;
     class System_TimeToLive;
@@ -10,4 +11,7 @@ namespace oni {
     class System_SplatOnRest;
     class System_JetForce;
     class System_CarCollision;
+    class System_WorldTransform;
+
+    struct CarState;
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <oni-core/system/oni-system.h>
+#include <oni-core/component/oni-component-geometry.h>
 #include <oni-core/component/oni-component-physics.h>
 #include <oni-core/physics/oni-physics-fwd.h>
 #include <oni-core/io/oni-io-fwd.h>
@@ -26,8 +27,8 @@ namespace oni {
 
     class System_Car : public SystemTemplate<
             Car,
-            CarInput,
-            CarConfig,
+            const CarInput,
+            const CarConfig,
             WorldP3D,
             Orientation> {
     public:
@@ -37,8 +38,8 @@ namespace oni {
         void
         update(EntityTickContext &,
                Car &,
-               CarInput &,
-               CarConfig &,
+               const CarInput &,
+               const CarConfig &,
                WorldP3D &,
                Orientation &) override;
 
@@ -51,7 +52,7 @@ namespace oni {
             PhysicalBody,
             WorldP3D,
             Orientation,
-            Scale> {
+            const Scale> {
     public:
         explicit System_SyncPos(EntityManager &);
 
@@ -61,7 +62,7 @@ namespace oni {
                PhysicalBody &,
                WorldP3D &,
                Orientation &,
-               Scale &) override;
+               const Scale &) override;
 
         void
         postUpdate(EntityManager &mng,
@@ -83,22 +84,22 @@ namespace oni {
     };
 
     class System_SplatOnRest : public SystemTemplate<
-            SplatOnRest,
-            PhysicalBody,
-            Scale,
-            WorldP3D,
-            Orientation> {
+            const SplatOnRest,
+            const PhysicalBody,
+            const Scale,
+            const WorldP3D,
+            const Orientation> {
     public:
         explicit System_SplatOnRest(EntityManager &);
 
     protected:
         void
         update(EntityTickContext &,
-               SplatOnRest &,
-               PhysicalBody &,
-               Scale &,
-               WorldP3D &,
-               Orientation &) override;
+               const SplatOnRest &,
+               const PhysicalBody &,
+               const Scale &,
+               const WorldP3D &,
+               const Orientation &) override;
 
         void
         postUpdate(EntityManager &mng,
@@ -107,7 +108,7 @@ namespace oni {
 
     class System_JetForce : public SystemTemplate<
             JetForce,
-            Orientation,
+            const Orientation,
             PhysicalBody> {
     public:
         explicit System_JetForce(EntityManager &);
@@ -116,7 +117,7 @@ namespace oni {
         void
         update(EntityTickContext &,
                JetForce &,
-               Orientation &,
+               const Orientation &,
                PhysicalBody &) override;
 
         void
@@ -124,7 +125,7 @@ namespace oni {
                    duration32 dt) override;
 
     private:
-        std::vector<EntityID> mExpiredForces{};
+        EntityCommandBuffer mCommands{};
     };
 
     class System_CarCollision : public SystemTemplate<
@@ -152,8 +153,10 @@ namespace oni {
                    duration32 dt) override;
     };
 
+    // NOTE: Each entity only depends on its own components so the parallel update is deterministic, the floating
+    // point rules of stepCar() apply.
     class System_PositionAndVelocity
-            : public SystemTemplate<Velocity, Acceleration, WorldP3D, Direction> {
+            : public SystemTemplate<Velocity, const Acceleration, WorldP3D, const Direction> {
     public:
         explicit System_PositionAndVelocity(oni::EntityManager &);
 
@@ -161,13 +164,60 @@ namespace oni {
         void
         update(EntityTickContext &,
                Velocity &,
-               Acceleration &,
+               const Acceleration &,
                WorldP3D &,
-               Direction &) override;
+               const Direction &) override;
 
         void
         postUpdate(EntityManager &mng,
                    duration32 dt) override;
     };
 
+    /**
+     * Resolves WorldTransform of every attached entity, walking down from the roots so parents are resolved
+     * before their children. An entity is only recomputed when its local pose or the world pose of its parent
+     * changed, so subtrees that didn't move cost a comparison per entity.
+     *
+     * Register it after the systems that move entities, everything after it in the tick reads the cached value.
+     * Children attached from another manager through EntityAttachmentShadow are resolved as well, pass every
+     * manager they can live in as shadowMngs so the access to them is declared.
+     */
+    class System_WorldTransform : public System {
+    public:
+        explicit System_WorldTransform(EntityManager &,
+                                       std::vector<EntityManager *> shadowMngs = {});
+
+    protected:
+        void
+        update(EntityManager &mng,
+               duration32 dt) override;
+
+        void
+        postUpdate(EntityManager &mng,
+                   duration32 dt) override;
+
+    private:
+        struct Node {
+            EntityManager *mng{};
+            EntityID id{};
+            WorldP3D parentPos{};
+            Orientation parentOrnt{};
+            u8 depth{};
+        };
+
+        void
+        pushChildren(EntityManager &mng,
+                     EntityID id,
+                     const WorldP3D &pos,
+                     const Orientation &ornt,
+                     u8 depth);
+
+        void
+        resolve(const Node &);
+
+    private:
+        // NOTE: Own manager and the shadow ones, the access to each is declared
+        std::vector<const EntityManager *> mMngs{};
+        std::vector<Node> mStack{};
+    };
 }
\ No newline at end of file
@@ -2,4 +2,8 @@
 
 namespace oni {
     class System;
-}
\ No newline at end of file
+    class SystemScheduler;
+
+    struct SystemAccess;
+    struct SystemAccessEntry;
+}
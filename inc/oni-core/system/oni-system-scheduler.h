@@ -0,0 +1,61 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+#include <oni-core/system/oni-system-fwd.h>
+#include <oni-core/util/oni-util-fwd.h>
+
+
+namespace oni {
+    // NOTE: Runs systems on a ThreadPool. The order of add() calls is the serial order, and a system only waits
+    // for the earlier systems whose SystemAccess conflicts with its own. Given that every system declares what it
+    // touches the result is identical to calling tick() on each system one after the other.
+    class SystemScheduler {
+    public:
+        explicit SystemScheduler(ThreadPool &);
+
+        ~SystemScheduler();
+
+        SystemScheduler(const SystemScheduler &) = delete;
+
+        SystemScheduler &
+        operator=(const SystemScheduler &) = delete;
+
+        void
+        add(System *);
+
+        void
+        tick(duration32 dt);
+
+        // NOTE: Useful for debugging and for verifying parallel results against the reference order.
+        void
+        tickSerial(duration32 dt);
+
+        size
+        getSystemCount() const;
+
+    private:
+        void
+        buildGraph();
+
+        void
+        run(u32 nodeIdx,
+            duration32 dt);
+
+    private:
+        struct Node {
+            System *system{};
+            std::vector<u32> dependents{};
+            u32 dependencyCount{0};
+        };
+
+        ThreadPool &mPool;
+        std::vector<Node> mNodes{};
+        std::unique_ptr<std::atomic<u32>[]> mPendingDependencies{};
+        std::atomic<u32> mRemaining{0};
+        bool mDirty{true};
+    };
+}
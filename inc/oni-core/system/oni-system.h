@@ -1,9 +1,59 @@
 #pragma once
 
+#include <type_traits>
+#include <typeinfo>
+#include <vector>
+
 #include <oni-core/common/oni-common-typedef.h>
 #include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/util/oni-util-profiler.h>
 
 namespace oni {
+    template<class T>
+    struct AccessKeyTag {
+        static constexpr c8 tag{};
+    };
+
+    // NOTE: Unique address per component type, so access sets can be built without asking the registry.
+    using AccessKey = const void *;
+
+    template<class T>
+    constexpr AccessKey
+    accessKey() {
+        return &AccessKeyTag<std::remove_cv_t<T>>::tag;
+    }
+
+    struct SystemAccessEntry {
+        // NOTE: Either the EntityManager the component lives in or an external resource, such as AudioManager.
+        const void *scope{};
+        // NOTE: nullptr matches every key in the scope, used for structural changes such as creating and
+        // deleting entities or enqueuing events.
+        AccessKey key{};
+        bool write{false};
+    };
+
+    struct SystemAccess {
+        std::vector<SystemAccessEntry> entries{};
+
+        bool
+        conflicts(const SystemAccess &other) const {
+            for (auto &&a: entries) {
+                for (auto &&b: other.entries) {
+                    if (a.scope != b.scope) {
+                        continue;
+                    }
+                    if (!a.write && !b.write) {
+                        continue;
+                    }
+                    if (!a.key || !b.key || a.key == b.key) {
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+    };
+
     class System {
     public:
         explicit System(EntityManager &mng) : mEntityManager(mng) {}
@@ -12,10 +62,17 @@ namespace oni {
 
         void
         tick(duration32 dt) {
+            // NOTE: Zone is named after the concrete system, the exporters demangle it.
+            ONI_PROFILE_ZONE(typeid(*this).name());
             update(mEntityManager, dt);
             postUpdate(mEntityManager, dt);
         }
 
+        const SystemAccess &
+        getAccess() const {
+            return mAccess;
+        }
+
     protected:
         virtual void
         update(EntityManager &mng,
@@ -25,27 +82,105 @@ namespace oni {
         postUpdate(EntityManager &mng,
                    duration32 dt) = 0;
 
+        // NOTE: Components accessed through etc.mng.get() and friends that are not part of the system signature
+        // have to be declared, otherwise SystemScheduler might run the system in parallel with a writer.
+        template<class ...Component>
+        void
+        declareRead() {
+            declareRead<Component...>(mEntityManager);
+        }
+
+        // NOTE: Adding and removing components of a declared type is allowed, it only touches that type's pool.
+        template<class ...Component>
+        void
+        declareWrite() {
+            declareWrite<Component...>(mEntityManager);
+        }
+
+        // NOTE: Components of another manager, for example one reached through EntityAttachmentShadow.
+        template<class ...Component>
+        void
+        declareRead(const EntityManager &mng) {
+            (mAccess.entries.push_back({&mng, accessKey<Component>(), false}), ...);
+        }
+
+        template<class ...Component>
+        void
+        declareWrite(const EntityManager &mng) {
+            (mAccess.entries.push_back({&mng, accessKey<Component>(), true}), ...);
+        }
+
+        void
+        declareRead(const void *resource) {
+            mAccess.entries.push_back({resource, resource, false});
+        }
+
+        void
+        declareWrite(const void *resource) {
+            mAccess.entries.push_back({resource, resource, true});
+        }
+
+        // NOTE: Creating or deleting entities, enqueuing events or using the manager's Rand.
+        void
+        declareStructural(const EntityManager &mng) {
+            mAccess.entries.push_back({&mng, nullptr, true});
+        }
+
+        void
+        declareStructural() {
+            declareStructural(mEntityManager);
+        }
+
     private:
         EntityManager &mEntityManager;
+        SystemAccess mAccess{};
     };
 
+    // NOTE: Components listed as const are read-only, the rest are considered written to.
     template<class ...Component>
     class SystemTemplate : public System {
     protected:
-        explicit SystemTemplate(EntityManager &mng) : System(mng) {}
+        explicit SystemTemplate(EntityManager &mng) : System(mng) {
+            (declareSignature<Component>(), ...);
+        }
 
         void
         update(EntityManager &mng,
                duration32 dt) override {
             auto functor = [this](EntityTickContext &etc,
-                                  Component &... args) {
+                                  std::remove_const_t<Component> &... args) {
                 update(etc, args...);
             };
-            mng.update<Component...>(functor, dt);
+            if (mParallelUpdate) {
+                mng.updateParallel<std::remove_const_t<Component>...>(functor, dt);
+            } else {
+                mng.update<std::remove_const_t<Component>...>(functor, dt);
+            }
         }
 
         virtual void
         update(EntityTickContext &,
                Component &...args) = 0;
+
+        // NOTE: Opt-in for systems whose per-entity update only touches its own entity, see
+        // EntityManager::updateParallel() for what is allowed in update().
+        void
+        enableParallelUpdate() {
+            mParallelUpdate = true;
+        }
+
+    private:
+        template<class C>
+        void
+        declareSignature() {
+            if constexpr (std::is_const_v<C>) {
+                declareRead<C>();
+            } else {
+                declareWrite<C>();
+            }
+        }
+
+    private:
+        bool mParallelUpdate{false};
     };
-}
\ No newline at end of file
+}
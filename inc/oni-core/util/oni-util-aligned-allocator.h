@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+#include <oni-core/common/oni-common-typedef.h>
+
+namespace oni {
+    // NOTE: For std::vector storage that SIMD kernels load with aligned loads.
+    template<class T, size Alignment>
+    struct AlignedAllocator {
+        static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0);
+
+        using value_type = T;
+
+        template<class U>
+        struct rebind {
+            using other = AlignedAllocator<U, Alignment>;
+        };
+
+        AlignedAllocator() noexcept = default;
+
+        template<class U>
+        AlignedAllocator(const AlignedAllocator<U, Alignment> &) noexcept {}
+
+        T *
+        allocate(std::size_t n) {
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+        }
+
+        void
+        deallocate(T *p,
+                   std::size_t) noexcept {
+            ::operator delete(p, std::align_val_t{Alignment});
+        }
+
+        template<class U>
+        bool
+        operator==(const AlignedAllocator<U, Alignment> &) const noexcept {
+            return true;
+        }
+
+        template<class U>
+        bool
+        operator!=(const AlignedAllocator<U, Alignment> &) const noexcept {
+            return false;
+        }
+    };
+}
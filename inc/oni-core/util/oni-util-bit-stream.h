@@ -0,0 +1,79 @@
+#pragma once
+
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+
+
+namespace oni {
+    // NOTE: Number of bits needed to represent value, 0 for 0.
+    inline u8
+    bitWidth(u32 value) {
+        return value ? static_cast<u8>(32 - __builtin_clz(value)) : 0;
+    }
+
+    // NOTE: Packs values LSB first with no padding between them, the last byte is zero padded by finish().
+    class BitWriter {
+    public:
+        void
+        write(u32 value,
+              u8 bits);
+
+        void
+        writeBit(bool);
+
+        // NOTE: 6 bit width followed by that many bits, small values take only a few bits.
+        void
+        writeVarBits(u32 value);
+
+        // NOTE: Flushes the partial byte, call before getData().
+        void
+        finish();
+
+        const std::vector<u8> &
+        getData() const;
+
+        size
+        getBitCount() const;
+
+        // NOTE: Keeps the storage around so a writer can be reused without allocating.
+        void
+        clear();
+
+    private:
+        std::vector<u8> mData{};
+        u64 mScratch{0};
+        u8 mScratchBits{0};
+        size mBitCount{0};
+    };
+
+    class BitReader {
+    public:
+        BitReader(const u8 *data,
+                  size size);
+
+        // NOTE: Reading past the end returns zeros and marks the reader bad, check good() once done.
+        u32
+        read(u8 bits);
+
+        bool
+        readBit();
+
+        u32
+        readVarBits();
+
+        bool
+        good() const;
+
+        size
+        getBitsLeft() const;
+
+    private:
+        const u8 *mData{};
+        size mSize{0};
+        size mPos{0};
+        u64 mScratch{0};
+        u8 mScratchBits{0};
+        bool mGood{true};
+    };
+}
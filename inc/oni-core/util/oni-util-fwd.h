@@ -1,6 +1,10 @@
 #pragma once
 
 namespace oni {
+    class ThreadPool;
+
+    class BitWriter;
+
     struct EntityDefDirPath;
     struct FilePath;
-}
\ No newline at end of file
+}
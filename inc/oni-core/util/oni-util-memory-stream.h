@@ -0,0 +1,58 @@
+#pragma once
+
+#include <streambuf>
+
+#include <oni-core/common/oni-common-typedef.h>
+
+
+namespace oni {
+    // NOTE: Read-only stream buffer over memory owned by someone else, lets std::istream based readers such as
+    // cereal archives parse a buffer in place instead of copying it into a std::stringstream first.
+    class MemoryInputBuffer : public std::streambuf {
+    public:
+        MemoryInputBuffer(const void *data,
+                          size size) {
+            auto *begin = const_cast<c8 *>(static_cast<const c8 *>(data));
+            setg(begin, begin, begin + size);
+        }
+
+    protected:
+        pos_type
+        seekoff(off_type offset,
+                std::ios_base::seekdir dir,
+                std::ios_base::openmode which) override {
+            if (!(which & std::ios_base::in)) {
+                return pos_type(off_type(-1));
+            }
+            auto *target = gptr();
+            switch (dir) {
+                case std::ios_base::beg: {
+                    target = eback() + offset;
+                    break;
+                }
+                case std::ios_base::cur: {
+                    target = gptr() + offset;
+                    break;
+                }
+                case std::ios_base::end: {
+                    target = egptr() + offset;
+                    break;
+                }
+                default: {
+                    return pos_type(off_type(-1));
+                }
+            }
+            if (target < eback() || target > egptr()) {
+                return pos_type(off_type(-1));
+            }
+            setg(eback(), target, egptr());
+            return pos_type(target - eback());
+        }
+
+        pos_type
+        seekpos(pos_type position,
+                std::ios_base::openmode which) override {
+            return seekoff(off_type(position), std::ios_base::beg, which);
+        }
+    };
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+
+// NOTE: Zones are compiled out of release builds unless ONI_PROFILER_ENABLED is set explicitly, for example to
+// profile a live server build.
+#if !defined(ONI_PROFILER_ENABLED)
+#if defined(NDEBUG)
+#define ONI_PROFILER_ENABLED 0
+#else
+#define ONI_PROFILER_ENABLED 1
+#endif
+#endif
+
+#define ONI_PROFILE_CONCAT_IMPL(a, b) a##b
+#define ONI_PROFILE_CONCAT(a, b) ONI_PROFILE_CONCAT_IMPL(a, b)
+
+#if ONI_PROFILER_ENABLED
+// NOTE: name has to outlive the profiler, string literals and typeid().name() are fine.
+#define ONI_PROFILE_ZONE(name) oni::ProfileZone ONI_PROFILE_CONCAT(_oniProfileZone, __COUNTER__){name}
+#else
+#define ONI_PROFILE_ZONE(name) do {} while (false)
+#endif
+
+namespace oni {
+    struct ProfileSample {
+        const c8 *name{};
+        u64 startNS{};
+        u64 endNS{};
+    };
+
+    // NOTE: Fixed size ring of samples owned by one thread. The owner is the only writer, readers copy the ring
+    // and drop whatever the owner overwrote while they were copying, so neither side ever locks.
+    class ProfileThreadBuffer {
+    public:
+        ProfileThreadBuffer(u32 threadIdx,
+                            size capacity);
+
+        void
+        push(const c8 *name,
+             u64 startNS,
+             u64 endNS);
+
+        // NOTE: Appends the samples currently in the ring, oldest first.
+        void
+        copy(std::vector<ProfileSample> &out) const;
+
+        u32
+        getThreadIdx() const;
+
+    private:
+        struct Slot {
+            std::atomic<const c8 *> name{};
+            std::atomic<u64> startNS{};
+            std::atomic<u64> endNS{};
+        };
+
+        u32 mThreadIdx{};
+        std::unique_ptr<Slot[]> mSlots{};
+        size mCapacity{};
+        // NOTE: Number of samples pushed so far, and the number whose slot the owner has started writing to.
+        std::atomic<u64> mHead{0};
+        std::atomic<u64> mReserved{0};
+    };
+
+    class Profiler {
+    public:
+        static Profiler &
+        get();
+
+        Profiler(const Profiler &) = delete;
+
+        Profiler &
+        operator=(const Profiler &) = delete;
+
+        // NOTE: Zones are only recorded while enabled, when disabled a zone costs a relaxed load.
+        void
+        setEnabled(bool);
+
+        bool
+        isEnabled() const {
+            return mEnabled.load(std::memory_order_relaxed);
+        }
+
+        void
+        record(const c8 *name,
+               u64 startNS,
+               u64 endNS);
+
+        static u64
+        now();
+
+        // NOTE: Chrome trace_event format, open in chrome://tracing or ui.perfetto.dev.
+        bool
+        exportChromeTrace(const std::string &path) const;
+
+        // NOTE: Compact capture, all integers little-endian:
+        //   "ONIP", u32 version, u32 name count, per name: u32 length and the bytes,
+        //   u32 thread count, per thread: u32 thread index, u64 sample count, per sample: u32 name index,
+        //   u64 start ns, u64 end ns.
+        bool
+        exportBinary(const std::string &path) const;
+
+    private:
+        Profiler();
+
+        ProfileThreadBuffer &
+        getThreadBuffer();
+
+        std::vector<std::pair<u32, std::vector<ProfileSample>>>
+        collect() const;
+
+    private:
+        std::atomic<bool> mEnabled{false};
+
+        mutable std::mutex mBuffersMutex{};
+        std::vector<std::unique_ptr<ProfileThreadBuffer>> mBuffers{};
+    };
+
+    class ProfileZone {
+    public:
+        explicit ProfileZone(const c8 *name) : mName(name) {
+            if (Profiler::get().isEnabled()) {
+                mStartNS = Profiler::now();
+            }
+        }
+
+        ~ProfileZone() {
+            // NOTE: Zones that started before the profiler was enabled are skipped.
+            if (mStartNS && Profiler::get().isEnabled()) {
+                Profiler::get().record(mName, mStartNS, Profiler::now());
+            }
+        }
+
+        ProfileZone(const ProfileZone &) = delete;
+
+        ProfileZone &
+        operator=(const ProfileZone &) = delete;
+
+    private:
+        const c8 *mName{};
+        u64 mStartNS{0};
+    };
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+#include <oni-core/common/oni-common-typedef.h>
+
+
+namespace oni {
+    // NOTE: Hands the latest state from one writer thread to one reader thread without either of them ever
+    // waiting on the other. There are three slots, one being written, one being read and the latest published one
+    // in the middle. Publishing and acquiring just swap a slot with the middle one, so the writer can publish
+    // several times while the reader holds on to a slot, only the newest publication survives.
+    template<class T>
+    class SnapshotBuffer {
+    public:
+        SnapshotBuffer() = default;
+
+        SnapshotBuffer(const SnapshotBuffer &) = delete;
+
+        SnapshotBuffer &
+        operator=(const SnapshotBuffer &) = delete;
+
+        // NOTE: Writer side, the slot is owned by the writer until publish().
+        T &
+        back() {
+            return mSlots[mBack];
+        }
+
+        void
+        publish() {
+            auto previous = mMiddle.exchange(static_cast<u8>(mBack | FRESH), std::memory_order_acq_rel);
+            mBack = static_cast<u8>(previous & INDEX_MASK);
+        }
+
+        // NOTE: Reader side, returns true if there was a new publication since the last acquire(), in which case
+        // front() now refers to it. Otherwise front() stays the same.
+        bool
+        acquire() {
+            if (!(mMiddle.load(std::memory_order_acquire) & FRESH)) {
+                return false;
+            }
+            auto previous = mMiddle.exchange(mFront, std::memory_order_acq_rel);
+            mFront = static_cast<u8>(previous & INDEX_MASK);
+            return true;
+        }
+
+        const T &
+        front() const {
+            return mSlots[mFront];
+        }
+
+    private:
+        static constexpr u8 INDEX_MASK = 0x3;
+        static constexpr u8 FRESH = 0x4;
+
+        std::array<T, 3> mSlots{};
+        u8 mFront{0};
+        u8 mBack{1};
+        std::atomic<u8> mMiddle{2};
+    };
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+
+
+namespace oni {
+    using Job = std::function<void()>;
+
+    class ThreadPool {
+    public:
+        // NOTE: The thread calling helpUntil() acts as an extra worker, so a pool with zero workers is valid and
+        // runs everything on the calling thread.
+        explicit ThreadPool(u16 numWorkers);
+
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool &) = delete;
+
+        ThreadPool &
+        operator=(const ThreadPool &) = delete;
+
+        // NOTE: Jobs submitted from a worker go to the back of that worker's own queue, everyone else pushes to
+        // the queue owned by the external threads. Idle workers steal from the front of other queues.
+        void
+        submit(Job &&job);
+
+        // NOTE: Runs and steals jobs on the calling thread until remaining reaches zero.
+        void
+        helpUntil(const std::atomic<u32> &remaining);
+
+        u16
+        getWorkerCount() const;
+
+        // NOTE: hardware_concurrency - 1, leaving one core for the thread that drives the pool.
+        static u16
+        defaultWorkerCount();
+
+    private:
+        struct WorkQueue {
+            std::mutex mutex{};
+            std::deque<Job> jobs{};
+        };
+
+        void
+        work(u16 queueIdx);
+
+        bool
+        popLocal(u16 queueIdx,
+                 Job &job);
+
+        bool
+        steal(u16 queueIdx,
+              Job &job);
+
+        bool
+        findJob(u16 queueIdx,
+                Job &job);
+
+    private:
+        // NOTE: Index 0 is shared by all non-worker threads, worker i owns index i + 1.
+        std::vector<std::unique_ptr<WorkQueue>> mQueues{};
+        std::vector<std::thread> mWorkers{};
+
+        std::mutex mSleepMutex{};
+        std::condition_variable mSleepCV{};
+        std::atomic<u32> mPendingJobs{0};
+        std::atomic<bool> mRunning{true};
+    };
+}
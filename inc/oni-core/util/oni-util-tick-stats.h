@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+#include <oni-core/common/oni-common-typedef.h>
+
+
+namespace oni {
+    struct TickStatsSummary {
+        u64 count{0};
+        u64 p50NS{0};
+        u64 p99NS{0};
+        u64 maxNS{0};
+    };
+
+    // NOTE: Collects per-tick durations over a reporting period and summarizes them as percentiles. Averages hide
+    // the odd slow tick, which is exactly the one players notice.
+    class TickStats {
+    public:
+        explicit TickStats(size expectedSamples);
+
+        void
+        add(u64 durationNS);
+
+        // NOTE: Nearest-rank percentiles over the samples collected since the last reset().
+        TickStatsSummary
+        summarize();
+
+        void
+        reset();
+
+    private:
+        std::vector<u64> mSamples{};
+    };
+}
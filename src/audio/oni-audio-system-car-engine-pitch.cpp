@@ -5,8 +5,8 @@ namespace oni {
 
     void
     System_CarEnginePitch::update(EntityTickContext &etc,
-                                   Car &car,
-                                   Sound &sound,
+                                   const Car &car,
+                                   const Sound &sound,
                                    SoundPitch &pitch) {
         pitch.value = static_cast< r32>(car.rpm) / 2000;
     }
@@ -4,7 +4,10 @@
 
 namespace oni {
     System_PlayPauseSound::System_PlayPauseSound(EntityManager &em,
-                                                 AudioManager &am) : SystemTemplate(em), mAudioMng(am) {}
+                                                 AudioManager &am) : SystemTemplate(em), mAudioMng(am) {
+        declareRead<SoundPitch>();
+        declareWrite(&mAudioMng);
+    }
 
     void
     System_PlayPauseSound::update(EntityTickContext &etc,
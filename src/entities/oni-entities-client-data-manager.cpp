@@ -4,6 +4,7 @@
 #include <cassert>
 
 #include <oni-core/common/oni-common-typedefs-network.h>
+#include <oni-core/entities/oni-entities-replay.h>
 
 
 namespace oni {
@@ -38,7 +39,12 @@ namespace oni {
         mClientToCarEntity[clientID] = entityID;
         mCarEntityToClient[entityID] = clientID;
         mCarEntityToInput[entityID] = Input{};
+        mCarEntityToInputSequence[entityID] = InputSequence{};
         mClients.push_back(clientID);
+
+        if (mRecorder) {
+            mRecorder->recordClientJoined(clientID, entityID);
+        }
     }
 
     void
@@ -46,6 +52,7 @@ namespace oni {
         auto carID = mClientToCarEntity[clientID];
         if (carID) {
             mCarEntityToInput.erase(carID);
+            mCarEntityToInputSequence.erase(carID);
             mClientToCarEntity.erase(clientID);
         }
 
@@ -56,14 +63,59 @@ namespace oni {
         } else {
             assert(false);
         }
+
+        if (mRecorder) {
+            mRecorder->recordClientLeft(clientID);
+        }
     }
 
     void
     ClientDataManager::setClientInput(const std::string &clientID,
-                                      const Input &input) {
+                                      const Input &input,
+                                      u32 sequence) {
         auto carID = mClientToCarEntity[clientID];
         if (carID) {
             mCarEntityToInput[carID] = input;
+            mCarEntityToInputSequence[carID].received = sequence;
+            if (mRecorder) {
+                mRecorder->recordInput(clientID, input);
+            }
+        }
+    }
+
+    void
+    ClientDataManager::markInputApplied(EntityID entityID) {
+        auto sequence = mCarEntityToInputSequence.find(entityID);
+        if (sequence == mCarEntityToInputSequence.end()) {
+            return;
+        }
+        // NOTE: Clients that don't predict send 0, there is nothing to acknowledge
+        if (sequence->second.received) {
+            sequence->second.applied = sequence->second.received;
+        }
+    }
+
+    u32
+    ClientDataManager::getAppliedInputSequence(const std::string &clientID) const {
+        auto carID = mClientToCarEntity.find(clientID);
+        if (carID == mClientToCarEntity.end()) {
+            return 0;
+        }
+        auto sequence = mCarEntityToInputSequence.find(carID->second);
+        if (sequence == mCarEntityToInputSequence.end()) {
+            return 0;
+        }
+        return sequence->second.applied;
+    }
+
+    void
+    ClientDataManager::setRecorder(ReplayRecorder *recorder) {
+        mRecorder = recorder;
+        if (!mRecorder) {
+            return;
+        }
+        for (const auto &client: mClientToCarEntity) {
+            mRecorder->recordClientJoined(client.first, client.second);
         }
     }
 
@@ -76,6 +128,11 @@ namespace oni {
         return entities;
     }
 
+    const ClientToCarEntity &
+    ClientDataManager::getClientCarEntities() const {
+        return mClientToCarEntity;
+    }
+
     size_t
     ClientDataManager::getNumClients() const {
         return mClients.size();
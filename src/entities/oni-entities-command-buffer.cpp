@@ -0,0 +1,150 @@
+#include <oni-core/entities/oni-entities-command-buffer.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+#include <oni-core/entities/oni-entities-manager.h>
+
+
+namespace {
+    constexpr oni::size COMMAND_BLOCK_SIZE = 16 * 1024;
+}
+
+namespace oni {
+    struct EntityCommandBuffer::Command_Create : public Command {
+        Command_Create(u32 index_,
+                       bool named_,
+                       const EntityName &name_) : index(index_), named(named_), name(name_) {}
+
+        static void
+        run(Command &base,
+            PlaybackContext &ctx) {
+            auto &cmd = static_cast<Command_Create &>(base);
+            // NOTE: ctx.created is sized up front, so pending entities can be referenced by their index.
+            auto &created = ctx.created;
+            if (cmd.named) {
+                created[cmd.index] = ctx.mng.createEntity(cmd.name);
+            } else {
+                created[cmd.index] = ctx.mng.createEntity();
+            }
+        }
+
+        u32 index{};
+        bool named{false};
+        EntityName name{};
+    };
+
+    struct EntityCommandBuffer::Command_Destroy : public Command {
+        explicit Command_Destroy(EntityID id_) : id(id_) {}
+
+        static void
+        run(Command &base,
+            PlaybackContext &ctx) {
+            auto &cmd = static_cast<Command_Destroy &>(base);
+            // NOTE: Duplicates and children that were already taken down with their parent end up here.
+            if (ctx.registry.valid(cmd.id)) {
+                ctx.mng.deleteEntity(cmd.id, ctx.policy);
+            }
+        }
+
+        EntityID id{};
+    };
+
+    EntityCommandBuffer::EntityCommandBuffer() = default;
+
+    EntityCommandBuffer::~EntityCommandBuffer() {
+        clear();
+    }
+
+    EntityCommandBuffer::PendingEntity
+    EntityCommandBuffer::create() {
+        auto index = mPendingCount++;
+        push<Command_Create>(index, false, EntityName{});
+        return {index};
+    }
+
+    EntityCommandBuffer::PendingEntity
+    EntityCommandBuffer::create(const EntityName &name) {
+        auto index = mPendingCount++;
+        push<Command_Create>(index, true, name);
+        return {index};
+    }
+
+    void
+    EntityCommandBuffer::destroy(EntityID id) {
+        push<Command_Destroy>(id);
+    }
+
+    bool
+    EntityCommandBuffer::empty() const {
+        return !mHead;
+    }
+
+    void
+    EntityCommandBuffer::playback(EntityManager &mng,
+                                  const EntityOperationPolicy &policy) {
+        if (empty()) {
+            return;
+        }
+
+        mCreated.assign(mPendingCount, EntityManager::nullEntity());
+        auto ctx = PlaybackContext{mng, *mng.mRegistry, policy, mCreated};
+        for (auto *cmd = mHead; cmd; cmd = cmd->next) {
+            cmd->apply(*cmd, ctx);
+        }
+
+        clear();
+    }
+
+    void
+    EntityCommandBuffer::clear() {
+        for (auto *cmd = mHead; cmd;) {
+            auto *next = cmd->next;
+            if (cmd->dispose) {
+                cmd->dispose(*cmd);
+            }
+            cmd = next;
+        }
+
+        mHead = nullptr;
+        mTail = nullptr;
+        mBlockIdx = 0;
+        mOffset = 0;
+        mPendingCount = 0;
+    }
+
+    void *
+    EntityCommandBuffer::allocate(size bytes,
+                                  size alignment) {
+        assert(alignment <= alignof(std::max_align_t));
+
+        while (true) {
+            if (mBlockIdx == mBlocks.size()) {
+                auto capacity = std::max(COMMAND_BLOCK_SIZE, bytes);
+                mBlocks.push_back({std::make_unique<u8[]>(capacity), capacity});
+            }
+
+            auto &block = mBlocks[mBlockIdx];
+            auto offset = (mOffset + alignment - 1) & ~(alignment - 1);
+            if (offset + bytes <= block.capacity) {
+                mOffset = offset + bytes;
+                return block.data.get() + offset;
+            }
+
+            // NOTE: Blocks are never resized or freed until destruction, handed out references stay valid.
+            ++mBlockIdx;
+            mOffset = 0;
+        }
+    }
+
+    void
+    EntityCommandBuffer::link(Command *cmd) {
+        if (mTail) {
+            mTail->next = cmd;
+        } else {
+            mHead = cmd;
+        }
+        mTail = cmd;
+    }
+}
@@ -24,8 +24,9 @@ namespace oni {
         for (auto i = 0; i < NumEventDispatcher; ++i) {
             mDispatcher[i] = std::make_unique<entt::dispatcher>();
         }
-        mRand = std::make_unique<Rand>(0, 0);
+        mRand = std::make_unique<Rand>(makeRandStream(RandStream::ENTITIES));
         mEventRateLimiter = std::make_unique<EventRateLimiter>();
+        mCommandBuffer = std::make_unique<EntityCommandBuffer>();
 
         switch (sMode) {
             case SimMode::CLIENT: {
@@ -149,6 +150,10 @@ namespace oni {
 
     void
     EntityManager::markForNetSync(EntityID entity) {
+        if (isDeferring()) {
+            tDeferred.buffer->invoke([this, entity]() { markForNetSync(entity); });
+            return;
+        }
         if (mEntityOperationPolicy.track) {
             assert(mSimMode == SimMode::SERVER);
             accommodate<Tag_NetworkSyncComponent>(entity);
@@ -164,7 +169,7 @@ namespace oni {
     void
     EntityManager::dispatchEventsAndFlush(EventDispatcherType type) {
         dispatchEvents(type);
-        flushDeletions();
+        flushCommands();
     }
 
     void
@@ -186,25 +191,77 @@ namespace oni {
 
     void
     EntityManager::markForDeletion(EntityID id) {
-        mEntitiesToDelete.emplace(id);
+        getCommandBuffer().destroy(id);
+    }
+
+    EntityCommandBuffer &
+    EntityManager::getCommandBuffer() {
+        if (isDeferring()) {
+            return *tDeferred.flushBuffer;
+        }
+        return *mCommandBuffer;
     }
 
     void
-    EntityManager::flushDeletions() {
-        for (auto &&i : mEntitiesToDelete) {
-            deleteEntity(i);
+    EntityManager::queueCommandBuffer(std::unique_ptr<EntityCommandBuffer> &&buffer) {
+        assert(buffer);
+        if (buffer->empty()) {
+            releaseCommandBuffer(std::move(buffer));
+            return;
+        }
+        // NOTE: What was recorded before goes first, a fresh buffer takes the commands recorded from here on
+        if (!mCommandBuffer->empty()) {
+            mQueuedCommandBuffers.push_back(std::move(mCommandBuffer));
+            mCommandBuffer = acquireCommandBuffer();
         }
+        mQueuedCommandBuffers.push_back(std::move(buffer));
+    }
 
-        mEntitiesToDelete.clear();
+    std::unique_ptr<EntityCommandBuffer>
+    EntityManager::acquireCommandBuffer() {
+        auto lock = std::lock_guard<std::mutex>(mCommandBufferMutex);
+        if (mFreeCommandBuffers.empty()) {
+            return std::make_unique<EntityCommandBuffer>();
+        }
+        auto buffer = std::move(mFreeCommandBuffers.back());
+        mFreeCommandBuffers.pop_back();
+        return buffer;
     }
 
     void
-    EntityManager::flushDeletions(const EntityOperationPolicy &policy) {
-        for (auto &&i : mEntitiesToDelete) {
-            deleteEntity(i, policy);
-        }
+    EntityManager::releaseCommandBuffer(std::unique_ptr<EntityCommandBuffer> &&buffer) {
+        assert(buffer);
+        buffer->clear();
+        auto lock = std::lock_guard<std::mutex>(mCommandBufferMutex);
+        mFreeCommandBuffers.push_back(std::move(buffer));
+    }
 
-        mEntitiesToDelete.clear();
+    void
+    EntityManager::playback(EntityCommandBuffer &buffer) {
+        playback(buffer, mEntityOperationPolicy);
+    }
+
+    void
+    EntityManager::playback(EntityCommandBuffer &buffer,
+                            const EntityOperationPolicy &policy) {
+        // NOTE: Playing back from inside a parallel update would change the registry under the other chunks.
+        assert(!isDeferring());
+        buffer.playback(*this, policy);
+    }
+
+    void
+    EntityManager::flushCommands() {
+        flushCommands(mEntityOperationPolicy);
+    }
+
+    void
+    EntityManager::flushCommands(const EntityOperationPolicy &policy) {
+        for (auto &&buffer: mQueuedCommandBuffers) {
+            playback(*buffer, policy);
+            releaseCommandBuffer(std::move(buffer));
+        }
+        mQueuedCommandBuffers.clear();
+        playback(*mCommandBuffer, policy);
     }
 
     EntityID
@@ -494,6 +551,11 @@ namespace oni {
         return mSimMode;
     }
 
+    void
+    EntityManager::setThreadPool(ThreadPool *pool) {
+        mThreadPool = pool;
+    }
+
     Rand *
     EntityManager::getRand() {
         return mRand.get();
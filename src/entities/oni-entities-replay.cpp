@@ -0,0 +1,327 @@
+#include <oni-core/entities/oni-entities-replay.h>
+
+#include <cassert>
+#include <cstdio>
+
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <oni-core/entities/oni-entities-serialization-network-archive.h>
+
+
+namespace {
+    constexpr oni::u32 REPLAY_VERSION = 2;
+    constexpr oni::c8 RECORD_WORLD = 'W';
+    constexpr oni::c8 RECORD_TICK = 'T';
+    // NOTE: Sanity limit for a single record, a corrupt length shouldn't allocate gigabytes.
+    constexpr oni::u32 MAX_RECORD_SIZE = 1u << 30;
+
+    std::string
+    serializeInput(const oni::Input &input) {
+        auto storage = std::ostringstream{};
+        {
+            oni::NetworkOutputArchive output{storage};
+            output(const_cast<oni::Input &>(input));
+        }
+        return storage.str();
+    }
+
+    void
+    writeU32(std::ostream &out,
+             oni::u32 value) {
+        for (oni::size i = 0; i < sizeof(value); ++i) {
+            out.put(static_cast<oni::c8>((value >> (i * 8)) & 0xFF));
+        }
+    }
+
+    bool
+    readU32(std::istream &in,
+            oni::u32 &value) {
+        oni::u8 bytes[4];
+        if (!in.read(reinterpret_cast<oni::c8 *>(bytes), sizeof(bytes))) {
+            return false;
+        }
+        value = bytes[0] | (bytes[1] << 8u) | (bytes[2] << 16u) | (oni::u32{bytes[3]} << 24u);
+        return true;
+    }
+}
+
+namespace oni {
+    ReplayRecorder::ReplayRecorder() = default;
+
+    ReplayRecorder::~ReplayRecorder() {
+        close();
+    }
+
+    bool
+    ReplayRecorder::open(const std::string &path,
+                         u64 randMasterSeed) {
+        close();
+        mOut.open(path, std::ios::binary | std::ios::trunc);
+        if (!mOut) {
+            printf("Failed to open replay file: %s\n", path.c_str());
+            return false;
+        }
+        mOut.write("ONIR", 4);
+        writeU32(mOut, REPLAY_VERSION);
+        writeU32(mOut, static_cast<u32>(randMasterSeed));
+        writeU32(mOut, static_cast<u32>(randMasterSeed >> 32u));
+
+        mWorldRecorded = false;
+        mTicks = 0;
+        mClients.clear();
+        mClientIDs.clear();
+        mLastInput.clear();
+        mEvents.clear();
+        return true;
+    }
+
+    void
+    ReplayRecorder::close() {
+        if (mOut.is_open()) {
+            mOut.close();
+        }
+    }
+
+    bool
+    ReplayRecorder::isOpen() const {
+        return mOut.is_open();
+    }
+
+    void
+    ReplayRecorder::recordWorld(const std::string &registry) {
+        assert(!mWorldRecorded);
+        writeRecord(RECORD_WORLD, registry);
+        mWorldRecorded = true;
+    }
+
+    u32
+    ReplayRecorder::clientIndex(const std::string &clientID,
+                                bool &newClient) {
+        auto result = mClients.emplace(clientID, static_cast<u32>(mClientIDs.size()));
+        newClient = result.second;
+        if (newClient) {
+            mClientIDs.push_back(clientID);
+            mLastInput.emplace_back();
+        }
+        return result.first->second;
+    }
+
+    void
+    ReplayRecorder::recordClientJoined(const std::string &clientID,
+                                       EntityID carEntity) {
+        auto event = PendingEvent{ReplayEventType::CLIENT_JOINED};
+        event.client = clientIndex(clientID, event.newClient);
+        event.carEntity = carEntity;
+        mEvents.push_back(event);
+    }
+
+    void
+    ReplayRecorder::recordClientLeft(const std::string &clientID) {
+        auto event = PendingEvent{ReplayEventType::CLIENT_LEFT};
+        event.client = clientIndex(clientID, event.newClient);
+        mEvents.push_back(event);
+    }
+
+    void
+    ReplayRecorder::recordInput(const std::string &clientID,
+                                const Input &input) {
+        auto event = PendingEvent{ReplayEventType::CLIENT_INPUT};
+        event.client = clientIndex(clientID, event.newClient);
+        mEvents.push_back(event);
+        mPendingInputs.push_back(serializeInput(input));
+    }
+
+    void
+    ReplayRecorder::endTick(r64 dt) {
+        if (!isOpen()) {
+            return;
+        }
+        assert(mWorldRecorded);
+
+        mPayload.str({});
+        {
+            NetworkOutputArchive output{mPayload};
+            output.saveR64(dt);
+            output.saveVarBits(mEvents.size());
+
+            auto input = mPendingInputs.begin();
+            for (auto &&event: mEvents) {
+                output.saveBits(enumCast(event.type), 2);
+                output.saveVarBits(event.client);
+                output.saveBits(event.newClient, 1);
+                if (event.newClient) {
+                    output(mClientIDs[event.client]);
+                }
+                switch (event.type) {
+                    case ReplayEventType::CLIENT_JOINED: {
+                        output.saveVarBits(event.carEntity);
+                        break;
+                    }
+                    case ReplayEventType::CLIENT_INPUT: {
+                        auto &bytes = *input++;
+                        auto &last = mLastInput[event.client];
+                        auto same = bytes == last;
+                        output.saveBits(same, 1);
+                        if (!same) {
+                            output(bytes);
+                            last = std::move(bytes);
+                        }
+                        break;
+                    }
+                    default: {
+                        break;
+                    }
+                }
+            }
+        }
+        writeRecord(RECORD_TICK, mPayload.str());
+        mOut.flush();
+
+        mEvents.clear();
+        mPendingInputs.clear();
+        ++mTicks;
+    }
+
+    void
+    ReplayRecorder::writeRecord(c8 kind,
+                                const std::string &payload) {
+        if (!isOpen()) {
+            return;
+        }
+        mOut.put(kind);
+        writeU32(mOut, static_cast<u32>(payload.size()));
+        mOut.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    }
+
+    u64
+    ReplayRecorder::getTickCount() const {
+        return mTicks;
+    }
+}
+
+namespace oni {
+    bool
+    ReplayReader::open(const std::string &path) {
+        mIn = std::ifstream(path, std::ios::binary);
+        mTicks = 0;
+        mRandMasterSeed = 0;
+        mClientIDs.clear();
+        mLastInput.clear();
+        if (!mIn) {
+            printf("Failed to open replay file: %s\n", path.c_str());
+            return false;
+        }
+
+        c8 magic[4];
+        auto version = u32{};
+        auto seedLow = u32{};
+        auto seedHigh = u32{};
+        if (!mIn.read(magic, sizeof(magic)) || std::string(magic, sizeof(magic)) != "ONIR" ||
+            !readU32(mIn, version) || version != REPLAY_VERSION ||
+            !readU32(mIn, seedLow) || !readU32(mIn, seedHigh)) {
+            printf("Not a replay file or unsupported version: %s\n", path.c_str());
+            return false;
+        }
+        mRandMasterSeed = seedLow | (u64{seedHigh} << 32u);
+
+        auto kind = c8{};
+        if (!readRecord(kind, mWorld) || kind != RECORD_WORLD) {
+            printf("Replay file doesn't start with the world: %s\n", path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    const std::string &
+    ReplayReader::getWorld() const {
+        return mWorld;
+    }
+
+    u64
+    ReplayReader::getRandMasterSeed() const {
+        return mRandMasterSeed;
+    }
+
+    bool
+    ReplayReader::readRecord(c8 &kind,
+                             std::string &payload) {
+        auto length = u32{};
+        if (!mIn.get(kind) || !readU32(mIn, length) || length > MAX_RECORD_SIZE) {
+            return false;
+        }
+        payload.resize(length);
+        return static_cast<bool>(mIn.read(payload.data(), length));
+    }
+
+    bool
+    ReplayReader::next(ReplayTick &tick) {
+        auto kind = c8{};
+        if (!readRecord(kind, mPayload) || kind != RECORD_TICK) {
+            return false;
+        }
+
+        try {
+            NetworkInputArchive input{mPayload.data(), mPayload.size()};
+            tick.dt = input.loadR64();
+            auto count = input.loadVarBits();
+            // NOTE: Every event takes at least a few bits
+            if (count > input.getBitsLeft()) {
+                return false;
+            }
+            tick.events.resize(count);
+
+            for (auto &&event: tick.events) {
+                auto type = input.loadBits(2);
+                if (type >= enumCast(ReplayEventType::LAST)) {
+                    return false;
+                }
+                event.type = static_cast<ReplayEventType>(type);
+
+                auto client = input.loadVarBits();
+                if (input.loadBits(1)) {
+                    if (client != mClientIDs.size()) {
+                        return false;
+                    }
+                    mClientIDs.emplace_back();
+                    mLastInput.emplace_back();
+                    input(mClientIDs.back());
+                } else if (client >= mClientIDs.size()) {
+                    return false;
+                }
+                event.clientID = mClientIDs[client];
+
+                switch (event.type) {
+                    case ReplayEventType::CLIENT_JOINED: {
+                        event.carEntity = static_cast<EntityID>(input.loadVarBits());
+                        break;
+                    }
+                    case ReplayEventType::CLIENT_INPUT: {
+                        auto &last = mLastInput[client];
+                        if (!input.loadBits(1)) {
+                            input(last);
+                        }
+                        NetworkInputArchive inputArchive{last.data(), last.size()};
+                        event.input = {};
+                        inputArchive(event.input);
+                        break;
+                    }
+                    default: {
+                        break;
+                    }
+                }
+            }
+        } catch (const cereal::Exception &e) {
+            printf("Corrupt replay tick %llu: %s\n", static_cast<unsigned long long>(mTicks), e.what());
+            return false;
+        }
+
+        ++mTicks;
+        return true;
+    }
+
+    u64
+    ReplayReader::getTickCount() const {
+        return mTicks;
+    }
+}
@@ -0,0 +1,160 @@
+#include <oni-core/entities/oni-entities-serialization-network-archive.h>
+
+#include <cmath>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+
+namespace oni {
+    NetworkOutputArchive::NetworkOutputArchive(std::ostream &stream,
+                                               const NetworkPrecision &precision) :
+            cereal::OutputArchive<NetworkOutputArchive, cereal::AllowEmptyClassElision>(this),
+            mStream(stream),
+            mPrecision(precision) {}
+
+    NetworkOutputArchive::~NetworkOutputArchive() CEREAL_NOEXCEPT {
+        mWriter.finish();
+        const auto &data = mWriter.getData();
+        mStream.write(reinterpret_cast<const c8 *>(data.data()), static_cast<std::streamsize>(data.size()));
+    }
+
+    void
+    NetworkOutputArchive::saveBits(u32 value,
+                                   u8 bits) {
+        mWriter.write(value, bits);
+    }
+
+    void
+    NetworkOutputArchive::saveVarBits(u64 value) {
+        // NOTE: Most values fit in 32 bits, those only pay a bit for the flag.
+        auto wide = value > std::numeric_limits<u32>::max();
+        mWriter.writeBit(wide);
+        if (wide) {
+            mWriter.writeVarBits(static_cast<u32>(value >> 32));
+            mWriter.write(static_cast<u32>(value), 32);
+        } else {
+            mWriter.writeVarBits(static_cast<u32>(value));
+        }
+    }
+
+    void
+    NetworkOutputArchive::saveR32(r32 value) {
+        auto bits = u32{};
+        std::memcpy(&bits, &value, sizeof(bits));
+        mWriter.write(bits, 32);
+    }
+
+    void
+    NetworkOutputArchive::saveR64(r64 value) {
+        auto bits = u64{};
+        std::memcpy(&bits, &value, sizeof(bits));
+        mWriter.write(static_cast<u32>(bits), 32);
+        mWriter.write(static_cast<u32>(bits >> 32), 32);
+    }
+
+    void
+    NetworkOutputArchive::saveQuantized(r32 value,
+                                        r32 step) {
+        if (step <= 0.f) {
+            saveR32(value);
+            return;
+        }
+
+        auto scaled = std::round(static_cast<r64>(value) / step);
+        auto quantized = i64{0};
+        if (scaled >= std::numeric_limits<i32>::max()) {
+            quantized = std::numeric_limits<i32>::max();
+        } else if (scaled <= std::numeric_limits<i32>::min()) {
+            quantized = std::numeric_limits<i32>::min();
+        } else if (std::isfinite(scaled)) {
+            quantized = static_cast<i64>(scaled);
+        }
+        // NOTE: Always fits 32 bits after clamping
+        mWriter.writeVarBits(static_cast<u32>(detail::zigzagEncode(quantized)));
+    }
+
+    const NetworkPrecision &
+    NetworkOutputArchive::getPrecision() const {
+        return mPrecision;
+    }
+
+    NetworkInputArchive::NetworkInputArchive(const void *data,
+                                             size size,
+                                             const NetworkPrecision &precision) :
+            cereal::InputArchive<NetworkInputArchive, cereal::AllowEmptyClassElision>(this),
+            mReader(static_cast<const u8 *>(data), size),
+            mPrecision(precision) {}
+
+    NetworkInputArchive::NetworkInputArchive(std::istream &stream,
+                                             const NetworkPrecision &precision) :
+            cereal::InputArchive<NetworkInputArchive, cereal::AllowEmptyClassElision>(this),
+            mStorage(std::istreambuf_iterator<c8>(stream), std::istreambuf_iterator<c8>()),
+            mReader(mStorage.data(), mStorage.size()),
+            mPrecision(precision) {}
+
+    void
+    NetworkInputArchive::check() const {
+        if (!mReader.good()) {
+            throw cereal::Exception("Read past the end of the network archive");
+        }
+    }
+
+    u32
+    NetworkInputArchive::loadBits(u8 bits) {
+        auto result = mReader.read(bits);
+        check();
+        return result;
+    }
+
+    u64
+    NetworkInputArchive::loadVarBits() {
+        auto wide = mReader.readBit();
+        auto result = u64{0};
+        if (wide) {
+            result = u64{mReader.readVarBits()} << 32;
+            result |= mReader.read(32);
+        } else {
+            result = mReader.readVarBits();
+        }
+        check();
+        return result;
+    }
+
+    r32
+    NetworkInputArchive::loadR32() {
+        auto bits = loadBits(32);
+        auto result = r32{};
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    r64
+    NetworkInputArchive::loadR64() {
+        auto bits = u64{loadBits(32)};
+        bits |= u64{loadBits(32)} << 32;
+        auto result = r64{};
+        std::memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    r32
+    NetworkInputArchive::loadQuantized(r32 step) {
+        if (step <= 0.f) {
+            return loadR32();
+        }
+        auto quantized = detail::zigzagDecode(mReader.readVarBits());
+        check();
+        return static_cast<r32>(quantized * static_cast<r64>(step));
+    }
+
+    size
+    NetworkInputArchive::getBitsLeft() const {
+        return mReader.getBitsLeft();
+    }
+
+    const NetworkPrecision &
+    NetworkInputArchive::getPrecision() const {
+        return mPrecision;
+    }
+}
@@ -0,0 +1,276 @@
+#include <oni-core/game/oni-game-server.h>
+
+#include <cassert>
+#include <cerrno>
+#include <cstdio>
+#include <thread>
+
+#include <oni-core/entities/oni-entities-client-data-manager.h>
+#include <oni-core/entities/oni-entities-replay.h>
+#include <oni-core/math/oni-math-rand.h>
+#include <oni-core/util/oni-util-profiler.h>
+
+#if defined(__linux__)
+
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#endif
+
+
+namespace oni {
+    ServerGame::ServerGame(u16 tickRate) :
+            mTickS(1.f / tickRate),
+            // NOTE: One second worth of ticks, plus a bit of slack for a late report.
+            mTickTime(tickRate + tickRate / 4),
+            mWakeLateness(tickRate + tickRate / 4) {
+        assert(tickRate);
+    }
+
+    ServerGame::~ServerGame() = default;
+
+    r32
+    ServerGame::getTickFrequency() const {
+        return mTickS;
+    }
+
+    void
+    ServerGame::setPacing(TickPacing pacing) {
+        mPacing = pacing;
+    }
+
+    void
+    ServerGame::setSpinThreshold(std::chrono::microseconds threshold) {
+        mSpinThreshold = threshold;
+    }
+
+    void
+    ServerGame::setSimCore(i32 core) {
+        mSimCore = core;
+    }
+
+    void
+    ServerGame::setClientDataManager(ClientDataManager &cdm) {
+        mClientDataMng = &cdm;
+    }
+
+    void
+    ServerGame::setRecording(const std::string &path) {
+        mRecordingPath = path;
+    }
+
+    void
+    ServerGame::initSystems() {}
+
+    bool
+    ServerGame::_saveWorld(std::string &) {
+        return false;
+    }
+
+    bool
+    ServerGame::_restoreWorld(const std::string &) {
+        return false;
+    }
+
+    void
+    ServerGame::showTickStats(const TickStatsSummary &,
+                              const TickStatsSummary &,
+                              u64) {}
+
+    void
+    ServerGame::run() {
+        pinToCore();
+        initSystems();
+        startRecording();
+
+        auto tick = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<r64>(mTickS));
+        auto deadline = Timer::now();
+        mReportTimer.restart();
+
+        while (!shouldTerminate()) {
+            auto start = Timer::now();
+            mWakeLateness.add(static_cast<u64>(std::chrono::nanoseconds(start - deadline).count()));
+
+            {
+                ONI_PROFILE_ZONE("ServerGame::tick");
+                _poll();
+                _sim(mTickS);
+                _finish();
+                if (mRecorder) {
+                    mRecorder->endTick(mTickS);
+                }
+            }
+
+            auto end = Timer::now();
+            mTickTime.add(static_cast<u64>(std::chrono::nanoseconds(end - start).count()));
+
+            deadline += tick;
+            if (end > deadline) {
+                // NOTE: Missed the next deadline already, start over from now instead of bursting ticks back to
+                // back to catch up.
+                ++mOverruns;
+                deadline = end;
+            } else {
+                waitUntil(deadline);
+            }
+
+            if (mReportTimer.elapsedInSeconds() >= 1.0) {
+                showTickStats(mTickTime.summarize(), mWakeLateness.summarize(), mOverruns);
+                mTickTime.reset();
+                mWakeLateness.reset();
+                mOverruns = 0;
+                mReportTimer.restart();
+            }
+        }
+
+        stopRecording();
+    }
+
+    r64
+    ServerGame::runReplay(const std::string &path) {
+        assert(mClientDataMng);
+        pinToCore();
+
+        auto reader = ReplayReader{};
+        if (!reader.open(path)) {
+            printf("Failed to load replay: %s\n", path.c_str());
+            return 0;
+        }
+        setRandMasterSeed(reader.getRandMasterSeed());
+        initSystems();
+
+        if (!_restoreWorld(reader.getWorld())) {
+            printf("Failed to load replay: %s\n", path.c_str());
+            return 0;
+        }
+
+        auto ticks = u64{0};
+        auto tick = ReplayTick{};
+        auto timer = Timer{};
+        while (reader.next(tick)) {
+            ONI_PROFILE_ZONE("ServerGame::replayTick");
+            applyReplayTick(tick);
+            _sim(tick.dt);
+            _finish();
+            ++ticks;
+        }
+
+        auto elapsed = timer.elapsedInSeconds();
+        auto ticksPerSecond = elapsed > 0 ? ticks / elapsed : 0;
+        printf("Replayed %llu ticks in %.2fs, %.0f ticks/s\n", static_cast<unsigned long long>(ticks), elapsed,
+               ticksPerSecond);
+        return ticksPerSecond;
+    }
+
+    void
+    ServerGame::startRecording() {
+        if (mRecordingPath.empty()) {
+            return;
+        }
+        assert(mClientDataMng);
+
+        auto registry = std::string{};
+        if (!_saveWorld(registry)) {
+            printf("Recording needs _saveWorld(), not recording: %s\n", mRecordingPath.c_str());
+            return;
+        }
+
+        mRecorder = std::make_unique<ReplayRecorder>();
+        if (!mRecorder->open(mRecordingPath, getRandMasterSeed())) {
+            mRecorder.reset();
+            return;
+        }
+        mRecorder->recordWorld(registry);
+        // NOTE: Clients that are already in are recorded as joins of the first tick
+        mClientDataMng->setRecorder(mRecorder.get());
+    }
+
+    void
+    ServerGame::stopRecording() {
+        if (!mRecorder) {
+            return;
+        }
+        mClientDataMng->setRecorder(nullptr);
+        mRecorder->close();
+        mRecorder.reset();
+    }
+
+    void
+    ServerGame::applyReplayTick(const ReplayTick &tick) {
+        // NOTE: Same calls _poll() made when recording, in the same order
+        for (auto &&event: tick.events) {
+            switch (event.type) {
+                case ReplayEventType::CLIENT_JOINED: {
+                    mClientDataMng->addNewClient(event.clientID, event.carEntity);
+                    break;
+                }
+                case ReplayEventType::CLIENT_LEFT: {
+                    mClientDataMng->deleteClient(event.clientID);
+                    break;
+                }
+                case ReplayEventType::CLIENT_INPUT: {
+                    mClientDataMng->setClientInput(event.clientID, event.input);
+                    break;
+                }
+                default: {
+                    assert(false);
+                    break;
+                }
+            }
+        }
+    }
+
+    void
+    ServerGame::pinToCore() {
+        if (mSimCore < 0) {
+            return;
+        }
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(mSimCore, &set);
+        auto result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (result) {
+            printf("Failed to pin sim thread to core %d, error: %d\n", mSimCore, result);
+        }
+#else
+        printf("Pinning sim thread to a core is not supported on this platform\n");
+#endif
+    }
+
+    void
+    ServerGame::waitUntil(std::chrono::steady_clock::time_point deadline) {
+        switch (mPacing) {
+            case TickPacing::SLEEP: {
+                std::this_thread::sleep_until(deadline);
+                break;
+            }
+            case TickPacing::ABSOLUTE_DEADLINE: {
+#if defined(__linux__)
+                // NOTE: steady_clock is CLOCK_MONOTONIC on Linux, so the time point can be handed over as is.
+                auto sinceEpoch = std::chrono::nanoseconds(deadline.time_since_epoch()).count();
+                auto ts = timespec{};
+                ts.tv_sec = sinceEpoch / 1000000000;
+                ts.tv_nsec = sinceEpoch % 1000000000;
+                while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+                break;
+#endif
+                // NOTE: Fall through to HYBRID_SPIN
+            }
+            case TickPacing::HYBRID_SPIN: {
+                auto sleepUntil = deadline - mSpinThreshold;
+                if (Timer::now() < sleepUntil) {
+                    std::this_thread::sleep_until(sleepUntil);
+                }
+                while (Timer::now() < deadline) {}
+                break;
+            }
+            default: {
+                assert(false);
+                break;
+            }
+        }
+    }
+}
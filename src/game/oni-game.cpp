@@ -1,9 +1,13 @@
 #include <oni-core/game/oni-game.h>
 
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <thread>
 
 #include <oni-core/util/oni-util-timer.h>
 #include <oni-core/common/oni-common-const.h>
+#include <oni-core/util/oni-util-profiler.h>
 
 
 namespace oni {
@@ -20,6 +24,28 @@ namespace oni {
         return mTickS;
     }
 
+    void
+    Game::setLoopMode(GameLoopMode mode) {
+        assert(!mRenderThreadRunning);
+        mLoopMode = mode;
+    }
+
+    void
+    Game::setMaxSimStepsPerFrame(u8 steps) {
+        assert(steps);
+        mMaxSimStepsPerFrame = steps;
+    }
+
+    r32
+    Game::getRenderAlpha() const {
+        return mRenderAlpha;
+    }
+
+    r64
+    Game::getDroppedSimTime() const {
+        return mDroppedSimTime;
+    }
+
     void
     Game::initRenderer() {}
 
@@ -30,6 +56,29 @@ namespace oni {
     Game::run() {
         initRenderer();
         initSystems();
+
+        switch (mLoopMode) {
+            case GameLoopMode::LOCKSTEP: {
+                runLockstep();
+                break;
+            }
+            case GameLoopMode::FIXED_STEP: {
+                runFixedStep();
+                break;
+            }
+            case GameLoopMode::FIXED_STEP_RENDER_THREAD: {
+                runFixedStepRenderThread();
+                break;
+            }
+            default: {
+                assert(false);
+                break;
+            }
+        }
+    }
+
+    void
+    Game::runLockstep() {
         auto dt = std::chrono::microseconds(static_cast<u64>(mTickS * 1000 * 1000));
 
         while (!shouldTerminate()) {
@@ -47,6 +96,104 @@ namespace oni {
         }
     }
 
+    void
+    Game::runFixedStep() {
+        auto frameTimer = Timer{};
+        auto accumulator = r64{0};
+
+        while (!shouldTerminate()) {
+            accumulator += frameTimer.elapsedInSeconds();
+            frameTimer.restart();
+
+            poll();
+            auto steps = stepSim(accumulator);
+            if (steps) {
+                _publish();
+            }
+
+            mRenderAlpha = static_cast<r32>(accumulator / mTickS);
+            render();
+
+            // NOTE: Input is only consumed by sim, keep collecting it over frames that had no sim step.
+            if (steps) {
+                finish();
+            }
+            display();
+        }
+    }
+
+    void
+    Game::runFixedStepRenderThread() {
+        _detachRenderContext();
+        mRenderThreadRunning = true;
+        mRenderThread = std::thread(&Game::renderLoop, this);
+
+        auto frameTimer = Timer{};
+        auto accumulator = r64{0};
+
+        while (!shouldTerminate()) {
+            accumulator += frameTimer.elapsedInSeconds();
+            frameTimer.restart();
+
+            poll();
+            auto steps = stepSim(accumulator);
+            if (steps) {
+                _publish();
+                mLastPublishNS = Timer::now().time_since_epoch().count();
+                finish();
+            }
+
+            // NOTE: Sleep until the next step is due, render keeps going on its own thread meanwhile.
+            auto untilNextStep = mTickS - accumulator;
+            if (untilNextStep > 0) {
+                std::this_thread::sleep_for(std::chrono::duration<r64>(untilNextStep));
+            }
+        }
+
+        mRenderThreadRunning = false;
+        mRenderThread.join();
+        _attachRenderContext();
+    }
+
+    void
+    Game::renderLoop() {
+        _attachRenderContext();
+
+        while (mRenderThreadRunning) {
+            auto sincePublishNS = Timer::now().time_since_epoch().count() - mLastPublishNS.load();
+            auto alpha = static_cast<r32>(sincePublishNS * 1e-9 / mTickS);
+            // NOTE: Past 1 sim is late, hold the latest state instead of extrapolating.
+            mRenderAlpha = std::clamp(alpha, 0.f, 1.f);
+
+            render();
+            display();
+        }
+
+        _detachRenderContext();
+    }
+
+    u8
+    Game::stepSim(r64 &accumulator) {
+        auto steps = u8{0};
+        while (accumulator >= mTickS && steps < mMaxSimStepsPerFrame) {
+            // NOTE: Render blends the last two sim states, earlier steps of a catch-up frame are never shown.
+            if (accumulator - mTickS < mTickS || steps + 1 == mMaxSimStepsPerFrame) {
+                _capturePrevious();
+            }
+            sim();
+            accumulator -= mTickS;
+            ++steps;
+        }
+
+        // NOTE: Still behind after hitting the cap, drop the backlog instead of spiralling into ever longer frames.
+        if (accumulator >= mTickS) {
+            auto dropped = std::floor(accumulator / mTickS) * mTickS;
+            mDroppedSimTime += dropped;
+            accumulator -= dropped;
+        }
+        return steps;
+    }
+
     void
     Game::sim() {
         auto elapsed = mSimLoopTimer.elapsedInSeconds();
@@ -62,6 +209,7 @@ namespace oni {
 
         mSimTimer.restart();
 
+        ONI_PROFILE_ZONE("Game::sim");
         _sim(mTickS);
 
         mSimMS = mSimTimer.elapsedInSeconds();
@@ -83,6 +231,7 @@ namespace oni {
 
         mPollTimer.restart();
 
+        ONI_PROFILE_ZONE("Game::poll");
         _poll();
 
         mPollMS = mPollTimer.elapsedInSeconds();
@@ -104,6 +253,7 @@ namespace oni {
 
         mRenderTimer.restart();
 
+        ONI_PROFILE_ZONE("Game::render");
         _render(mTickS);
 
         mRenderMS = mRenderTimer.elapsedInSeconds();
@@ -120,6 +270,22 @@ namespace oni {
         _display();
     }
 
+    void
+    Game::_publish() {}
+
+    void
+    Game::_capturePrevious() {
+        // NOTE: Only called in the FIXED_STEP modes. Without an override render has nothing to blend from and
+        // alpha does nothing, override it with an empty body if that is really what you want.
+        assert(false);
+    }
+
+    void
+    Game::_attachRenderContext() {}
+
+    void
+    Game::_detachRenderContext() {}
+
     void
     Game::showFPS(i16) {}
 
@@ -0,0 +1,143 @@
+#include <oni-core/graphic/buffer/oni-graphic-stream-buffer.h>
+
+#include <cassert>
+
+#include <GL/glew.h>
+
+#include <oni-core/util/oni-util-timer.h>
+
+namespace oni {
+    StreamBuffer::StreamBuffer(oniGLsizeiptr regionSize,
+                               oniGLsizei vertexSize,
+                               u8 regionCount) : mRegionSize{regionSize},
+                                                 mVertexSize{vertexSize},
+                                                 mRegionCount{regionCount} {
+        assert(isSupported());
+        // NOTE: A batch can straddle two regions
+        assert(mRegionCount >= 2);
+        assert(mVertexSize > 0 && mRegionSize % mVertexSize == 0);
+
+        mFences.resize(mRegionCount, nullptr);
+        mHeld.resize(mRegionCount, false);
+
+        auto totalSize = mRegionSize * mRegionCount;
+        auto flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+        glGenBuffers(1, &mBufferID);
+        bind();
+        glBufferStorage(GL_ARRAY_BUFFER, totalSize, nullptr, flags);
+        mData = static_cast<u8 *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, totalSize, flags));
+        if (!mData) {
+            glDeleteBuffers(1, &mBufferID);
+            mBufferID = 0;
+            assert(false);
+        }
+        unbind();
+    }
+
+    StreamBuffer::~StreamBuffer() {
+        for (auto &&fence: mFences) {
+            if (fence) {
+                glDeleteSync(fence);
+            }
+        }
+        if (mBufferID) {
+            bind();
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            unbind();
+            glDeleteBuffers(1, &mBufferID);
+        }
+    }
+
+    bool
+    StreamBuffer::isSupported() {
+        return (GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage) &&
+               (GLEW_VERSION_3_2 || GLEW_ARB_draw_elements_base_vertex);
+    }
+
+    void *
+    StreamBuffer::begin() {
+        auto totalSize = mRegionSize * mRegionCount;
+        auto wrap = mHead + mRegionSize > totalSize;
+
+        // NOTE: Draws of the previous batches are issued by now, fence the regions the head moved past
+        auto headRegion = mHead / mRegionSize;
+        for (u8 region = 0; region < mRegionCount; ++region) {
+            if (mHeld[region] && (wrap || region < headRegion)) {
+                release(region);
+            }
+        }
+        if (wrap) {
+            mHead = 0;
+        }
+
+        auto first = mHead / mRegionSize;
+        auto last = (mHead + mRegionSize - 1) / mRegionSize;
+        for (auto region = first; region <= last; ++region) {
+            if (!mHeld[region]) {
+                acquire(static_cast<u8>(region));
+            }
+        }
+
+        mBatchBegin = mHead;
+        ++mStats.batches;
+        return mData + mHead;
+    }
+
+    oniGLint
+    StreamBuffer::end(const void *head) {
+        auto written = static_cast<const u8 *>(head) - (mData + mBatchBegin);
+        assert(written >= 0 && written <= mRegionSize);
+
+        // NOTE: Keep the next batch on a vertex boundary
+        auto aligned = (written + mVertexSize - 1) / mVertexSize * mVertexSize;
+        mHead = mBatchBegin + aligned;
+
+        return static_cast<oniGLint>(mBatchBegin / mVertexSize);
+    }
+
+    void
+    StreamBuffer::acquire(u8 region) {
+        auto &fence = mFences[region];
+        if (fence) {
+            ++mStats.fenceWaits;
+            auto status = glClientWaitSync(fence, 0, 0);
+            if (status == GL_TIMEOUT_EXPIRED) {
+                ++mStats.stalls;
+                auto timer = Timer{};
+                do {
+                    status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000 * 1000);
+                } while (status == GL_TIMEOUT_EXPIRED);
+                mStats.stallNs += timer.elapsedInNanoseconds();
+            }
+            assert(status != GL_WAIT_FAILED);
+
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+        mHeld[region] = true;
+    }
+
+    void
+    StreamBuffer::release(u8 region) {
+        assert(!mFences[region]);
+        mFences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        mHeld[region] = false;
+    }
+
+    void
+    StreamBuffer::bind() { glBindBuffer(GL_ARRAY_BUFFER, mBufferID); }
+
+    void
+    StreamBuffer::unbind() { glBindBuffer(GL_ARRAY_BUFFER, 0); }
+
+    const StreamBufferStats &
+    StreamBuffer::getStats() const {
+        return mStats;
+    }
+
+    void
+    StreamBuffer::resetStats() {
+        mStats = {};
+    }
+}
@@ -1,21 +1,29 @@
 #include <oni-core/graphic/buffer/oni-graphic-buffer.h>
 
+#include <cassert>
+
 #include <GL/glew.h>
 
 #include <oni-core/graphic/buffer/oni-graphic-buffer-data.h>
+#include <oni-core/graphic/buffer/oni-graphic-stream-buffer.h>
 #include <oni-core/graphic/buffer/oni-graphic-vertex-array.h>
 
 namespace oni {
     VertexArray::VertexArray(
             const std::vector<BufferStructure> &bufferStructure,
             oniGLsizei maxBufferSize) : mMaxBufferSize{maxBufferSize} {
-        mVertexBuffers = std::make_unique<Buffer>(std::vector<oniGLfloat>(), mMaxBufferSize,
-                                                  GL_STATIC_DRAW);
         mBufferStructure = bufferStructure;
+        if (StreamBuffer::isSupported()) {
+            assert(!mBufferStructure.empty());
+            mStreamBuffer = std::make_unique<StreamBuffer>(mMaxBufferSize, mBufferStructure.front().stride);
+        } else {
+            mVertexBuffers = std::make_unique<Buffer>(std::vector<oniGLfloat>(), mMaxBufferSize,
+                                                      GL_STATIC_DRAW);
+        }
         glGenVertexArrays(1, &mArrayID);
 
         bindVAO();
-        mVertexBuffers->bind();
+        bindVBO();
 
         for (auto &&vertex: mBufferStructure) {
             glEnableVertexAttribArray(vertex.index);
@@ -23,7 +31,7 @@ namespace oni {
                                   vertex.stride, vertex.offset);
         }
 
-        mVertexBuffers->unbind();
+        unbindVBO();
         unbindVAO();
     }
 
@@ -43,11 +51,24 @@ namespace oni {
 
     void
     VertexArray::bindVBO() const {
-        mVertexBuffers->bind();
+        if (mStreamBuffer) {
+            mStreamBuffer->bind();
+        } else {
+            mVertexBuffers->bind();
+        }
     }
 
     void
     VertexArray::unbindVBO() const {
-        mVertexBuffers->unbind();
+        if (mStreamBuffer) {
+            mStreamBuffer->unbind();
+        } else {
+            mVertexBuffers->unbind();
+        }
+    }
+
+    StreamBuffer *
+    VertexArray::getStreamBuffer() const {
+        return mStreamBuffer.get();
     }
 }
@@ -0,0 +1,315 @@
+#include <oni-core/graphic/oni-graphic-particle.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <oni-core/common/oni-common-const.h>
+#include <oni-core/graphic/oni-graphic-texture-manager.h>
+#include <oni-core/math/oni-math-function.h>
+#include <oni-core/math/oni-math-rand.h>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ONI_PARTICLE_AVX2 1
+
+#include <immintrin.h>
+
+#endif
+
+
+namespace {
+    struct UpdateParams {
+        oni::r32 dt;
+        oni::r32 acc;
+        oni::r32 growth;
+        oni::r32 maxSize;
+    };
+
+    struct Arrays {
+        oni::r32 *x;
+        oni::r32 *y;
+        const oni::r32 *dirX;
+        const oni::r32 *dirY;
+        oni::r32 *speed;
+        oni::r32 *size;
+        oni::r32 *age;
+        const oni::r32 *invMaxAge;
+        oni::r32 *alpha;
+    };
+
+    // NOTE: Emitters may pin a range to a single value, Rand::fill_r32() needs a non-empty one.
+    void
+    fillRange(oni::Rand &rand,
+              oni::r32 *out,
+              oni::size count,
+              oni::r32 min,
+              oni::r32 max) {
+        if (max > min) {
+            rand.fill_r32(out, count, min, max);
+        } else {
+            std::fill_n(out, count, min);
+        }
+    }
+
+    // NOTE: count is a multiple of NumParticleLanes. Keep the operations in the same order as the AVX2 version,
+    // one rounding each, so both give the same result.
+    void
+    update_scalar(const Arrays &a,
+                  oni::size count,
+                  const UpdateParams &p) {
+        for (oni::size i = 0; i < count; ++i) {
+            a.age[i] = a.age[i] + p.dt;
+            a.speed[i] = a.speed[i] + p.acc * p.dt;
+
+            auto step = a.speed[i] * p.dt;
+            step = step > oni::EP32 ? step : 0.f;
+            a.x[i] = a.x[i] + a.dirX[i] * step;
+            a.y[i] = a.y[i] + a.dirY[i] * step;
+
+            auto size = a.size[i] + p.growth * p.dt;
+            a.size[i] = size < p.maxSize ? size : p.maxSize;
+
+            a.alpha[i] = 1.f - a.age[i] * a.invMaxAge[i];
+        }
+    }
+
+#if ONI_PARTICLE_AVX2
+
+    __attribute__((target("avx2")))
+    void
+    update_avx2(const Arrays &a,
+                oni::size count,
+                const UpdateParams &p) {
+        const auto dt = _mm256_set1_ps(p.dt);
+        const auto accDt = _mm256_set1_ps(p.acc * p.dt);
+        const auto growthDt = _mm256_set1_ps(p.growth * p.dt);
+        const auto maxSize = _mm256_set1_ps(p.maxSize);
+        const auto epsilon = _mm256_set1_ps(oni::EP32);
+        const auto one = _mm256_set1_ps(1.f);
+
+        for (oni::size i = 0; i < count; i += oni::ParticlePool::NumParticleLanes) {
+            auto age = _mm256_add_ps(_mm256_load_ps(a.age + i), dt);
+            _mm256_store_ps(a.age + i, age);
+
+            auto speed = _mm256_add_ps(_mm256_load_ps(a.speed + i), accDt);
+            _mm256_store_ps(a.speed + i, speed);
+
+            auto step = _mm256_mul_ps(speed, dt);
+            step = _mm256_and_ps(step, _mm256_cmp_ps(step, epsilon, _CMP_GT_OQ));
+            _mm256_store_ps(a.x + i, _mm256_add_ps(_mm256_load_ps(a.x + i),
+                                                   _mm256_mul_ps(_mm256_load_ps(a.dirX + i), step)));
+            _mm256_store_ps(a.y + i, _mm256_add_ps(_mm256_load_ps(a.y + i),
+                                                   _mm256_mul_ps(_mm256_load_ps(a.dirY + i), step)));
+
+            auto size = _mm256_add_ps(_mm256_load_ps(a.size + i), growthDt);
+            _mm256_store_ps(a.size + i, _mm256_min_ps(size, maxSize));
+
+            _mm256_store_ps(a.alpha + i, _mm256_sub_ps(one, _mm256_mul_ps(age, _mm256_load_ps(a.invMaxAge + i))));
+        }
+    }
+
+    bool
+    hasAVX2() {
+        static const bool result = __builtin_cpu_supports("avx2");
+        return result;
+    }
+
+#endif
+
+    oni::size
+    padded(oni::size count) {
+        return (count + oni::ParticlePool::NumParticleLanes - 1) / oni::ParticlePool::NumParticleLanes *
+               oni::ParticlePool::NumParticleLanes;
+    }
+}
+
+namespace oni {
+    ParticlePool::ParticlePool(const ParticleEmitter &emitter) :
+            mMaterial(emitter.material),
+            mAcc(emitter.acc),
+            mGrowthRate(emitter.growth.period > 0 ? emitter.growth.factor / emitter.growth.period : 0),
+            // NOTE: GrowOverTime never shrinks
+            mMaxSize(max(emitter.growth.maxSize.x, emitter.size)) {
+    }
+
+    void
+    ParticlePool::reserve(u32 count) {
+        auto capacity = padded(count);
+        if (capacity <= mX.size()) {
+            return;
+        }
+        // NOTE: Grow geometrically, pools that spawn every tick shouldn't reallocate every tick
+        capacity = max(capacity, mX.size() * 2);
+        for (auto *array: {&mX, &mY, &mZ, &mDirX, &mDirY, &mSpeed, &mOrientation, &mSize, &mAge, &mInvMaxAge,
+                           &mAlpha}) {
+            array->resize(capacity);
+        }
+    }
+
+    void
+    ParticlePool::spawn(const ParticleEmitter &emitter,
+                        const WorldP3D &pos,
+                        u32 count,
+                        Rand &rand) {
+        if (!count) {
+            return;
+        }
+        reserve(mCount + count);
+
+        auto begin = mCount;
+        auto end = mCount + count;
+        fillRange(rand, mOrientation.data() + begin, count, emitter.orientMin, emitter.orientMax);
+        fillRange(rand, mSpeed.data() + begin, count, emitter.initialVMin, emitter.initialVMax);
+        fillRange(rand, mInvMaxAge.data() + begin, count, emitter.ttlMin, emitter.ttlMax);
+
+        for (auto i = begin; i < end; ++i) {
+            mX[i] = pos.x;
+            mY[i] = pos.y;
+            // TODO: Same z-fighting issue as the entity particles had, ask the layer manager for a z value
+            mZ[i] = pos.z;
+            mDirX[i] = std::cos(mOrientation[i]);
+            mDirY[i] = std::sin(mOrientation[i]);
+            mSize[i] = emitter.size;
+            mAge[i] = 0.f;
+            mInvMaxAge[i] = 1.f / mInvMaxAge[i];
+            mAlpha[i] = 1.f;
+        }
+        mCount = end;
+    }
+
+    void
+    ParticlePool::update(r32 dt) {
+        if (!mCount) {
+            return;
+        }
+
+        auto arrays = Arrays{mX.data(), mY.data(), mDirX.data(), mDirY.data(), mSpeed.data(), mSize.data(),
+                             mAge.data(), mInvMaxAge.data(), mAlpha.data()};
+        auto params = UpdateParams{dt, mAcc, mGrowthRate, mMaxSize};
+        auto count = padded(mCount);
+#if ONI_PARTICLE_AVX2
+        if (hasAVX2()) {
+            update_avx2(arrays, count, params);
+        } else {
+            update_scalar(arrays, count, params);
+        }
+#else
+        update_scalar(arrays, count, params);
+#endif
+
+        compact();
+    }
+
+    void
+    ParticlePool::compact() {
+        const auto *alpha = mAlpha.data();
+        auto count = mCount;
+        u32 i = 0;
+        while (i < count) {
+            if (alpha[i] > 0.f) {
+                ++i;
+                continue;
+            }
+            --count;
+            for (auto *array: {&mX, &mY, &mZ, &mDirX, &mDirY, &mSpeed, &mOrientation, &mSize, &mAge, &mInvMaxAge,
+                               &mAlpha}) {
+                (*array)[i] = (*array)[count];
+            }
+        }
+        mCount = count;
+    }
+
+    void
+    ParticlePool::clear() {
+        mCount = 0;
+    }
+
+    u32
+    ParticlePool::getCount() const {
+        return mCount;
+    }
+
+    Material_Definition &
+    ParticlePool::getMaterial() {
+        return mMaterial;
+    }
+
+    const Material_Definition &
+    ParticlePool::getMaterial() const {
+        return mMaterial;
+    }
+
+    const r32 *
+    ParticlePool::getX() const {
+        return mX.data();
+    }
+
+    const r32 *
+    ParticlePool::getY() const {
+        return mY.data();
+    }
+
+    const r32 *
+    ParticlePool::getZ() const {
+        return mZ.data();
+    }
+
+    const r32 *
+    ParticlePool::getOrientation() const {
+        return mOrientation.data();
+    }
+
+    const r32 *
+    ParticlePool::getSize() const {
+        return mSize.data();
+    }
+
+    const r32 *
+    ParticlePool::getAlpha() const {
+        return mAlpha.data();
+    }
+
+    ParticleManager::ParticleManager(TextureManager &tm) : mTextureManager(tm) {}
+
+    void
+    ParticleManager::spawn(EntityID emitter,
+                           const ParticleEmitter &def,
+                           const WorldP3D &pos,
+                           Rand &rand) {
+        auto it = mPools.find(emitter);
+        if (it == mPools.end()) {
+            it = mPools.emplace(emitter, Entry{ParticlePool(def)}).first;
+            mTextureManager.initTexture(it->second.pool.getMaterial().skin.texture);
+        }
+        it->second.pool.spawn(def, pos, def.count, rand);
+        it->second.spawned = true;
+    }
+
+    void
+    ParticleManager::update(r32 dt) {
+        for (auto it = mPools.begin(); it != mPools.end();) {
+            auto &entry = it->second;
+            entry.pool.update(dt);
+            if (!entry.spawned && !entry.pool.getCount()) {
+                it = mPools.erase(it);
+                continue;
+            }
+            entry.spawned = false;
+            ++it;
+        }
+    }
+
+    void
+    ParticleManager::clear() {
+        mPools.clear();
+    }
+
+    size
+    ParticleManager::getParticleCount() const {
+        auto result = size{0};
+        for (auto &&entry: mPools) {
+            result += entry.second.pool.getCount();
+        }
+        return result;
+    }
+}
@@ -0,0 +1,133 @@
+#include <oni-core/graphic/oni-graphic-render-queue.h>
+
+#include <cassert>
+#include <utility>
+
+#include <oni-core/math/oni-math-function.h>
+
+
+namespace {
+    constexpr oni::u8 RadixBits = 8;
+    constexpr oni::u32 RadixSize = 1u << RadixBits;
+    constexpr oni::u8 RadixPasses = 64 / RadixBits;
+
+    constexpr oni::u8 IDShift = 0;
+    constexpr oni::u8 TextureShift = IDShift + oni::RenderQueue::IDBits;
+    constexpr oni::u8 ZShift = TextureShift + oni::RenderQueue::TextureBits;
+    constexpr oni::u8 FinishShift = ZShift + oni::RenderQueue::ZBits;
+
+    static_assert(FinishShift + oni::RenderQueue::FinishBits == 64);
+    static_assert(oni::Material_Finish::size() <= (1u << oni::RenderQueue::FinishBits));
+    // NOTE: Smaller than ZLayerManager::mMinorLayerDelta
+    static_assert(1.f / (1u << oni::RenderQueue::ZBits) < 0.001f);
+}
+
+namespace oni {
+    u64
+    RenderQueue::makeKey(u8 finish,
+                         r32 z,
+                         u32 texture,
+                         EntityID id) {
+        constexpr auto zBuckets = u32{1} << ZBits;
+        // NOTE: Written so that NaN ends up in the first bucket
+        auto zClamped = z > 0.f ? min(z, 1.f) : 0.f;
+        auto bucket = min(static_cast<u32>(zClamped * zBuckets), zBuckets - 1);
+
+        return (u64{finish} << FinishShift) |
+               (u64{bucket} << ZShift) |
+               // NOTE: Only groups draws of the same texture, a collision just costs a sampler switch
+               (u64{texture & ((1u << TextureBits) - 1)} << TextureShift) |
+               (u64{id} << IDShift);
+    }
+
+    u8
+    RenderQueue::getFinish(u64 key) {
+        return static_cast<u8>(key >> FinishShift);
+    }
+
+    void
+    RenderQueue::push(const Material_Finish &finish,
+                      const Renderable &renderable) {
+        assert(renderable.pos);
+        assert(mRenderables.size() < (u64{1} << 32));
+
+        auto texture = u32{0};
+        if (renderable.materialDef) {
+            texture = renderable.materialDef->skin.texture.id;
+        }
+        if (renderable.text) {
+            texture = renderable.text->textureID;
+        }
+
+        auto entry = Entry{};
+        entry.key = makeKey(static_cast<u8>(finish.id), renderable.pos->z, texture, renderable.id);
+        entry.index = static_cast<u32>(mRenderables.size());
+        mEntries.push_back(entry);
+        mRenderables.push_back(renderable);
+    }
+
+    void
+    RenderQueue::sort() {
+        auto count = mEntries.size();
+        if (count < 2) {
+            return;
+        }
+        mScratch.resize(count);
+
+        // NOTE: All the histograms in one read of the keys
+        u32 histograms[RadixPasses][RadixSize] = {};
+        for (auto &&entry: mEntries) {
+            for (u8 pass = 0; pass < RadixPasses; ++pass) {
+                ++histograms[pass][(entry.key >> (pass * RadixBits)) & (RadixSize - 1)];
+            }
+        }
+
+        auto *src = mEntries.data();
+        auto *dst = mScratch.data();
+        for (u8 pass = 0; pass < RadixPasses; ++pass) {
+            auto shift = pass * RadixBits;
+            auto &histogram = histograms[pass];
+            // NOTE: Every key has the same digit, common for the finish and z bytes, nothing to move
+            if (histogram[(src[0].key >> shift) & (RadixSize - 1)] == count) {
+                continue;
+            }
+
+            auto offset = u32{0};
+            for (auto &&bucket: histogram) {
+                auto bucketCount = bucket;
+                bucket = offset;
+                offset += bucketCount;
+            }
+
+            for (size i = 0; i < count; ++i) {
+                dst[histogram[(src[i].key >> shift) & (RadixSize - 1)]++] = src[i];
+            }
+            std::swap(src, dst);
+        }
+
+        if (src != mEntries.data()) {
+            mEntries.swap(mScratch);
+        }
+    }
+
+    void
+    RenderQueue::clear() {
+        mRenderables.clear();
+        mEntries.clear();
+    }
+
+    size
+    RenderQueue::getCount() const {
+        return mEntries.size();
+    }
+
+    const Renderable &
+    RenderQueue::get(size index) const {
+        return mRenderables[mEntries[index].index];
+    }
+
+    u64
+    RenderQueue::getKey(size index) const {
+        return mEntries[index].key;
+    }
+}
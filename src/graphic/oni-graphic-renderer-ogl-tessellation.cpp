@@ -9,8 +9,10 @@
 #include <oni-core/graphic/buffer/oni-graphic-index-buffer.h>
 #include <oni-core/graphic/buffer/oni-graphic-vertex-array.h>
 #include <oni-core/graphic/buffer/oni-graphic-buffer-data.h>
+#include <oni-core/graphic/oni-graphic-particle.h>
 #include <oni-core/graphic/oni-graphic-shader.h>
 #include <oni-core/graphic/oni-graphic-texture-manager.h>
+#include <oni-core/math/oni-math-function.h>
 
 
 namespace oni {
@@ -269,10 +271,16 @@ namespace oni {
                         const auto &animation = renderable.trans->texture;
                         effectID = 1.f;
                         const auto &UVs = mTextureManager.getUV(animation.animID, animation.nextFrame);
-                        uv0 = UVs.values[0];
-                        uv1 = UVs.values[1];
-                        uv2 = UVs.values[2];
-                        uv3 = UVs.values[3];
+                        // NOTE: Frames are relative to the image, which is a region of an atlas
+                        const auto &region = skin->texture.uv.values;
+                        auto toRegion = [&region](const vec2 &uv) {
+                            return vec2{lerp(region[0].x, region[2].x, uv.x),
+                                        lerp(region[0].y, region[2].y, uv.y)};
+                        };
+                        uv0 = toRegion(UVs.values[0]);
+                        uv1 = toRegion(UVs.values[1]);
+                        uv2 = toRegion(UVs.values[2]);
+                        uv3 = toRegion(UVs.values[3]);
                         break;
                     }
                     case MaterialTransition_Type::FADE: {
@@ -326,6 +334,51 @@ namespace oni {
         mBuffer = static_cast<void *>(buffer);
     }
 
+    u32
+    Renderer_OpenGL_Tessellation::submit(const ParticlePool &pool,
+                                         u32 first) {
+        assert(first <= pool.getCount());
+        auto room = mMaxIndicesCount - 1 - mIndexCount;
+        if (room <= 0) {
+            return 0;
+        }
+        auto count = min(pool.getCount() - first, static_cast<u32>(room));
+
+        const auto &skin = pool.getMaterial().skin;
+        auto samplerID = getSamplerID(skin.texture.id);
+        auto color = skin.color.rgba();
+        const auto &uv = skin.texture.uv.values;
+
+        const auto *x = pool.getX() + first;
+        const auto *y = pool.getY() + first;
+        const auto *z = pool.getZ() + first;
+        const auto *ornt = pool.getOrientation() + first;
+        const auto *size = pool.getSize() + first;
+        const auto *alpha = pool.getAlpha() + first;
+
+        auto *buffer = static_cast<TessellationVertex *>(mBuffer);
+        for (u32 i = 0; i < count; ++i) {
+            buffer->position = vec3{x[i], y[i], z[i]};
+            buffer->ornt = ornt[i];
+            // NOTE: Fade effect, the texture is multiplied by color.a
+            buffer->effect = 2.f;
+            buffer->halfSize = vec2{size[i] / 2.f, size[i] / 2.f};
+            buffer->color = color;
+            buffer->color.w *= alpha[i];
+            buffer->uv_0 = uv[0];
+            buffer->uv_1 = uv[1];
+            buffer->uv_2 = uv[2];
+            buffer->uv_3 = uv[3];
+            buffer->samplerID = samplerID;
+            buffer->transformType = enumCast(PrimitiveTransforms::DYNAMIC);
+            ++buffer;
+        }
+        mIndexCount += count;
+
+        mBuffer = static_cast<void *>(buffer);
+        return count;
+    }
+
     void
     Renderer_OpenGL_Tessellation::enableShader(const RenderSpec &spec) {
         mShader->enable();
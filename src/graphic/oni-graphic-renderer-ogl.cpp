@@ -5,6 +5,7 @@
 
 #include <GL/glew.h>
 
+#include <oni-core/graphic/buffer/oni-graphic-stream-buffer.h>
 #include <oni-core/graphic/oni-graphic-shader.h>
 #include <oni-core/graphic/oni-graphic-texture-manager.h>
 
@@ -15,6 +16,11 @@ namespace oni {
             Renderer(tm),
             mPrimitiveType(primitiveType) {
         mFrameBuffer = std::make_unique<FrameBuffer>();
+
+        oniGLint textureUnits{0};
+        glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &textureUnits);
+        mMaxNumTextureSamplers = std::min(textureUnits, MaxNumShaderSamplers);
+        assert(mMaxNumTextureSamplers > 0);
     }
 
     Renderer_OpenGL::~Renderer_OpenGL() = default;
@@ -29,7 +35,9 @@ namespace oni {
             if (mNextSamplerID > mMaxNumTextureSamplers) {
                 reset();
             }*/
-            assert(mNextSamplerID <= mMaxNumTextureSamplers);
+            // NOTE: Images in the same atlas share the sampler, so this counts atlases and stand-alone textures
+            // such as canvases, fonts and render targets.
+            assert(mNextSamplerID < mMaxNumTextureSamplers);
 
             mTextures.push_back(textureID);
             mSamplers.push_back(mNextSamplerID++);
@@ -98,15 +106,24 @@ namespace oni {
         mSamplers.clear();
         mTextures.clear();
 
-        bindVertexBuffer();
         // Data written to mBuffer has to match the structure of VBO.
-        mBuffer = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+        if (auto *stream = mVertexArray->getStreamBuffer()) {
+            mBuffer = stream->begin();
+        } else {
+            bindVertexBuffer();
+            mBuffer = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+        }
     }
 
     void
     Renderer_OpenGL::_end() {
-        glUnmapBuffer(GL_ARRAY_BUFFER);
-        unbindVertexBuffer();
+        if (auto *stream = mVertexArray->getStreamBuffer()) {
+            mFirstVertex = stream->end(mBuffer);
+        } else {
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            unbindVertexBuffer();
+            mFirstVertex = 0;
+        }
     }
 
     void
@@ -131,19 +148,23 @@ namespace oni {
 
         switch (mPrimitiveType) {
             case PrimitiveType::POINTS: {
-                glDrawArrays(GL_POINTS, 0, indexCount);
+                glDrawArrays(GL_POINTS, mFirstVertex, indexCount);
                 break;
             }
             case PrimitiveType::LINES: {
-                glDrawArrays(GL_LINES, 0, indexCount);
+                glDrawArrays(GL_LINES, mFirstVertex, indexCount);
                 break;
             }
             case PrimitiveType::TRIANGLES: {
-                glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+                if (mFirstVertex) {
+                    glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, mFirstVertex);
+                } else {
+                    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr);
+                }
                 break;
             }
             case PrimitiveType::TRIANGLE_STRIP: {
-                glDrawArrays(GL_TRIANGLE_STRIP, 0, indexCount);
+                glDrawArrays(GL_TRIANGLE_STRIP, mFirstVertex, indexCount);
                 break;
             }
             default: {
@@ -164,6 +185,21 @@ namespace oni {
         disableShader();
     }
 
+    StreamBufferStats
+    Renderer_OpenGL::getStreamStats() const {
+        if (auto *stream = mVertexArray->getStreamBuffer()) {
+            return stream->getStats();
+        }
+        return {};
+    }
+
+    void
+    Renderer_OpenGL::resetStreamStats() {
+        if (auto *stream = mVertexArray->getStreamBuffer()) {
+            stream->resetStats();
+        }
+    }
+
     void
     Renderer_OpenGL::disableShader() {
         mShader->disable();
@@ -1,5 +1,7 @@
 #include <oni-core/graphic/oni-graphic-scene-manager.h>
 
+#include <cmath>
+#include <limits>
 #include <set>
 
 #include <oni-core/asset/oni-asset-manager.h>
@@ -11,6 +13,8 @@
 #include <oni-core/graphic/oni-graphic-renderer-ogl-strip.h>
 #include <oni-core/graphic/oni-graphic-renderer-ogl-quad.h>
 #include <oni-core/graphic/oni-graphic-debug-draw-box2d.h>
+#include <oni-core/graphic/oni-graphic-particle.h>
+#include <oni-core/graphic/oni-graphic-render-queue.h>
 #include <oni-core/graphic/oni-graphic-shader.h>
 #include <oni-core/graphic/oni-graphic-texture-manager.h>
 #include <oni-core/math/oni-math-transformation.h>
@@ -19,6 +23,7 @@
 #include <oni-core/math/oni-math-z-layer-manager.h>
 #include <oni-core/math/oni-math-mat4.h>
 #include <oni-core/math/oni-math-vec2.h>
+#include <oni-core/util/oni-util-profiler.h>
 
 
 namespace oni {
@@ -42,7 +47,7 @@ namespace oni {
         mRendererStrip = std::make_unique<Renderer_OpenGL_Strip>(mMaxSpriteCount, tm);
         mRendererQuad = std::make_unique<Renderer_OpenGL_Quad>(mMaxSpriteCount, tm);
 
-        mRand = std::make_unique<Rand>(0, 0);
+        mRand = std::make_unique<Rand>(makeRandStream(RandStream::SCENE));
 
         mDebugDrawBox2D = std::make_unique<DebugDrawBox2D>(this);
         mDebugDrawBox2D->AppendFlags(b2Draw::e_shapeBit);
@@ -133,16 +138,39 @@ namespace oni {
 
     void
     SceneManager::submit(EntityManager &manager) {
+        ONI_PROFILE_ZONE("SceneManager::submit");
         {
-            // TODO: The following code includes everything, even the particles will be sorted, which might be over-kill
             auto view = manager.createView<
                     WorldP3D,
                     Orientation,
                     Scale,
                     Material_Definition
                                           >();
+            // NOTE: Positions are written in place all over, there is no change to listen to. Comparing the
+            // cell is cheap though and only entities that moved to another cell touch the grid.
             for (auto &&id: view) {
                 const auto &pos = view.get<WorldP3D>(id);
+                const auto &scale = view.get<Scale>(id);
+                auto radius = max(scale.x, scale.y) * 0.5f;
+                // NOTE: Attached entities are positioned relative to their parent, use the resolved pose and
+                // let every query test the ones that aren't resolved yet
+                if (manager.has<EntityAttachee>(id)) {
+                    if (manager.has<WorldTransform>(id)) {
+                        const auto &wt = manager.get<WorldTransform>(id);
+                        mRenderGrid.update(id, wt.pos.x, wt.pos.y, radius);
+                        continue;
+                    }
+                    radius = std::numeric_limits<r32>::max();
+                }
+                mRenderGrid.update(id, pos.x, pos.y, radius);
+            }
+            mRenderGrid.removeStale();
+
+            auto halfViewWidth = getViewWidth() * 0.5f;
+            auto halfViewHeight = getViewHeight() * 0.5f;
+            mRenderGrid.query(mCamera.x - halfViewWidth, mCamera.y - halfViewHeight,
+                              mCamera.x + halfViewWidth, mCamera.y + halfViewHeight, [&](EntityID id) {
+                const auto &pos = view.get<WorldP3D>(id);
                 const auto &ornt = view.get<Orientation>(id);
                 const auto &scale = view.get<Scale>(id);
                 const auto &def = view.get<Material_Definition>(id);
@@ -165,8 +193,8 @@ namespace oni {
 
                 // TODO: Now that I distinguish between opaque and translucent objects I should draw the
                 // opaque objects front to back to avoid over draw
-                mRenderables[def.finish.id].push(renderable);
-            }
+                mRenderQueue.push(def.finish, renderable);
+            });
         }
 
         {
@@ -195,13 +223,112 @@ namespace oni {
                 // TODO: Read this value from the entity
                 renderable.pt = PrimitiveTransforms::UI;
 
-                mRenderables[Material_Finish::GET("translucent").id].push(renderable);
+                mRenderQueue.push(Material_Finish::GET("translucent"), renderable);
+            }
+        }
+    }
+
+    void
+    SceneManager::capturePrevious(EntityManager &manager) {
+        ONI_PROFILE_ZONE("SceneManager::capturePrevious");
+        mPreviousTransforms.clear();
+
+        auto view = manager.createView<
+                WorldP3D,
+                Orientation,
+                Scale,
+                Material_Definition
+                                      >();
+        for (auto &&id: view) {
+            mPreviousTransforms.emplace(id, applyParentTransforms({&manager, id},
+                                                                  view.get<WorldP3D>(id),
+                                                                  view.get<Orientation>(id)));
+        }
+    }
+
+    void
+    SceneManager::capture(EntityManager &manager,
+                          RenderSnapshot &snapshot) {
+        ONI_PROFILE_ZONE("SceneManager::capture");
+        snapshot.entries.clear();
+
+        auto view = manager.createView<
+                WorldP3D,
+                Orientation,
+                Scale,
+                Material_Definition
+                                      >();
+        for (auto &&id: view) {
+            auto current = applyParentTransforms({&manager, id}, view.get<WorldP3D>(id), view.get<Orientation>(id));
+
+            auto &entry = snapshot.entries.emplace_back();
+            entry.id = id;
+            entry.pos = current.pos;
+            entry.ornt = current.ornt;
+            entry.prevPos = current.pos;
+            entry.prevOrnt = current.ornt;
+            entry.scale = view.get<Scale>(id);
+            entry.materialDef = view.get<Material_Definition>(id);
+
+            auto previous = mPreviousTransforms.find(id);
+            if (previous != mPreviousTransforms.end()) {
+                entry.prevPos = previous->second.pos;
+                entry.prevOrnt = previous->second.ornt;
+            }
+
+            if (manager.has<MaterialTransition_List>(id)) {
+                const auto &transList = manager.get<MaterialTransition_List>(id);
+                entry.trans = transList.transitions[transList.activeTransIdx];
+                entry.hasTrans = true;
+            }
+        }
+    }
+
+    void
+    SceneManager::submit(const RenderSnapshot &snapshot,
+                         r32 alpha) {
+        ONI_PROFILE_ZONE("SceneManager::submit");
+        mInterpolatedTransforms.clear();
+        // NOTE: Renderables point into this vector, it must not reallocate while queuing.
+        mInterpolatedTransforms.reserve(snapshot.entries.size());
+
+        for (auto &&entry: snapshot.entries) {
+            auto &transform = mInterpolatedTransforms.emplace_back();
+            transform.pos = entry.pos;
+            transform.pos.x = lerp(entry.prevPos.x, entry.pos.x, alpha);
+            transform.pos.y = lerp(entry.prevPos.y, entry.pos.y, alpha);
+            // NOTE: Take the short way around the circle
+            auto delta = std::remainder(entry.ornt.value - entry.prevOrnt.value, TWO_PI);
+            transform.ornt.value = entry.prevOrnt.value + delta * alpha;
+
+            auto renderable = Renderable{};
+            renderable.id = entry.id;
+            // NOTE: No manager, the parent transforms are already applied.
+            renderable.manager = nullptr;
+            renderable.pos = &transform.pos;
+            renderable.ornt = &transform.ornt;
+            renderable.scale = &entry.scale;
+            renderable.materialDef = &entry.materialDef;
+            renderable.pt = PrimitiveTransforms::DYNAMIC;
+            if (entry.hasTrans) {
+                renderable.trans = &entry.trans;
             }
+
+            mRenderQueue.push(entry.materialDef.finish, renderable);
         }
     }
 
+    void
+    SceneManager::submit(const ParticleManager &particles) {
+        mParticles = &particles;
+    }
+
     void
     SceneManager::render() {
+        ONI_PROFILE_ZONE("SceneManager::render");
+        mRenderQueue.sort();
+
+        auto next = size{0};
         for (auto iter = Material_Finish::begin(); iter != Material_Finish::end(); ++iter) {
             RenderSpec spec;
             spec.renderTarget = nullptr;
@@ -211,13 +338,15 @@ namespace oni {
             setMVP(spec, true, true, true);
 
             begin(*mRendererTessellation, spec);
-            while (!mRenderables[iter->id].empty()) {
-                auto &r = const_cast<Renderable &> (mRenderables[iter->id].top());
-                // TODO: Well can I not const_cast?
-                auto ePos = applyParentTransforms({const_cast<EntityManager *>(r.manager), r.id}, *r.pos, *r.ornt);
+            for (; next < mRenderQueue.getCount() && RenderQueue::getFinish(mRenderQueue.getKey(next)) == iter->id;
+                   ++next) {
+                auto r = mRenderQueue.get(next);
+                auto ePos = WorldP3DAndOrientation{*r.pos, *r.ornt};
+                if (r.manager) {
+                    ePos = applyParentTransforms({const_cast<EntityManager *>(r.manager), r.id}, *r.pos, *r.ornt);
+                }
 
                 if (r.pt == PrimitiveTransforms::DYNAMIC && !isVisible(ePos.pos, *r.scale)) {
-                    mRenderables[iter->id].pop();
                     continue;
                 }
 
@@ -230,12 +359,40 @@ namespace oni {
 
                 mRendererTessellation->submit(r);
 
-                mRenderables[iter->id].pop();
-
                 ++mRenderedSpritesPerFrame;
             }
+
+            renderParticles(spec);
             end(*mRendererTessellation);
         }
+        assert(next == mRenderQueue.getCount());
+        mRenderQueue.clear();
+        mParticles = nullptr;
+    }
+
+    void
+    SceneManager::renderParticles(const RenderSpec &spec) {
+        if (!mParticles) {
+            return;
+        }
+        ONI_PROFILE_ZONE("SceneManager::renderParticles");
+        mParticles->forEachPool([&](const ParticlePool &pool) {
+            if (pool.getMaterial().finish.id != spec.finishType.id) {
+                return;
+            }
+            auto first = u32{0};
+            while (first < pool.getCount()) {
+                auto count = mRendererTessellation->submit(pool, first);
+                if (!count) {
+                    // NOTE: Vertex buffer is full, draw what is there and continue with an empty one
+                    end(*mRendererTessellation);
+                    begin(*mRendererTessellation, spec);
+                    continue;
+                }
+                first += count;
+                mRenderedParticlesPerFrame += count;
+            }
+        });
     }
 
     void
@@ -388,7 +545,7 @@ namespace oni {
         return mRenderedSpritesPerFrame;
     }
 
-    u16
+    u32
     SceneManager::getParticlesPerFrame() const {
         return mRenderedParticlesPerFrame;
     }
@@ -398,6 +555,21 @@ namespace oni {
         return mRenderedTexturesPerFrame;
     }
 
+    StreamBufferStats
+    SceneManager::getStreamStatsPerFrame() const {
+        auto result = StreamBufferStats{};
+        auto add = [&result](const StreamBufferStats &stats) {
+            result.batches += stats.batches;
+            result.fenceWaits += stats.fenceWaits;
+            result.stalls += stats.stalls;
+            result.stallNs += stats.stallNs;
+        };
+        add(mRendererTessellation->getStreamStats());
+        add(mRendererStrip->getStreamStats());
+        add(mRendererQuad->getStreamStats());
+        return result;
+    }
+
     r32
     SceneManager::getViewWidth() const {
         return (mScreenBounds.xMax - mScreenBounds.xMin) * (1.0f / mCamera.z);
@@ -423,34 +595,46 @@ namespace oni {
         mRenderedSpritesPerFrame = 0;
         mRenderedParticlesPerFrame = 0;
         mRenderedTexturesPerFrame = 0;
+        mRendererTessellation->resetStreamStats();
+        mRendererStrip->resetStreamStats();
+        mRendererQuad->resetStreamStats();
     }
 
     SceneManager::WorldP3DAndOrientation
     SceneManager::applyParentTransforms(const EntityContext &context,
                                         const WorldP3D &childPos,
                                         const Orientation &childOrientation) {
-        auto transformation = mat4::identity();
         auto result = WorldP3DAndOrientation{childPos, childOrientation};
-        auto numParents = size{};
-        auto childZ = childPos.z;
+        if (!context.mng->has<EntityAttachee>(context.id)) {
+            return result;
+        }
+        if (context.mng->has<WorldTransform>(context.id)) {
+            const auto &wt = context.mng->get<WorldTransform>(context.id);
+            return {wt.pos, wt.ornt};
+        }
 
+        // NOTE: Attached since the last System_WorldTransform tick, walk up until a resolved ancestor.
+        // TODO: Scaling is ignored because it is used to store the size of the object, so even non-scaled
+        // objects have scaling matrix larger than identity matrix, so if I use the parent scaling
+        // that will just "scale" the child by the size of parent, which is not what I want.
+        // Perhaps removing Size component was the wrong decision, and I should have a distinction
+        // between size and Scale. Renderer passes scale down to shader as a size anyway, it does NOT
+        // use it as a multiplier.
+        auto numParents = size{};
         auto node = context;
         while (node.mng->has<EntityAttachee>(node.id)) {
             auto &ea = node.mng->get<EntityAttachee>(node.id);
             node = {ea.mng, ea.id};
 
+            if (node.mng->has<EntityAttachee>(node.id) && node.mng->has<WorldTransform>(node.id)) {
+                const auto &wt = node.mng->get<WorldTransform>(node.id);
+                localToWorldTransform(wt.pos, wt.ornt, result.pos, result.ornt);
+                break;
+            }
+
             const auto &parentPos = node.mng->get<WorldP3D>(node.id);
             const auto &parentOrientation = node.mng->get<Orientation>(node.id);
-
-            // TODO: Scaling is ignored because it is used to store the size of the object, so even non-scaled
-            // objects have scaling matrix larger than identity matrix, so if I use the parent scaling
-            // that will just "scale" the child by the size of parent, which is not what I want.
-            // Perhaps removing Size component was the wrong decision, and I should have a distinction
-            // between size and Scale. Renderer passes scale down to shader as a size anyway, it does NOT
-            // use it as a multiplier.
-            transformation *= createTransformation(parentPos, parentOrientation, {});
-            result.pos.value = transformation * result.pos.value;
-            result.ornt.value += parentOrientation.value;
+            localToWorldTransform(parentPos, parentOrientation, result.pos, result.ornt);
 
             ++numParents;
 
@@ -460,8 +644,6 @@ namespace oni {
             }
         }
 
-        // NOTE: Child z is not effected by the parents
-        result.pos.z = childZ;
         return result;
     }
 
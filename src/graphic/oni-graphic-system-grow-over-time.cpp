@@ -1,7 +1,9 @@
 #include <oni-core/graphic/oni-graphic-system.h>
 
 namespace oni {
-    System_GrowOverTime::System_GrowOverTime(EntityManager &em) : SystemTemplate(em) {}
+    System_GrowOverTime::System_GrowOverTime(EntityManager &em) : SystemTemplate(em) {
+        enableParallelUpdate();
+    }
 
     void
     System_GrowOverTime::update(EntityTickContext &etc,
@@ -1,7 +1,10 @@
 #include <oni-core/graphic/oni-graphic-system.h>
 
 namespace oni {
-    System_MaterialTransition::System_MaterialTransition(EntityManager&em) : SystemTemplate(em) {}
+    System_MaterialTransition::System_MaterialTransition(EntityManager&em) : SystemTemplate(em) {
+        declareStructural();
+        enableParallelUpdate();
+    }
 
     void
     System_MaterialTransition::updateTextureAnimated(MaterialTransition_Texture &mta,
@@ -1,5 +1,6 @@
 #include <oni-core/graphic/oni-graphic-texture-manager.h>
 
+#include <algorithm>
 #include <cassert>
 
 #include <ftgl/texture-atlas.h>
@@ -11,6 +12,21 @@
 #include <oni-core/math/oni-math-function.h>
 
 
+namespace {
+    // NOTE: Texels around each image in an atlas, copies of its edge so sampling at the border never reads the
+    // neighbour
+    constexpr oni::u32 AtlasGutter = 1;
+
+    oni::u32
+    nextPowerOfTwo(oni::u32 value) {
+        auto result = oni::u32{1};
+        while (result < value) {
+            result *= 2;
+        }
+        return result;
+    }
+}
+
 namespace oni {
     TextureManager::TextureManager(AssetFilesIndex &assetManager) : mAssetManager(assetManager) {
         mAnimationUVs.resize(enumCast(NumAnimationFrames::LAST));
@@ -43,7 +59,148 @@ namespace oni {
         for (auto iter = mAssetManager.imageAssetsBegin(); iter != mAssetManager.imageAssetsEnd(); ++iter) {
             const auto &imageAsset = iter->second;
             _cacheImage(imageAsset);
-            _cacheTexture(imageAsset.name);
+        }
+        _cacheAtlases();
+    }
+
+    void
+    TextureManager::_cacheAtlases() {
+        oniGLint maxTextureSize{0};
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxTextureSize);
+        auto maxSize = min(static_cast<u32>(maxTextureSize), mMaxAtlasSize);
+
+        auto images = std::vector<const Image *>{};
+        auto area = u64{0};
+        auto widest = u32{0};
+        for (auto &&image: mImageMap) {
+            auto width = image.second.width + 2 * AtlasGutter;
+            auto height = image.second.height + 2 * AtlasGutter;
+            if (width > maxSize || height > maxSize) {
+                _cacheTexture(image.second.name);
+                continue;
+            }
+            images.push_back(&image.second);
+            area += u64{width} * height;
+            widest = max(widest, width);
+        }
+        if (images.empty()) {
+            return;
+        }
+
+        // NOTE: Tallest first so the shelves waste little, the hash keeps the layout the same between runs
+        std::sort(images.begin(), images.end(), [](const Image *a,
+                                                   const Image *b) {
+            if (a->height != b->height) {
+                return a->height > b->height;
+            }
+            if (a->width != b->width) {
+                return a->width > b->width;
+            }
+            return a->name.hash.value < b->name.hash.value;
+        });
+
+        // NOTE: Roughly square, grows up to maxSize and spills into more atlases after that. Both dimensions are
+        // powers of two, maxSize is one as long as GL_MAX_TEXTURE_SIZE is.
+        auto atlasWidth = u32{1};
+        while ((u64{atlasWidth} * atlasWidth < area || atlasWidth < widest) && atlasWidth < maxSize) {
+            atlasWidth *= 2;
+        }
+
+        auto slots = std::vector<AtlasSlot>{};
+        auto x = u32{0};
+        auto shelfY = u32{0};
+        auto shelfHeight = u32{0};
+        for (auto *image: images) {
+            auto width = image->width + 2 * AtlasGutter;
+            auto height = image->height + 2 * AtlasGutter;
+            if (x + width > atlasWidth) {
+                shelfY += shelfHeight;
+                x = 0;
+                shelfHeight = 0;
+            }
+            if (shelfY + height > maxSize) {
+                _initAtlas(slots, atlasWidth, shelfY + shelfHeight);
+                slots.clear();
+                x = 0;
+                shelfY = 0;
+                shelfHeight = 0;
+            }
+            slots.push_back({image, x + AtlasGutter, shelfY + AtlasGutter});
+            x += width;
+            shelfHeight = max(shelfHeight, height);
+        }
+        _initAtlas(slots, atlasWidth, shelfY + shelfHeight);
+    }
+
+    void
+    TextureManager::_initAtlas(const std::vector<AtlasSlot> &slots,
+                               u32 width,
+                               u32 usedHeight) {
+        assert(!slots.empty());
+        assert(width > 0 && nextPowerOfTwo(width) == width);
+        assert(usedHeight > 0);
+        // NOTE: Rows past the last shelf stay empty
+        auto height = nextPowerOfTwo(usedHeight);
+
+        auto storage = std::vector<u8>(size{width} * height * mElementsInRGBA, 0);
+        for (auto &&slot: slots) {
+            const auto &image = *slot.image;
+            const auto &data = mImageDataMap[image.name.hash];
+            assert(data.size() == size{image.width} * image.height * mElementsInRGBA);
+
+            // NOTE: Rows and columns past the edge repeat the edge
+            for (i64 row = -i64{AtlasGutter}; row < i64{image.height} + AtlasGutter; ++row) {
+                auto srcRow = static_cast<u32>(min(max(row, i64{0}), i64{image.height} - 1));
+                const auto *src = data.data() + size{srcRow} * image.width * mElementsInRGBA;
+                auto *dst = storage.data() + ((slot.y + row) * width + slot.x) * mElementsInRGBA;
+
+                std::copy(src, src + image.width * mElementsInRGBA, dst);
+                for (u32 i = 1; i <= AtlasGutter; ++i) {
+                    std::copy(src, src + mElementsInRGBA, dst - i * mElementsInRGBA);
+                    std::copy(src + (image.width - 1) * mElementsInRGBA, src + image.width * mElementsInRGBA,
+                              dst + (image.width - 1 + i) * mElementsInRGBA);
+                }
+            }
+        }
+
+        oniGLuint textureID = 0;
+        glGenTextures(1, &textureID);
+        assert(textureID);
+
+        // TODO: Hard-coded! This should be part of Texture
+        oniGLenum internalFormat = GL_RGBA;
+        oniGLenum format = GL_BGRA;
+        oniGLenum type = GL_UNSIGNED_BYTE;
+
+        _bind(textureID);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, storage.data());
+
+        unbind();
+
+        for (auto &&slot: slots) {
+            const auto &image = *slot.image;
+            auto newElement = mTextureMap.emplace(image.name.hash, Texture{});
+            if (!newElement.second) {
+                assert(false);
+                continue;
+            }
+            auto &texture = newElement.first->second;
+            texture.image = image;
+            texture.id = textureID;
+            texture.format = format;
+            texture.type = type;
+
+            auto u0 = static_cast<r32>(slot.x) / width;
+            auto u1 = static_cast<r32>(slot.x + image.width) / width;
+            auto v0 = static_cast<r32>(slot.y) / height;
+            auto v1 = static_cast<r32>(slot.y + image.height) / height;
+            texture.uv = {vec2{u0, v0}, vec2{u0, v1}, vec2{u1, v1}, vec2{u1, v0}};
         }
     }
 
@@ -258,11 +415,35 @@ namespace oni {
                                           std::vector<u8> &storageTexture,
                                           std::vector<u8> &storageImage,
                                           const vec3 &brushTexturePos) {
+        auto subImage = std::vector<u8>{};
+        oniGLint xOffset{};
+        oniGLint yOffset{};
+        oniGLint subImageWidth{};
+        oniGLint subImageHeight{};
+        if (!blend(texture.image, image, storageTexture, storageImage, brushTexturePos,
+                   subImage, xOffset, yOffset, subImageWidth, subImageHeight)) {
+            return;
+        }
+
+        updateSubTexture(texture, xOffset, yOffset, subImageWidth, subImageHeight, subImage);
+    }
+
+    bool
+    TextureManager::blend(const Image &textureImage,
+                          const Image &image,
+                          std::vector<u8> &storageTexture,
+                          const std::vector<u8> &storageImage,
+                          const vec3 &brushTexturePos,
+                          std::vector<u8> &subImage,
+                          oniGLint &xOffset,
+                          oniGLint &yOffset,
+                          oniGLint &subImageWidth,
+                          oniGLint &subImageHeight) {
         assert(image.width);
         assert(image.height);
 
-        auto xOffset = static_cast<oniGLint>(brushTexturePos.x - (image.width / 2.f));
-        auto yOffset = static_cast<oniGLint>(brushTexturePos.y - (image.height / 2.f));
+        xOffset = static_cast<oniGLint>(brushTexturePos.x - (image.width / 2.f));
+        yOffset = static_cast<oniGLint>(brushTexturePos.y - (image.height / 2.f));
 
         auto r = FI_RGBA_RED;
         auto g = FI_RGBA_GREEN;
@@ -270,35 +451,34 @@ namespace oni {
         auto a = FI_RGBA_ALPHA;
 
         i32 brushStride = image.width * mElementsInRGBA;
-        i32 textureStride = texture.image.width * mElementsInRGBA;
+        i32 textureStride = textureImage.width * mElementsInRGBA;
 
-        i32 subImageWidth = image.width;
-        i32 subImageHeight = image.height;
+        subImageWidth = image.width;
+        subImageHeight = image.height;
 
         if (yOffset < 0) {
             subImageHeight = image.height + yOffset;
         }
-        if (yOffset + image.height > texture.image.height) {
-            subImageHeight = texture.image.height - yOffset;
+        if (yOffset + image.height > textureImage.height) {
+            subImageHeight = textureImage.height - yOffset;
         }
 
         if (xOffset < 0) {
             subImageWidth = image.width + xOffset;
         }
-        if (xOffset + image.width > texture.image.width) {
-            subImageWidth = texture.image.width - xOffset;
+        if (xOffset + image.width > textureImage.width) {
+            subImageWidth = textureImage.width - xOffset;
         }
 
         if (subImageHeight <= 0 || subImageWidth <= 0) {
-            return;
+            return false;
         }
 
         assert(subImageHeight > 0);
         assert(subImageWidth > 0);
 
         u32 subImageStride = subImageWidth * mElementsInRGBA;
-        std::vector<u8> subImage;
-        subImage.resize(subImageHeight * subImageStride, 0);
+        subImage.assign(subImageHeight * subImageStride, 0);
 
         for (i32 y = 0; y < image.height; ++y) {
             for (i32 x = 0; x < image.width; ++x) {
@@ -308,7 +488,7 @@ namespace oni {
                 if (xTexture < 0 || yTexture < 0) {
                     continue;
                 }
-                if (xTexture > texture.image.width || yTexture > texture.image.height) {
+                if (xTexture > textureImage.width || yTexture > textureImage.height) {
                     continue;
                 }
 
@@ -380,8 +560,7 @@ namespace oni {
 
         zeroClip(xOffset);
         zeroClip(yOffset);
-
-        updateSubTexture(texture, xOffset, yOffset, subImageWidth, subImageHeight, subImage);
+        return true;
     }
 
     oniGLuint
@@ -239,6 +239,16 @@ namespace oni {
         glfwSwapBuffers(mWindow);
     }
 
+    void
+    Window::attachContext() {
+        glfwMakeContextCurrent(mWindow);
+    }
+
+    void
+    Window::detachContext() {
+        glfwMakeContextCurrent(nullptr);
+    }
+
     Window *
     Window::getThisFromGLFWWindow(GLFWwindow *window) {
         return reinterpret_cast<Window *>(glfwGetWindowUserPointer(window));
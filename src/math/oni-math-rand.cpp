@@ -1,10 +1,144 @@
 #include <oni-core/math/oni-math-rand.h>
 
+#include <atomic>
 #include <cassert>
+#include <cstring>
 #include <random>
 
 #include <oni-core/common/oni-common-const.h>
+#include <oni-core/math/oni-math-function.h>
 
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ONI_RAND_AVX2 1
+
+#include <immintrin.h>
+
+#endif
+
+
+namespace {
+    std::atomic<oni::u64> gMasterSeed{0};
+
+    // NOTE: Taken from http://xoshiro.di.unimi.it/splitmix64.c, recommended for expanding a seed into a state.
+    oni::u64
+    splitMix64(oni::u64 &x) {
+        auto z = (x += 0x9e3779b97f4a7c15);
+        z = (z ^ (z >> 30u)) * 0xbf58476d1ce4e5b9;
+        z = (z ^ (z >> 27u)) * 0x94d049bb133111eb;
+        return z ^ (z >> 31u);
+    }
+
+    using Lanes = oni::u32[4][oni::Rand::NumRandLanes];
+
+    // NOTE: xoshiro128+ step of every lane, written so the compiler can vectorize it with whatever the target has.
+    void
+    nextLanes_scalar(Lanes &s,
+                     oni::u32 *out,
+                     oni::size count) {
+        for (oni::size i = 0; i < count; i += oni::Rand::NumRandLanes) {
+            for (oni::u8 l = 0; l < oni::Rand::NumRandLanes; ++l) {
+                out[i + l] = s[0][l] + s[3][l];
+                const oni::u32 t = s[1][l] << 9u;
+
+                s[2][l] ^= s[0][l];
+                s[3][l] ^= s[1][l];
+                s[1][l] ^= s[2][l];
+                s[0][l] ^= s[3][l];
+
+                s[2][l] ^= t;
+
+                s[3][l] = (s[3][l] << 11u) | (s[3][l] >> 21u);
+            }
+        }
+    }
+
+#if ONI_RAND_AVX2
+
+    // NOTE: Runs the lanes count / NumRandLanes steps and hands each step's 8 values to store(i, values).
+    template<class Store>
+    __attribute__((target("avx2"), always_inline)) inline
+    void
+    stepLanes_avx2(Lanes &s,
+                   oni::size count,
+                   Store &&store) {
+        static_assert(oni::Rand::NumRandLanes == 8);
+        auto s0 = _mm256_load_si256(reinterpret_cast<const __m256i *>(s[0]));
+        auto s1 = _mm256_load_si256(reinterpret_cast<const __m256i *>(s[1]));
+        auto s2 = _mm256_load_si256(reinterpret_cast<const __m256i *>(s[2]));
+        auto s3 = _mm256_load_si256(reinterpret_cast<const __m256i *>(s[3]));
+
+        for (oni::size i = 0; i < count; i += oni::Rand::NumRandLanes) {
+            store(i, _mm256_add_epi32(s0, s3));
+            auto t = _mm256_slli_epi32(s1, 9);
+
+            s2 = _mm256_xor_si256(s2, s0);
+            s3 = _mm256_xor_si256(s3, s1);
+            s1 = _mm256_xor_si256(s1, s2);
+            s0 = _mm256_xor_si256(s0, s3);
+
+            s2 = _mm256_xor_si256(s2, t);
+
+            s3 = _mm256_or_si256(_mm256_slli_epi32(s3, 11), _mm256_srli_epi32(s3, 21));
+        }
+
+        _mm256_store_si256(reinterpret_cast<__m256i *>(s[0]), s0);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(s[1]), s1);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(s[2]), s2);
+        _mm256_store_si256(reinterpret_cast<__m256i *>(s[3]), s3);
+    }
+
+    __attribute__((target("avx2")))
+    void
+    nextLanes_avx2(Lanes &s,
+                   oni::u32 *out,
+                   oni::size count) {
+        stepLanes_avx2(s, count, [out](oni::size i,
+                                       __m256i values) __attribute__((target("avx2"))) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + i), values);
+        });
+    }
+
+    // NOTE: Same math as toUnitR32() and Rand::fill_r32(), one op at a time, so the results match the scalar path.
+    __attribute__((target("avx2")))
+    void
+    fillR32_avx2(Lanes &s,
+                 oni::r32 *out,
+                 oni::size count,
+                 oni::r32 lower,
+                 oni::r32 d) {
+        const auto exponent = _mm256_set1_epi32(127 << 23);
+        const auto one = _mm256_set1_ps(1.f);
+        const auto lowerV = _mm256_set1_ps(lower);
+        const auto dV = _mm256_set1_ps(d);
+        stepLanes_avx2(s, count, [&](oni::size i,
+                                     __m256i values) __attribute__((target("avx2"))) {
+            auto unit = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(exponent, _mm256_srli_epi32(values, 9))),
+                                      one);
+            _mm256_storeu_ps(out + i, _mm256_add_ps(lowerV, _mm256_mul_ps(unit, dV)));
+        });
+    }
+
+    bool
+    hasAVX2() {
+        static const bool result = __builtin_cpu_supports("avx2");
+        return result;
+    }
+
+#endif
+
+    // NOTE: Same trick as Rand::next_r32(), upper 23 bits into the mantissa of a float in [1, 2).
+    oni::r32
+    toUnitR32(oni::u32 value) {
+        auto bits = (127u << 23u) | (value >> 9u);
+        oni::r32 result;
+        std::memcpy(&result, &bits, sizeof(result));
+        return result - 1;
+    }
+
+    // NOTE: Raw values are produced in chunks on the stack, big enough to amortize the call and small enough to
+    // stay in L1.
+    constexpr oni::size ChunkSize = 256;
+}
 
 namespace oni {
     Rand::Rand(u64 seed_a,
@@ -12,18 +146,249 @@ namespace oni {
         if (seed_a && seed_b) {
             mSeed_u64[0] = seed_a;
             mSeed_u64[1] = seed_b;
+
+            auto x = seed_a ^ rotl_64(seed_b, 32);
+            auto a = splitMix64(x);
+            auto b = splitMix64(x);
+            mSeed_u32[0] = static_cast<u32>(a);
+            mSeed_u32[1] = static_cast<u32>(a >> 32u);
+            mSeed_u32[2] = static_cast<u32>(b);
+            mSeed_u32[3] = static_cast<u32>(b >> 32u);
         } else {
-            std::random_device rd;
-            mSeed_u64[0] = rd();
-            mSeed_u64[1] = rd();
+            seedFromDevice();
+        }
+    }
 
-            mSeed_u32[0] = rd();
-            mSeed_u32[1] = rd();
-            mSeed_u32[2] = rd();
-            mSeed_u32[3] = rd();
+    Rand::Rand(u64 seed) {
+        if (seed) {
+            seedFrom(seed);
+        } else {
+            seedFromDevice();
         }
     }
 
+    void
+    Rand::seedFromDevice() {
+        std::random_device rd;
+        mSeed_u64[0] = rd();
+        mSeed_u64[1] = rd();
+
+        mSeed_u32[0] = rd();
+        mSeed_u32[1] = rd();
+        mSeed_u32[2] = rd();
+        mSeed_u32[3] = rd();
+    }
+
+    void
+    Rand::seedFrom(u64 seed) {
+        auto x = seed;
+        mSeed_u64[0] = splitMix64(x);
+        mSeed_u64[1] = splitMix64(x);
+
+        auto a = splitMix64(x);
+        auto b = splitMix64(x);
+        mSeed_u32[0] = static_cast<u32>(a);
+        mSeed_u32[1] = static_cast<u32>(a >> 32u);
+        mSeed_u32[2] = static_cast<u32>(b);
+        mSeed_u32[3] = static_cast<u32>(b >> 32u);
+    }
+
+    u32
+    Rand::next_bounded_u32(u32 range) {
+        assert(range);
+        auto m = u64{next_u32()} * range;
+        auto low = static_cast<u32>(m);
+        if (low < range) {
+            const u32 threshold = -range % range;
+            while (low < threshold) {
+                m = u64{next_u32()} * range;
+                low = static_cast<u32>(m);
+            }
+        }
+        return static_cast<u32>(m >> 32u);
+    }
+
+    u64
+    Rand::next_bounded_u64(u64 range) {
+        assert(range);
+#if defined(__SIZEOF_INT128__)
+        auto m = static_cast<unsigned __int128>(next_u64()) * range;
+        auto low = static_cast<u64>(m);
+        if (low < range) {
+            const u64 threshold = -range % range;
+            while (low < threshold) {
+                m = static_cast<unsigned __int128>(next_u64()) * range;
+                low = static_cast<u64>(m);
+            }
+        }
+        return static_cast<u64>(m >> 64u);
+#else
+        // TODO: No 128 bit multiply, modulo is slightly biased for big ranges
+        return next_u64() % range;
+#endif
+    }
+
+    void
+    Rand::seedLanes() {
+        // NOTE: Lanes are seeded from a hash of the state instead of jumps off it. Streams and split() are already
+        // jumps apart, lanes jumped off one would run into the scalar draws of the next. The scalar generator is
+        // left where it is.
+        auto x = u64{mSeed_u32[0]} | (u64{mSeed_u32[1]} << 32u);
+        x = splitMix64(x) ^ u64{mSeed_u32[2]} ^ (u64{mSeed_u32[3]} << 32u);
+        for (u8 l = 0; l < NumRandLanes; ++l) {
+            auto a = splitMix64(x);
+            auto b = splitMix64(x);
+            mLanes[0][l] = static_cast<u32>(a);
+            mLanes[1][l] = static_cast<u32>(a >> 32u);
+            mLanes[2][l] = static_cast<u32>(b);
+            mLanes[3][l] = static_cast<u32>(b >> 32u);
+            // NOTE: All zero is the one state xoshiro128+ never leaves
+            assert(a || b);
+        }
+        mLanesSeeded = true;
+    }
+
+    void
+    Rand::nextLanes(u32 *out,
+                    size count) {
+        assert(count % NumRandLanes == 0);
+        if (!mLanesSeeded) {
+            seedLanes();
+        }
+#if ONI_RAND_AVX2
+        if (hasAVX2()) {
+            nextLanes_avx2(mLanes, out, count);
+            return;
+        }
+#endif
+        nextLanes_scalar(mLanes, out, count);
+    }
+
+    void
+    Rand::fill_u32(u32 *out,
+                   size count,
+                   u32 lowerBoundInclusive,
+                   u32 upperBoundExclusive) {
+        assert(upperBoundExclusive > lowerBoundInclusive);
+        auto range = upperBoundExclusive - lowerBoundInclusive;
+        const u32 threshold = -range % range;
+
+        alignas(32) u32 raw[ChunkSize];
+        for (size i = 0; i < count; i += ChunkSize) {
+            auto n = min(ChunkSize, count - i);
+            nextLanes(raw, (n + NumRandLanes - 1) / NumRandLanes * NumRandLanes);
+            for (size j = 0; j < n; ++j) {
+                auto m = u64{raw[j]} * range;
+                // NOTE: Rejections are rare, they redraw from the scalar generator to keep the lanes in step.
+                while (static_cast<u32>(m) < threshold) {
+                    m = u64{next_u32()} * range;
+                }
+                out[i + j] = lowerBoundInclusive + static_cast<u32>(m >> 32u);
+            }
+        }
+    }
+
+    void
+    Rand::fill_r32(r32 *out,
+                   size count,
+                   r32 lowerBoundInclusive,
+                   r32 upperBoundExclusive) {
+        assert(upperBoundExclusive > lowerBoundInclusive);
+        auto d = upperBoundExclusive - lowerBoundInclusive;
+
+#if ONI_RAND_AVX2
+        if (hasAVX2()) {
+            if (!mLanesSeeded) {
+                seedLanes();
+            }
+            auto blocks = count / NumRandLanes * NumRandLanes;
+            fillR32_avx2(mLanes, out, blocks, lowerBoundInclusive, d);
+            out += blocks;
+            count -= blocks;
+        }
+#endif
+
+        alignas(32) u32 raw[ChunkSize];
+        for (size i = 0; i < count; i += ChunkSize) {
+            auto n = min(ChunkSize, count - i);
+            nextLanes(raw, (n + NumRandLanes - 1) / NumRandLanes * NumRandLanes);
+            for (size j = 0; j < n; ++j) {
+                out[i + j] = lowerBoundInclusive + toUnitR32(raw[j]) * d;
+            }
+        }
+    }
+
+    void
+    Rand::fill_norm(r32 *out,
+                    size count,
+                    r32 mean,
+                    r32 stddev) {
+        // NOTE: Box-Muller on pairs of lanes, see next_norm(). 1 - u keeps the log argument in (0, 1].
+        alignas(32) u32 raw[ChunkSize];
+        for (size i = 0; i < count; i += ChunkSize) {
+            auto n = min(ChunkSize, count - i);
+            auto pairs = (n + 1) / 2;
+            nextLanes(raw, (pairs * 2 + NumRandLanes - 1) / NumRandLanes * NumRandLanes);
+            for (size p = 0; p < pairs; ++p) {
+                auto u1 = 1 - toUnitR32(raw[2 * p]);
+                auto u2 = toUnitR32(raw[2 * p + 1]);
+                auto r = std::sqrt(-2.f * std::log(u1));
+                out[i + 2 * p] = r * std::cos(static_cast<r32>(TWO_PI) * u2) * stddev + mean;
+                if (2 * p + 1 < n) {
+                    out[i + 2 * p + 1] = r * std::sin(static_cast<r32>(TWO_PI) * u2) * stddev + mean;
+                }
+            }
+        }
+    }
+
+    void
+    Rand::jump() {
+        // NOTE: Jump polynomials from http://xoshiro.di.unimi.it/xoroshiro128plus.c and
+        // http://xoshiro.di.unimi.it/xoshiro128plus.c, both are equivalent to 2^64 calls to next.
+        static constexpr u64 jump_u64[] = {0xdf900294d8f554a5, 0x170865df4b3201fc};
+        static constexpr u32 jump_u32[] = {0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b};
+
+        u64 s0 = 0;
+        u64 s1 = 0;
+        for (auto jump: jump_u64) {
+            for (u32 b = 0; b < 64; ++b) {
+                if (jump & (u64{1} << b)) {
+                    s0 ^= mSeed_u64[0];
+                    s1 ^= mSeed_u64[1];
+                }
+                next_u64();
+            }
+        }
+        mSeed_u64[0] = s0;
+        mSeed_u64[1] = s1;
+
+        u32 t[4]{};
+        for (auto jump: jump_u32) {
+            for (u32 b = 0; b < 32; ++b) {
+                if (jump & (u32{1} << b)) {
+                    t[0] ^= mSeed_u32[0];
+                    t[1] ^= mSeed_u32[1];
+                    t[2] ^= mSeed_u32[2];
+                    t[3] ^= mSeed_u32[3];
+                }
+                next_u32();
+            }
+        }
+        mSeed_u32[0] = t[0];
+        mSeed_u32[1] = t[1];
+        mSeed_u32[2] = t[2];
+        mSeed_u32[3] = t[3];
+        // NOTE: Lanes are split off the state at the time, re-split them from the new state when needed.
+        mLanesSeeded = false;
+    }
+
+    Rand
+    Rand::split() {
+        auto result = *this;
+        jump();
+        return result;
+    }
+
     u32
     Rand::rotl_u32(u32 x,
                    i32 k) {
@@ -39,8 +404,8 @@ namespace oni {
     u32
     Rand::next_u32() {
         // NOTE: Taken from http://xoshiro.di.unimi.it/xoshiro128plus.c
-        const uint32_t result = mSeed_u32[0] + mSeed_u32[3];
-        const uint32_t t = mSeed_u32[1] << 9u;
+        const u32 result = mSeed_u32[0] + mSeed_u32[3];
+        const u32 t = mSeed_u32[1] << 9u;
 
         mSeed_u32[2] ^= mSeed_u32[0];
         mSeed_u32[3] ^= mSeed_u32[1];
@@ -166,4 +531,29 @@ namespace oni {
         mZ1_r64 = std::sqrt(-2.0 * std::log(u1)) * std::sin(TWO_PI * u2);
         return z0 * stddev + mean;
     }
+
+    void
+    setRandMasterSeed(u64 seed) {
+        gMasterSeed = seed;
+    }
+
+    u64
+    getRandMasterSeed() {
+        return gMasterSeed;
+    }
+
+    Rand
+    makeRandStream(RandStream stream) {
+        assert(stream < RandStream::LAST);
+        auto seed = getRandMasterSeed();
+        if (!seed) {
+            return Rand(0, 0);
+        }
+
+        auto result = Rand(seed);
+        for (auto i = 0; i < enumCast(stream); ++i) {
+            result.jump();
+        }
+        return result;
+    }
 }
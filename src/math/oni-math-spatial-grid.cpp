@@ -0,0 +1,157 @@
+#include <oni-core/math/oni-math-spatial-grid.h>
+
+#include <cassert>
+
+
+namespace oni {
+    SpatialGrid::SpatialGrid(r32 cellSize) : mCellSize(cellSize) {
+        assert(mCellSize > 0.f);
+    }
+
+    void
+    SpatialGrid::insert(Record &record,
+                        const Entry &entry) {
+        record.entries = record.large ? &mLarge : &mCells[record.cell];
+        record.slot = static_cast<u32>(record.entries->size());
+        record.entries->push_back(entry);
+    }
+
+    void
+    SpatialGrid::erase(const Record &record) {
+        auto *entries = record.entries;
+        assert(record.slot < entries->size());
+
+        // NOTE: Swap-remove, the entity that took the slot has to know
+        if (record.slot + 1 != entries->size()) {
+            (*entries)[record.slot] = entries->back();
+            mRecords[(*entries)[record.slot].id].slot = record.slot;
+        }
+        entries->pop_back();
+
+        if (!record.large && entries->empty()) {
+            mCells.erase(record.cell);
+        }
+    }
+
+    void
+    SpatialGrid::update(EntityID id,
+                        r32 x,
+                        r32 y,
+                        r32 radius) {
+        auto *hint = mNext < mOrder.size() ? &mOrder[mNext] : nullptr;
+        auto inserted = false;
+        if (!hint || !hint->record || hint->id != id) {
+            auto result = mRecords.try_emplace(id);
+            inserted = result.second;
+            forget(result.first->second);
+            if (!hint) {
+                hint = &mOrder.emplace_back();
+            } else if (hint->record) {
+                hint->record->order = NoOrder;
+            }
+            *hint = {id, &result.first->second};
+            hint->record->order = mNext;
+        }
+        ++mNext;
+
+        auto &record = *hint->record;
+        if (record.stamp != mStamp) {
+            record.stamp = mStamp;
+            ++mUpdated;
+        }
+
+        if (!inserted && record.entry.x == x && record.entry.y == y && record.entry.radius == radius) {
+            return;
+        }
+        auto entry = Entry{id, x, y, radius};
+        record.entry = entry;
+
+        auto large = radius > mCellSize * 0.5f;
+        auto cell = large ? u64{0} : cellKey(toCell(x), toCell(y));
+
+        if (inserted) {
+            record.cell = cell;
+            record.large = large;
+            insert(record, entry);
+            return;
+        }
+
+        if (record.large == large && record.cell == cell) {
+            (*record.entries)[record.slot] = entry;
+            return;
+        }
+
+        erase(record);
+        record.cell = cell;
+        record.large = large;
+        insert(record, entry);
+    }
+
+    void
+    SpatialGrid::remove(EntityID id) {
+        auto record = mRecords.find(id);
+        if (record == mRecords.end()) {
+            return;
+        }
+        if (record->second.stamp == mStamp) {
+            --mUpdated;
+        }
+        forget(record->second);
+        auto copy = record->second;
+        mRecords.erase(record);
+        erase(copy);
+    }
+
+    void
+    SpatialGrid::removeStale() {
+        if (mUpdated != mRecords.size()) {
+            for (auto record = mRecords.begin(); record != mRecords.end();) {
+                if (record->second.stamp == mStamp) {
+                    ++record;
+                    continue;
+                }
+                forget(record->second);
+                auto copy = record->second;
+                record = mRecords.erase(record);
+                erase(copy);
+            }
+        }
+        ++mStamp;
+        mUpdated = 0;
+
+        for (auto i = mNext; i < mOrder.size(); ++i) {
+            if (mOrder[i].record) {
+                mOrder[i].record->order = NoOrder;
+            }
+        }
+        mOrder.resize(mNext);
+        mNext = 0;
+    }
+
+    void
+    SpatialGrid::forget(const Record &record) {
+        if (record.order != NoOrder) {
+            mOrder[record.order].record = nullptr;
+        }
+    }
+
+    void
+    SpatialGrid::clear() {
+        mCells.clear();
+        mLarge.clear();
+        mRecords.clear();
+        mUpdated = 0;
+        mOrder.clear();
+        mNext = 0;
+    }
+
+    size
+    SpatialGrid::getCount() const {
+        return mRecords.size();
+    }
+
+    r32
+    SpatialGrid::getCellSize() const {
+        return mCellSize;
+    }
+}
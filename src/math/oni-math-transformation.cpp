@@ -1,5 +1,7 @@
 #include <oni-core/math/oni-math-transformation.h>
 
+#include <cmath>
+
 
 namespace oni {
     void
@@ -82,4 +84,18 @@ namespace oni {
         auto result = trans * operand.value;
         return WorldP3D{result.x, result.y, result.z};
     }
+
+    void
+    localToWorldTransform(const WorldP3D &parentPos,
+                          const Orientation &parentOrnt,
+                          WorldP3D &pos,
+                          Orientation &ornt) {
+        auto c = std::cos(parentOrnt.value);
+        auto s = std::sin(parentOrnt.value);
+        auto x = pos.x;
+        auto y = pos.y;
+        pos.x = parentPos.x + c * x - s * y;
+        pos.y = parentPos.y + s * x + c * y;
+        ornt.value += parentOrnt.value;
+    }
 }
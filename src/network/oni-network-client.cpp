@@ -1,5 +1,7 @@
 #include <oni-core/network/oni-network-client.h>
 
+#include <cstdio>
+
 #include <enet/enet.h>
 
 #include <oni-core/io/oni-io-output.h>
@@ -11,7 +13,7 @@
 
 
 namespace oni {
-    Client::Client() : Peer::Peer(nullptr, 1, 2, 0, 0) {
+    Client::Client() : Peer::Peer(nullptr, 1, NumNetworkChannels, 0, 0) {
         mTimer = std::make_unique<Timer>();
     }
 
@@ -23,7 +25,7 @@ namespace oni {
         enet_address_set_host(&enetAddress, address.host.c_str());
         enetAddress.port = address.port;
 
-        mEnetServer = enet_host_connect(mEnetHost, &enetAddress, 2, 0);
+        mEnetServer = enet_host_connect(mEnetHost, &enetAddress, NumNetworkChannels, 0);
         if (!mEnetServer) {
             printl("Failed to initiate connection to: " + address.host + ":" + std::to_string(address.port));
             assert(false);
@@ -46,10 +48,7 @@ namespace oni {
 
     void
     Client::pingServer() {
-        auto type = PacketType::PING;
-        auto data = std::string{};
-
-        send(type, data, mEnetServer);
+        send(beginPacket(PacketType::PING), mEnetServer);
     }
 
     void
@@ -58,7 +57,8 @@ namespace oni {
                    size size,
                    PacketType header) {
         auto peerID = getPeerID(*peer);
-        assert(mPacketHandlers.find(header) != mPacketHandlers.end());
+        assert(mPacketHandlers.find(header) != mPacketHandlers.end() ||
+               header == PacketType::REGISTRY_COMPONENT_DELTA);
         switch (header) {
             case (PacketType::PING): {
                 auto latency = mTimer->elapsedInSeconds();
@@ -76,11 +76,17 @@ namespace oni {
             case (PacketType::REGISTRY_ONLY_COMPONENT_UPDATE):
             case (PacketType::REGISTRY_ADD_NEW_ENTITIES):
             case (PacketType::REGISTRY_DESTROYED_ENTITIES):
+            case (PacketType::REGISTRY_ENTITIES_ENTERED):
+            case (PacketType::REGISTRY_ENTITIES_LEFT):
             case (PacketType::EVENT_SOUND_PLAY):
             case (PacketType::EVENT_ROCKET_LAUNCH):
             case (PacketType::EVENT_COLLISION): {
-                auto dataString = std::string(reinterpret_cast<char *>(data), size);
-                mPacketHandlers[header](peerID, dataString);
+                auto view = std::string_view(reinterpret_cast<const c8 *>(data), size);
+                mPacketHandlers[header](peerID, view);
+                break;
+            }
+            case (PacketType::REGISTRY_COMPONENT_DELTA): {
+                handleComponentsDelta(data, size);
                 break;
             }
             default: {
@@ -92,11 +98,10 @@ namespace oni {
 
     void
     Client::sendMessage(std::string &&message) {
-        auto type = PacketType::MESSAGE;
-        auto messagePacket = Packet_Data{std::move(message)};
-        auto data = oni::serialize<Packet_Data>(messagePacket);
+        auto packet = beginPacket(PacketType::MESSAGE);
+        serialize(Packet_Data{std::move(message)}, packet.stream());
 
-        send(type, data, mEnetServer);
+        send(std::move(packet), mEnetServer);
     }
 
     void
@@ -109,20 +114,65 @@ namespace oni {
     }
 
     void
-    Client::sendInput(const Input *input) {
-        if (!input->hasData()) {
+    Client::sendInput(const Input *input,
+                      u32 sequence) {
+        if (!sequence && !input->hasData()) {
             return;
         }
-        auto type = PacketType::CLIENT_INPUT;
-        auto data = oni::serialize<Input>(*input);
+        auto packet = beginPacket(PacketType::CLIENT_INPUT);
+        serialize(Packet_InputSequence{sequence}, packet.stream());
+        serialize(*input, packet.stream());
+
+        send(std::move(packet), mEnetServer);
+    }
 
-        send(type, data, mEnetServer);
+    void
+    Client::registerSnapshotHandler(std::function<void(const WorldSnapshot &,
+                                                       u32)> &&handler) {
+        mSnapshotHandler = std::move(handler);
+    }
+
+    void
+    Client::handleComponentsDelta(const u8 *data,
+                                  size size) {
+        // NOTE: The last input the server applied to the state in this snapshot precedes the delta
+        auto buffer = MemoryInputBuffer(data, size);
+        auto stream = std::istream(&buffer);
+        auto inputAck = Packet_InputAck{};
+        {
+            cereal::PortableBinaryInputArchive input{stream};
+            input(inputAck);
+        }
+        auto offset = static_cast<oni::size>(stream.tellg());
+
+        auto snapshot = WorldSnapshot{};
+        if (!decodeSnapshotDelta(mSnapshotHistory, data + offset, size - offset, snapshot)) {
+            // NOTE: Not acknowledging it, the server keeps using the last baseline we do have.
+            recordDropped(PacketType::REGISTRY_COMPONENT_DELTA);
+            if (!mDroppingDeltas) {
+                printl("Dropping component deltas with unknown baseline or invalid data");
+                mDroppingDeltas = true;
+            }
+            return;
+        }
+        mDroppingDeltas = false;
+        if (mLatestSnapshot && !isNewerSequence(snapshot.sequence, mLatestSnapshot)) {
+            return;
+        }
+        mLatestSnapshot = snapshot.sequence;
+
+        auto ack = beginPacket(PacketType::SNAPSHOT_ACK);
+        serialize(Packet_SnapshotAck{snapshot.sequence}, ack.stream());
+        send(std::move(ack), mEnetServer);
+
+        if (mSnapshotHandler) {
+            mSnapshotHandler(snapshot, inputAck.sequence);
+        }
+        mSnapshotHistory.push(std::move(snapshot));
     }
 
     void
     Client::requestSessionSetup() {
-        auto type = PacketType::SETUP_SESSION;
-        auto data = std::string{};
-        send(type, data, mEnetServer);
+        send(beginPacket(PacketType::SETUP_SESSION), mEnetServer);
     }
 }
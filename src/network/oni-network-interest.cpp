@@ -0,0 +1,163 @@
+#include <oni-core/network/oni-network-interest.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+
+#include <oni-core/component/oni-component-geometry.h>
+#include <oni-core/entities/oni-entities-client-data-manager.h>
+#include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/util/oni-util-profiler.h>
+
+
+namespace oni {
+    InterestManager::InterestManager(const InterestConfig &config) : mConfig(config) {
+        assert(mConfig.cellSize > 0.f);
+        assert(mConfig.enterRadius <= mConfig.exitRadius);
+    }
+
+    i32
+    InterestManager::toCell(r32 value) const {
+        return static_cast<i32>(std::floor(value / mConfig.cellSize));
+    }
+
+    u64
+    InterestManager::cellKey(i32 x,
+                             i32 y) {
+        return (u64{static_cast<u32>(x)} << 32) | static_cast<u32>(y);
+    }
+
+    void
+    InterestManager::update(EntityManager &manager,
+                            const ClientDataManager &clients) {
+        ONI_PROFILE_ZONE("InterestManager::update");
+        // NOTE: Keep the cells around to reuse their storage, drop the ones that stayed empty for a whole update.
+        for (auto cell = mGrid.begin(); cell != mGrid.end();) {
+            if (cell->second.empty()) {
+                cell = mGrid.erase(cell);
+            } else {
+                cell->second.clear();
+                ++cell;
+            }
+        }
+
+        auto view = manager.createView<WorldP3D>();
+        for (auto &&id: view) {
+            const auto *pos = &view.get<WorldP3D>(id);
+            auto root = id;
+            while (manager.has<EntityAttachee>(root)) {
+                const auto &attachee = manager.get<EntityAttachee>(root);
+                if (attachee.mng != &manager || !manager.valid(attachee.id)) {
+                    break;
+                }
+                root = attachee.id;
+            }
+            // NOTE: Attached entities are positioned relative to their parent
+            if (root != id) {
+                if (!manager.has<WorldP3D>(root)) {
+                    continue;
+                }
+                pos = &manager.get<WorldP3D>(root);
+            }
+            mGrid[cellKey(toCell(pos->x), toCell(pos->y))].push_back({id, pos->x, pos->y});
+        }
+
+        const auto &cars = clients.getClientCarEntities();
+        for (auto client = mClients.begin(); client != mClients.end();) {
+            if (cars.find(client->first) == cars.end()) {
+                client = mClients.erase(client);
+            } else {
+                ++client;
+            }
+        }
+
+        for (auto &&car: cars) {
+            auto &interest = mClients[car.first];
+            interest.entered.clear();
+            interest.left.clear();
+            if (!manager.valid(car.second) || !manager.has<WorldP3D>(car.second)) {
+                continue;
+            }
+            const auto &pos = manager.get<WorldP3D>(car.second);
+            updateClient(interest, pos.x, pos.y);
+        }
+    }
+
+    void
+    InterestManager::updateClient(ClientInterest &interest,
+                                  r32 x,
+                                  r32 y) {
+        auto enter2 = mConfig.enterRadius * mConfig.enterRadius;
+        auto exit2 = mConfig.exitRadius * mConfig.exitRadius;
+
+        mScratch.clear();
+        for (auto cx = toCell(x - mConfig.exitRadius); cx <= toCell(x + mConfig.exitRadius); ++cx) {
+            for (auto cy = toCell(y - mConfig.exitRadius); cy <= toCell(y + mConfig.exitRadius); ++cy) {
+                auto cell = mGrid.find(cellKey(cx, cy));
+                if (cell == mGrid.end()) {
+                    continue;
+                }
+                for (auto &&entry: cell->second) {
+                    auto dx = entry.x - x;
+                    auto dy = entry.y - y;
+                    auto distance2 = dx * dx + dy * dy;
+                    if (distance2 > exit2) {
+                        continue;
+                    }
+                    if (distance2 <= enter2 ||
+                        std::binary_search(interest.relevant.begin(), interest.relevant.end(), entry.id)) {
+                        mScratch.push_back(entry.id);
+                    }
+                }
+            }
+        }
+        std::sort(mScratch.begin(), mScratch.end());
+
+        std::set_difference(mScratch.begin(), mScratch.end(),
+                            interest.relevant.begin(), interest.relevant.end(),
+                            std::back_inserter(interest.entered));
+        std::set_difference(interest.relevant.begin(), interest.relevant.end(),
+                            mScratch.begin(), mScratch.end(),
+                            std::back_inserter(interest.left));
+        interest.relevant.swap(mScratch);
+    }
+
+    const ClientInterest *
+    InterestManager::find(const std::string &clientID) const {
+        auto client = mClients.find(clientID);
+        if (client == mClients.end()) {
+            return nullptr;
+        }
+        return &client->second;
+    }
+
+    void
+    InterestManager::filter(const std::string &clientID,
+                            const WorldSnapshot &world,
+                            WorldSnapshot &out) const {
+        out.sequence = world.sequence;
+        out.entities.clear();
+        out.data.clear();
+
+        const auto *interest = find(clientID);
+        if (!interest) {
+            return;
+        }
+
+        out.entities.reserve(interest->relevant.size());
+        for (auto &&id: interest->relevant) {
+            auto entity = std::lower_bound(world.entities.begin(), world.entities.end(), id,
+                                           [](const EntitySnapshot &e,
+                                              EntityID value) { return e.id < value; });
+            if (entity == world.entities.end() || entity->id != id) {
+                continue;
+            }
+            auto copy = *entity;
+            copy.offset = static_cast<u32>(out.data.size());
+            const auto *data = world.data.data() + entity->offset;
+            out.data.insert(out.data.end(), data, data + entity->size);
+            out.entities.push_back(copy);
+        }
+    }
+}
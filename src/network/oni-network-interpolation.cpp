@@ -0,0 +1,147 @@
+#include <oni-core/network/oni-network-interpolation.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <oni-core/common/oni-common-const.h>
+
+
+namespace {
+    // NOTE: Shortest way around, so going from just below PI to just above -PI doesn't spin the whole circle.
+    oni::r32
+    angleDelta(oni::r32 from,
+               oni::r32 to) {
+        auto delta = std::fmod(to - from, oni::TWO_PI);
+        if (delta > oni::PI) {
+            delta -= oni::TWO_PI;
+        } else if (delta < -oni::PI) {
+            delta += oni::TWO_PI;
+        }
+        return delta;
+    }
+
+    oni::r32
+    interpolate(oni::r32 a,
+                oni::r32 b,
+                oni::r64 t) {
+        return static_cast<oni::r32>(a + (b - a) * t);
+    }
+}
+
+namespace oni {
+    InterpolationBuffer::InterpolationBuffer(const InterpolationConfig &config) : mConfig(config) {
+        assert(mConfig.capacity >= 2);
+    }
+
+    void
+    InterpolationBuffer::push(EntityID id,
+                              r64 time,
+                              const WorldP3D &pos,
+                              const Orientation &ornt) {
+        auto &samples = mSamples[id];
+        if (!samples.empty() && time <= samples.back().time) {
+            ++mStats.outOfOrder;
+            return;
+        }
+        if (samples.size() >= mConfig.capacity) {
+            samples.pop_front();
+        }
+        samples.push_back({time, pos, ornt});
+    }
+
+    bool
+    InterpolationBuffer::sample(EntityID id,
+                                r64 now,
+                                WorldP3D &pos,
+                                Orientation &ornt) {
+        auto it = mSamples.find(id);
+        if (it == mSamples.end() || it->second.empty()) {
+            return false;
+        }
+        const auto &samples = it->second;
+        auto renderTime = getRenderTime(now);
+
+        if (renderTime <= samples.front().time) {
+            pos = samples.front().pos;
+            ornt = samples.front().ornt;
+            return true;
+        }
+
+        // NOTE: First snapshot newer than the render time
+        auto next = std::upper_bound(samples.begin(), samples.end(), renderTime,
+                                     [](r64 time,
+                                        const Sample &s) { return time < s.time; });
+        if (next != samples.end()) {
+            const auto &a = *(next - 1);
+            const auto &b = *next;
+            auto t = (renderTime - a.time) / (b.time - a.time);
+
+            pos.x = interpolate(a.pos.x, b.pos.x, t);
+            pos.y = interpolate(a.pos.y, b.pos.y, t);
+            pos.z = interpolate(a.pos.z, b.pos.z, t);
+            ornt.value = static_cast<r32>(a.ornt.value + angleDelta(a.ornt.value, b.ornt.value) * t);
+
+            ++mStats.interpolated;
+            return true;
+        }
+
+        const auto &last = samples.back();
+        if (samples.size() < 2) {
+            pos = last.pos;
+            ornt = last.ornt;
+            ++mStats.starved;
+            return true;
+        }
+
+        // NOTE: Ran out of snapshots, keep going with the velocity between the last two.
+        const auto &previous = samples[samples.size() - 2];
+        auto elapsed = renderTime - last.time;
+        if (elapsed > mConfig.maxExtrapolation) {
+            elapsed = mConfig.maxExtrapolation;
+            ++mStats.starved;
+        } else {
+            ++mStats.extrapolated;
+        }
+        auto t = 1 + elapsed / (last.time - previous.time);
+
+        pos.x = interpolate(previous.pos.x, last.pos.x, t);
+        pos.y = interpolate(previous.pos.y, last.pos.y, t);
+        pos.z = last.pos.z;
+        ornt.value = static_cast<r32>(previous.ornt.value + angleDelta(previous.ornt.value, last.ornt.value) * t);
+        return true;
+    }
+
+    void
+    InterpolationBuffer::prune(r64 now) {
+        auto renderTime = getRenderTime(now);
+        for (auto &&entity: mSamples) {
+            auto &samples = entity.second;
+            // NOTE: Keep the last snapshot before the render time, it is the start of the current interpolation,
+            // and always two for extrapolation.
+            while (samples.size() > 2 && samples[1].time <= renderTime) {
+                samples.pop_front();
+            }
+        }
+    }
+
+    void
+    InterpolationBuffer::remove(EntityID id) {
+        mSamples.erase(id);
+    }
+
+    void
+    InterpolationBuffer::clear() {
+        mSamples.clear();
+    }
+
+    r64
+    InterpolationBuffer::getRenderTime(r64 now) const {
+        return now - mConfig.delay;
+    }
+
+    const InterpolationStats &
+    InterpolationBuffer::getStats() const {
+        return mStats;
+    }
+}
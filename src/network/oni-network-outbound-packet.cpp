@@ -0,0 +1,101 @@
+#include <oni-core/network/oni-network-outbound-packet.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <enet/enet.h>
+
+
+namespace oni {
+    OutboundPacket::OutboundPacket(PacketType type,
+                                   u32 enetFlags,
+                                   size capacity) : mType(type), mStream(this) {
+        capacity = std::max<size>(capacity, 1);
+        mPacket = enet_packet_create(nullptr, capacity, enetFlags);
+        assert(mPacket);
+
+        auto *data = reinterpret_cast<c8 *>(mPacket->data);
+        setp(data, data + capacity);
+        data[0] = static_cast<c8>(type);
+        pbump(1);
+    }
+
+    OutboundPacket::~OutboundPacket() {
+        if (mPacket) {
+            enet_packet_destroy(mPacket);
+        }
+    }
+
+    std::ostream &
+    OutboundPacket::stream() {
+        return mStream;
+    }
+
+    void
+    OutboundPacket::write(const void *data,
+                          size size) {
+        xsputn(static_cast<const c8 *>(data), static_cast<std::streamsize>(size));
+    }
+
+    PacketType
+    OutboundPacket::getType() const {
+        return mType;
+    }
+
+    size
+    OutboundPacket::getSize() const {
+        return static_cast<size>(pptr() - pbase());
+    }
+
+    ENetPacket *
+    OutboundPacket::release() {
+        assert(mPacket);
+        auto result = enet_packet_resize(mPacket, getSize());
+        assert(result == 0);
+
+        auto *packet = mPacket;
+        mPacket = nullptr;
+        setp(nullptr, nullptr);
+        return packet;
+    }
+
+    void
+    OutboundPacket::grow(size minCapacity) {
+        assert(mPacket);
+        auto used = getSize();
+        auto capacity = std::max(minCapacity, static_cast<size>(epptr() - pbase()) * 2);
+        auto result = enet_packet_resize(mPacket, capacity);
+        assert(result == 0);
+
+        auto *data = reinterpret_cast<c8 *>(mPacket->data);
+        setp(data, data + capacity);
+        pbump(static_cast<int>(used));
+    }
+
+    OutboundPacket::int_type
+    OutboundPacket::overflow(int_type c) {
+        if (traits_type::eq_int_type(c, traits_type::eof())) {
+            return traits_type::not_eof(c);
+        }
+        grow(getSize() + 1);
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+        return c;
+    }
+
+    std::streamsize
+    OutboundPacket::xsputn(const char_type *data,
+                           std::streamsize count) {
+        if (count <= 0) {
+            return 0;
+        }
+        auto needed = getSize() + static_cast<size>(count);
+        if (pptr() + count > epptr()) {
+            grow(needed);
+        }
+        std::memcpy(pptr(), data, static_cast<size>(count));
+        pbump(static_cast<int>(count));
+        return count;
+    }
+}
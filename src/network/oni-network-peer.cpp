@@ -1,17 +1,51 @@
 #include <oni-core/network/oni-network-peer.h>
 
+#include <algorithm>
+
 #include <enet/enet.h>
 
+#include <oni-core/util/oni-util-profiler.h>
+
+
+namespace {
+    // NOTE: Most packets are small, big ones grow the hint of their type after the first send.
+    constexpr oni::u32 PACKET_DEFAULT_SIZE_HINT = 64;
+
+    enet_uint32
+    toPacketFlags(oni::DeliveryMode mode) {
+        switch (mode) {
+            case oni::DeliveryMode::RELIABLE: {
+                return ENET_PACKET_FLAG_RELIABLE;
+            }
+            case oni::DeliveryMode::UNRELIABLE_SEQUENCED: {
+                // NOTE: Unreliable packets are sequenced per channel by default in ENet. Allow fragments to be
+                // sent unreliably as well, otherwise big snapshots are silently upgraded to reliable.
+                return ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+            }
+            case oni::DeliveryMode::UNRELIABLE: {
+                return ENET_PACKET_FLAG_UNSEQUENCED | ENET_PACKET_FLAG_UNRELIABLE_FRAGMENT;
+            }
+            default: {
+                assert(false);
+                return ENET_PACKET_FLAG_RELIABLE;
+            }
+        }
+    }
+}
 
 namespace oni {
-    Peer::Peer() = default;
+    Peer::Peer() {
+        initPacketDelivery();
+    }
 
     Peer::Peer(const Address *address,
                u8 peerCount,
                u8 channelLimit,
                u32 incomingBandwidth,
                u32 outgoingBandwidth) {
+        initPacketDelivery();
 
+        assert(channelLimit >= NumNetworkChannels);
         auto result = enet_initialize();
         if (result) {
             throw std::runtime_error("An error occurred while initializing server.\n");
@@ -39,6 +73,7 @@ namespace oni {
 
     void
     Peer::flush() {
+        ONI_PROFILE_ZONE("Peer::flush");
         enet_host_flush(mEnetHost);
 
         auto elapsed = mUploadTimer.elapsedInSeconds();
@@ -51,6 +86,7 @@ namespace oni {
 
     void
     Peer::poll() {
+        ONI_PROFILE_ZONE("Peer::poll");
         ENetEvent event;
 
         while (enet_host_service(mEnetHost, &event, 0) > 0) {
@@ -84,7 +120,10 @@ namespace oni {
                     auto dataHeadless = event.packet->dataLength - 1;
                     data += 1;
 
+                    auto handleStart = Timer::now();
                     handle(event.peer, data, dataHeadless, header);
+                    auto handleNS = std::chrono::nanoseconds(Timer::now() - handleStart).count();
+                    mStats.recordReceived(header, event.packet->dataLength, static_cast<u64>(handleNS));
 
                     enet_packet_destroy(event.packet);
                     break;
@@ -112,6 +151,10 @@ namespace oni {
             mTotalDownload = 0;
             mDownloadTimer.restart();
         }
+
+        if (mStatsLogInterval > 0 && mStatsLogTimer.elapsedInSeconds() >= mStatsLogInterval) {
+            logStats();
+        }
     }
 
     PacketType
@@ -125,6 +168,36 @@ namespace oni {
     }
 
 
+    void
+    Peer::initPacketDelivery() {
+        for (size i = 0; i < mPacketDelivery.size(); ++i) {
+            mPacketDelivery[i] = defaultPacketDelivery(static_cast<PacketType>(i));
+        }
+        mPacketSizeHints.fill(PACKET_DEFAULT_SIZE_HINT);
+    }
+
+    void
+    Peer::setPacketDelivery(PacketType type,
+                            const PacketDelivery &delivery) {
+        assert(enumCast(delivery.channel) < NumNetworkChannels);
+        mPacketDelivery[enumCast(type)] = delivery;
+    }
+
+    const PacketDelivery &
+    Peer::getPacketDelivery(PacketType type) const {
+        return mPacketDelivery[enumCast(type)];
+    }
+
+    ENetPacket *
+    Peer::createPacket(const void *data,
+                       size size,
+                       const PacketDelivery &delivery,
+                       u32 extraFlags) {
+        auto *packet = enet_packet_create(data, size, toPacketFlags(delivery.mode) | extraFlags);
+        assert(packet);
+        return packet;
+    }
+
     void
     Peer::send(const u8 *data,
                size size,
@@ -133,13 +206,82 @@ namespace oni {
             return;
         }
 
-        ENetPacket *packetToServer = enet_packet_create(data, size, ENET_PACKET_FLAG_RELIABLE |
-                                                                    ENET_PACKET_FLAG_NO_ALLOCATE);
-        assert(packetToServer);
-        auto success = enet_peer_send(peer, 0, packetToServer);
+        const auto &delivery = getPacketDelivery(getHeader(data));
+        auto *packetToServer = createPacket(data, size, delivery, ENET_PACKET_FLAG_NO_ALLOCATE);
+        auto success = enet_peer_send(peer, enumCast(delivery.channel), packetToServer);
         assert(success == 0);
 
         mTotalUpload += size;
+        mStats.recordSent(getHeader(data), size);
+    }
+
+    OutboundPacket
+    Peer::beginPacket(PacketType type) {
+        const auto &delivery = getPacketDelivery(type);
+        return OutboundPacket(type, toPacketFlags(delivery.mode), mPacketSizeHints[enumCast(type)]);
+    }
+
+    void
+    Peer::updateSizeHint(const OutboundPacket &packet) {
+        // NOTE: A bit of headroom so packets that slowly grow don't resize every time
+        auto size = static_cast<u32>(packet.getSize());
+        mPacketSizeHints[enumCast(packet.getType())] = std::max(size + size / 8, PACKET_DEFAULT_SIZE_HINT);
+    }
+
+    void
+    Peer::send(OutboundPacket &&packet,
+               ENetPeer *peer) {
+        const auto &delivery = getPacketDelivery(packet.getType());
+        auto size = packet.getSize();
+        updateSizeHint(packet);
+
+        auto *packetToPeer = packet.release();
+        auto success = enet_peer_send(peer, enumCast(delivery.channel), packetToPeer);
+        if (success != 0) {
+            assert(false);
+            enet_packet_destroy(packetToPeer);
+            return;
+        }
+
+        mTotalUpload += size;
+        mStats.recordSent(packet.getType(), size);
+    }
+
+    void
+    Peer::broadcast(OutboundPacket &&packet) {
+        const auto &delivery = getPacketDelivery(packet.getType());
+        auto size = packet.getSize();
+        updateSizeHint(packet);
+
+        enet_host_broadcast(mEnetHost, enumCast(delivery.channel), packet.release());
+
+        mTotalUpload += size;
+        mStats.recordSent(packet.getType(), size, static_cast<u32>(mPeers.size()));
+    }
+
+    void
+    Peer::multicast(OutboundPacket &&packet,
+                    const std::vector<ENetPeer *> &peers) {
+        const auto &delivery = getPacketDelivery(packet.getType());
+        auto size = packet.getSize();
+        updateSizeHint(packet);
+
+        auto *packetToPeers = packet.release();
+        auto sent = u32{0};
+        for (auto *peer: peers) {
+            auto success = enet_peer_send(peer, enumCast(delivery.channel), packetToPeers);
+            assert(success == 0);
+            if (success == 0) {
+                mTotalUpload += size;
+                ++sent;
+            }
+        }
+        mStats.recordSent(packet.getType(), size, sent);
+
+        // NOTE: Every peer that queued the packet holds a reference and frees it once sent
+        if (!packetToPeers->referenceCount) {
+            enet_packet_destroy(packetToPeers);
+        }
     }
 
     void
@@ -150,14 +292,9 @@ namespace oni {
             return;
         }
 
-        data.insert(0, 1, static_cast<std::underlying_type<PacketType>::type>(type));
-
-        ENetPacket *packetToServer = enet_packet_create(data.c_str(), data.size(), ENET_PACKET_FLAG_RELIABLE);
-        assert(packetToServer);
-        auto success = enet_peer_send(peer, 0, packetToServer);
-        assert(success == 0);
-
-        mTotalUpload += data.size();
+        auto packet = beginPacket(type);
+        packet.write(data.data(), data.size());
+        send(std::move(packet), peer);
     }
 
     void
@@ -168,19 +305,16 @@ namespace oni {
             return;
         }
 
-        data.insert(0, 1, static_cast<std::underlying_type<PacketType>::type>(type));
-        ENetPacket *packetToPeers = enet_packet_create(data.c_str(), data.size(), ENET_PACKET_FLAG_RELIABLE);
-        assert(packetToPeers);
-        enet_host_broadcast(mEnetHost, 0, packetToPeers);
-
-        mTotalUpload += data.size();
+        auto packet = beginPacket(type);
+        packet.write(data.data(), data.size());
+        broadcast(std::move(packet));
     }
 
     void
     Peer::registerPacketHandler(PacketType type,
                                 std::function<
                                         void(const std::string &,
-                                             const std::string &)> &&handler) {
+                                             std::string_view)> &&handler) {
         assert(mPacketHandlers.find(type) == mPacketHandlers.end());
         mPacketHandlers[type] = std::move(handler);
     }
@@ -204,4 +338,53 @@ namespace oni {
     Peer::getUploadKBPS() const {
         return mUploadBPS / (1000 * 1);
     }
+
+    const NetworkStats &
+    Peer::getStats() const {
+        return mStats;
+    }
+
+    void
+    Peer::recordDropped(PacketType type) {
+        mStats.recordDropped(type);
+    }
+
+    bool
+    Peer::getConnectionStats(const std::string &peerID,
+                             ConnectionStats &stats) const {
+        auto peer = mPeers.find(peerID);
+        if (peer == mPeers.end()) {
+            return false;
+        }
+        const auto *enetPeer = peer->second;
+        stats.roundTripTimeMS = enetPeer->roundTripTime;
+        stats.lowestRoundTripTimeMS = enetPeer->lowestRoundTripTime;
+        stats.jitterMS = enetPeer->roundTripTimeVariance;
+        stats.packetLoss = static_cast<r32>(enetPeer->packetLoss) / ENET_PEER_PACKET_LOSS_SCALE;
+        stats.packetThrottle = static_cast<r32>(enetPeer->packetThrottle) / ENET_PEER_PACKET_THROTTLE_SCALE;
+        stats.packetsSent = enetPeer->packetsSent;
+        stats.packetsLost = enetPeer->packetsLost;
+        return true;
+    }
+
+    void
+    Peer::setStatsLogInterval(r64 seconds) {
+        mStatsLogInterval = seconds;
+        mStatsLogTimer.restart();
+    }
+
+    void
+    Peer::logStats() {
+        auto elapsed = mStatsLogTimer.elapsedInSeconds();
+        mStatsLogTimer.restart();
+
+        printf("Network up %.1fKB/s down %.1fKB/s: %s\n", getUploadKBPS(), getDownloadKBPS(),
+               mStats.summarize(elapsed).c_str());
+        for (auto &&peer: mPeers) {
+            auto stats = ConnectionStats{};
+            getConnectionStats(peer.first, stats);
+            printf("Peer %s rtt %ums jitter %ums loss %.1f%% throttle %.0f%%\n", peer.first.c_str(),
+                   stats.roundTripTimeMS, stats.jitterMS, stats.packetLoss * 100, stats.packetThrottle * 100);
+        }
+    }
 }
@@ -0,0 +1,261 @@
+#include <oni-core/network/oni-network-replication.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+#include <oni-core/component/oni-component-geometry.h>
+#include <oni-core/component/oni-component-physics.h>
+#include <oni-core/entities/oni-entities-client-data-manager.h>
+#include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/network/oni-network-snapshot-delta.h>
+#include <oni-core/util/oni-util-bit-stream.h>
+#include <oni-core/util/oni-util-profiler.h>
+
+
+namespace {
+    const oni::EntitySnapshot *
+    findEntity(const oni::WorldSnapshot &snapshot,
+               oni::EntityID id,
+               oni::size &index) {
+        const auto &entities = snapshot.entities;
+        while (index < entities.size() && entities[index].id < id) {
+            ++index;
+        }
+        if (index < entities.size() && entities[index].id == id) {
+            return &entities[index];
+        }
+        return nullptr;
+    }
+
+    void
+    appendEntity(const oni::WorldSnapshot &from,
+                 const oni::EntitySnapshot &entity,
+                 oni::WorldSnapshot &to) {
+        auto copy = entity;
+        copy.offset = static_cast<oni::u32>(to.data.size());
+        const auto *data = from.data.data() + entity.offset;
+        to.data.insert(to.data.end(), data, data + entity.size);
+        to.entities.push_back(copy);
+    }
+}
+
+namespace oni {
+    ReplicationScheduler::ReplicationScheduler(const ReplicationConfig &config) : mConfig(config) {
+        assert(mConfig.sendRate > 0);
+        assert(mConfig.distanceScale > 0.f);
+    }
+
+    bool
+    ReplicationScheduler::tick(r64 dt) {
+        auto period = 1 / mConfig.sendRate;
+        mElapsed += dt;
+        if (mElapsed < period) {
+            return false;
+        }
+        mInterval = period;
+        mElapsed -= period;
+        // NOTE: After a long stall send once and start over instead of trying to catch up
+        if (mElapsed >= period) {
+            mElapsed = 0;
+        }
+        return true;
+    }
+
+    void
+    ReplicationScheduler::update(EntityManager &manager,
+                                 const ClientDataManager &clients) {
+        ONI_PROFILE_ZONE("ReplicationScheduler::update");
+        mEntities.clear();
+
+        auto view = manager.createView<WorldP3D>();
+        for (auto &&id: view) {
+            auto root = id;
+            while (manager.has<EntityAttachee>(root)) {
+                const auto &attachee = manager.get<EntityAttachee>(root);
+                if (attachee.mng != &manager || !manager.valid(attachee.id)) {
+                    break;
+                }
+                root = attachee.id;
+            }
+            // NOTE: Attached entities are positioned relative to their parent, they get its priority
+            if (!manager.has<WorldP3D>(root)) {
+                continue;
+            }
+            const auto &pos = manager.get<WorldP3D>(root);
+            auto info = EntityInfo{pos.x, pos.y, 0.f};
+            if (manager.has<Car>(root)) {
+                info.speed = static_cast<r32>(std::abs(manager.get<Car>(root).velocityAbsolute));
+            } else if (manager.has<Velocity>(root)) {
+                info.speed = std::abs(manager.get<Velocity>(root).current);
+            }
+            mEntities[id] = info;
+        }
+
+        const auto &cars = clients.getClientCarEntities();
+        for (auto client = mClients.begin(); client != mClients.end();) {
+            if (cars.find(client->first) == cars.end()) {
+                client = mClients.erase(client);
+            } else {
+                ++client;
+            }
+        }
+
+        for (auto &&car: cars) {
+            auto &client = mClients[car.first];
+            auto info = mEntities.find(car.second);
+            client.hasFocus = info != mEntities.end();
+            if (client.hasFocus) {
+                client.x = info->second.x;
+                client.y = info->second.y;
+            }
+        }
+    }
+
+    r32
+    ReplicationScheduler::priority(const ClientState &client,
+                                   EntityID id) const {
+        auto accumulated = std::lower_bound(client.priorities.begin(), client.priorities.end(), id,
+                                            [](const std::pair<EntityID, r32> &p,
+                                               EntityID value) { return p.first < value; });
+        auto result = r32{0};
+        if (accumulated != client.priorities.end() && accumulated->first == id) {
+            result = accumulated->second;
+        }
+
+        auto weight = r32{1};
+        auto info = mEntities.find(id);
+        if (info != mEntities.end()) {
+            weight += mConfig.speedWeight * info->second.speed;
+            if (client.hasFocus) {
+                auto dx = info->second.x - client.x;
+                auto dy = info->second.y - client.y;
+                weight /= 1 + std::sqrt(dx * dx + dy * dy) / mConfig.distanceScale;
+            }
+        }
+
+        auto interval = mInterval > 0 ? mInterval : 1 / mConfig.sendRate;
+        return result + static_cast<r32>(interval) * weight;
+    }
+
+    void
+    ReplicationScheduler::select(const std::string &clientID,
+                                 const WorldSnapshot &world,
+                                 const WorldSnapshot *baseline,
+                                 WorldSnapshot &out) {
+        ONI_PROFILE_ZONE("ReplicationScheduler::select");
+        auto &client = mClients[clientID];
+        const auto &sent = client.view;
+        auto budgetBits = i64{client.bytesPerSend ? client.bytesPerSend : mConfig.bytesPerSend} * 8;
+
+        mCandidates.clear();
+        mSelected.assign(world.entities.size(), 0);
+        mPriorities.clear();
+
+        // NOTE: Everything is charged as if it repeats what was sent last, picking an entity charges the
+        // difference.
+        // NOTE: Sequences and entity count of the delta header
+        auto usedBits = i64{64 + 6 + bitWidth(static_cast<u32>(world.entities.size()))};
+        mExtraBits.clear();
+        auto sentIdx = size{0};
+        auto baseIdx = size{0};
+        auto prevID = EntityID{0};
+        for (u32 i = 0; i < world.entities.size(); ++i) {
+            const auto &entity = world.entities[i];
+            const auto *data = world.data.data() + entity.offset;
+            auto idBits = 6 + bitWidth(entity.id - prevID);
+            prevID = entity.id;
+
+            const auto *base = baseline ? findEntity(*baseline, entity.id, baseIdx) : nullptr;
+            const auto *last = findEntity(sent, entity.id, sentIdx);
+
+            auto lastBits = i64{0};
+            if (last) {
+                const auto *lastData = sent.data.data() + last->offset;
+                const u8 *lastBase = nullptr;
+                if (base && base->componentMask == last->componentMask) {
+                    lastBase = baseline->data.data() + base->offset;
+                }
+                lastBits = idBits + entityDeltaBits(lastBase, *last, lastData);
+                usedBits += lastBits;
+
+                if (last->componentMask == entity.componentMask && std::memcmp(lastData, data, entity.size) == 0) {
+                    mSelected[i] = 1;
+                    mExtraBits.push_back(0);
+                    continue;
+                }
+            }
+
+            const u8 *currentBase = nullptr;
+            if (base && base->componentMask == entity.componentMask) {
+                currentBase = baseline->data.data() + base->offset;
+            }
+            mExtraBits.push_back(idBits + entityDeltaBits(currentBase, entity, data) - lastBits);
+            mCandidates.push_back({priority(client, entity.id), i});
+        }
+
+        std::sort(mCandidates.begin(), mCandidates.end(),
+                  [](const Candidate &a,
+                     const Candidate &b) {
+                      return a.priority > b.priority || (a.priority == b.priority && a.index < b.index);
+                  });
+
+        auto picked = false;
+        for (auto &&candidate: mCandidates) {
+            auto extra = mExtraBits[candidate.index];
+            // NOTE: At least one per send, otherwise an entity larger than the budget would never go out
+            if (!picked || usedBits + extra <= budgetBits) {
+                mSelected[candidate.index] = 1;
+                usedBits += extra;
+                picked = true;
+                ++client.stats.entitiesSent;
+            } else {
+                mPriorities.emplace_back(world.entities[candidate.index].id, candidate.priority);
+                ++client.stats.entitiesDeferred;
+            }
+        }
+        std::sort(mPriorities.begin(), mPriorities.end());
+        client.priorities.swap(mPriorities);
+
+        out.sequence = world.sequence;
+        out.entities.clear();
+        out.data.clear();
+        out.entities.reserve(world.entities.size());
+        sentIdx = 0;
+        for (u32 i = 0; i < world.entities.size(); ++i) {
+            const auto &entity = world.entities[i];
+            if (mSelected[i]) {
+                appendEntity(world, entity, out);
+            } else if (const auto *last = findEntity(sent, entity.id, sentIdx)) {
+                appendEntity(sent, *last, out);
+            }
+        }
+        client.view.sequence = out.sequence;
+        client.view.entities = out.entities;
+        client.view.data = out.data;
+
+        ++client.stats.sends;
+        client.stats.estimatedBytes += static_cast<u64>(std::max(usedBits, i64{0}) + 7) / 8;
+    }
+
+    void
+    ReplicationScheduler::setClientBudget(const std::string &clientID,
+                                          u32 bytesPerSend) {
+        mClients[clientID].bytesPerSend = bytesPerSend;
+    }
+
+    void
+    ReplicationScheduler::removeClient(const std::string &clientID) {
+        mClients.erase(clientID);
+    }
+
+    const ReplicationStats *
+    ReplicationScheduler::getStats(const std::string &clientID) const {
+        auto client = mClients.find(clientID);
+        if (client == mClients.end() || !client->second.stats.sends) {
+            return nullptr;
+        }
+        return &client->second.stats;
+    }
+}
@@ -1,18 +1,24 @@
 #include <oni-core/network/oni-network-server.h>
 
+#include <algorithm>
+
 #include <enet/enet.h>
 
+#include <oni-core/entities/oni-entities-client-data-manager.h>
 #include <oni-core/entities/oni-entities-manager.h>
 #include <oni-core/entities/oni-entities-serialization.h>
 #include <oni-core/entities/oni-entities-serialization-network.h>
 #include <oni-core/component/oni-component-audio.h>
+#include <oni-core/network/oni-network-interest.h>
+#include <oni-core/network/oni-network-replication.h>
+#include <oni-core/util/oni-util-bit-stream.h>
 
 
 namespace oni {
     Server::Server(const Address *address,
                    u8 numClients,
                    u8 numChannels) :
-            Peer::Peer(address, numClients, numChannels, 0, 0) {
+            Peer::Peer(address, numClients, std::max(numChannels, NumNetworkChannels), 0, 0) {
     }
 
     Server::Server() = default;
@@ -26,6 +32,10 @@ namespace oni {
     void
     Server::postDisconnectHook(const ENetEvent *event) {
         auto clientID = getPeerID(*event->peer);
+        mAckedSnapshots.erase(clientID);
+        mPeerSnapshotHistory.erase(clientID);
+        mInputSequences.erase(clientID);
+        mAppliedInputSequences.erase(clientID);
 
         mPostDisconnectHook(clientID);
     }
@@ -37,14 +47,10 @@ namespace oni {
                    PacketType header) {
         auto peerID = getPeerID(*peer);
         assert(mPacketHandlers.find(header) != mPacketHandlers.end() || header == PacketType::PING ||
-               header == PacketType::MESSAGE);
+               header == PacketType::MESSAGE || header == PacketType::SNAPSHOT_ACK);
         switch (header) {
             case (PacketType::PING): {
-                auto type = PacketType::PING;
-                auto pingData = std::string{};
-
-                send(type, pingData, peer);
-
+                send(beginPacket(PacketType::PING), peer);
                 break;
             }
             case (PacketType::MESSAGE): {
@@ -56,8 +62,24 @@ namespace oni {
                 break;
             }
             case (PacketType::CLIENT_INPUT): {
-                auto dataString = std::string(reinterpret_cast<char *>(data), size);
-                mPacketHandlers[PacketType::CLIENT_INPUT](peerID, dataString);
+                // NOTE: The handler only gets the Input, the sequence in front of it is consumed here.
+                auto buffer = MemoryInputBuffer(data, size);
+                auto stream = std::istream(&buffer);
+                auto packet = Packet_InputSequence{};
+                {
+                    cereal::PortableBinaryInputArchive input{stream};
+                    input(packet);
+                }
+                auto offset = static_cast<oni::size>(stream.tellg());
+                handleInputSequence(peerID, packet.sequence);
+
+                auto view = std::string_view(reinterpret_cast<const c8 *>(data) + offset, size - offset);
+                mPacketHandlers[PacketType::CLIENT_INPUT](peerID, view);
+                break;
+            }
+            case (PacketType::SNAPSHOT_ACK): {
+                auto packet = deserialize<Packet_SnapshotAck>(data, size);
+                handleSnapshotAck(peerID, packet.sequence);
                 break;
             }
             default: {
@@ -75,6 +97,12 @@ namespace oni {
         broadcast(type, std::move(data));
     }
 
+    void
+    Server::sendEntitiesAll(OutboundPacket &&packet) {
+        assert(packet.getType() == PacketType::REGISTRY_REPLACE_ALL_ENTITIES);
+        broadcast(std::move(packet));
+    }
+
     void
     Server::sendComponentsUpdate(EntityManager &manager,
                                  std::string &&data) {
@@ -83,6 +111,204 @@ namespace oni {
         broadcast(type, std::move(data));
     }
 
+    void
+    Server::sendComponentsUpdate(OutboundPacket &&packet) {
+        assert(packet.getType() == PacketType::REGISTRY_ONLY_COMPONENT_UPDATE);
+        broadcast(std::move(packet));
+    }
+
+    u32
+    Server::nextSnapshotSequence() {
+        ++mSnapshotSequence;
+        // NOTE: 0 means no baseline
+        if (!mSnapshotSequence) {
+            ++mSnapshotSequence;
+        }
+        return mSnapshotSequence;
+    }
+
+    void
+    Server::sendComponentsDelta(WorldSnapshot &&snapshot) {
+        snapshot.sequence = nextSnapshotSequence();
+
+        // NOTE: Clients that are in sync tend to share the same baseline, encode once per baseline and send the
+        // same packet to the ones that also share the applied input.
+        auto peersByBaseline = std::map<u32, std::map<u32, std::vector<ENetPeer *>>>{};
+        for (auto &&peer: mPeers) {
+            auto baselineSequence = u32{0};
+            auto acked = mAckedSnapshots.find(peer.first);
+            if (acked != mAckedSnapshots.end() && mSnapshotHistory.find(acked->second)) {
+                baselineSequence = acked->second;
+            }
+            peersByBaseline[baselineSequence][getAppliedInputSequence(peer.first)].push_back(peer.second);
+        }
+
+        for (auto &&group: peersByBaseline) {
+            encodeSnapshotDelta(mSnapshotHistory.find(group.first), snapshot, mDeltaWriter);
+
+            for (auto &&inputGroup: group.second) {
+                auto packet = beginPacket(PacketType::REGISTRY_COMPONENT_DELTA);
+                writeComponentsDelta(inputGroup.first, packet);
+                multicast(std::move(packet), inputGroup.second);
+            }
+        }
+
+        mSnapshotHistory.push(std::move(snapshot));
+    }
+
+    void
+    Server::writeComponentsDelta(u32 inputSequence,
+                                 OutboundPacket &packet) {
+        // NOTE: The input goes with the state that reflects it, the client reconciles its prediction with the pair
+        serialize(Packet_InputAck{inputSequence}, packet.stream());
+
+        const auto &data = mDeltaWriter.getData();
+        packet.write(data.data(), data.size());
+    }
+
+    void
+    Server::sendComponentsDelta(WorldSnapshot &&snapshot,
+                                const InterestManager &interest) {
+        sendComponentsDeltaPerPeer(std::move(snapshot), &interest, nullptr);
+    }
+
+    void
+    Server::sendComponentsDelta(WorldSnapshot &&snapshot,
+                                ReplicationScheduler &scheduler) {
+        sendComponentsDeltaPerPeer(std::move(snapshot), nullptr, &scheduler);
+    }
+
+    void
+    Server::sendComponentsDelta(WorldSnapshot &&snapshot,
+                                const InterestManager &interest,
+                                ReplicationScheduler &scheduler) {
+        sendComponentsDeltaPerPeer(std::move(snapshot), &interest, &scheduler);
+    }
+
+    void
+    Server::sendComponentsDeltaPerPeer(WorldSnapshot &&snapshot,
+                                       const InterestManager *interest,
+                                       ReplicationScheduler *scheduler) {
+        snapshot.sequence = nextSnapshotSequence();
+
+        for (auto &&peer: mPeers) {
+            auto &history = mPeerSnapshotHistory.try_emplace(peer.first, NETWORK_SNAPSHOT_HISTORY).first->second;
+
+            const WorldSnapshot *baseline = nullptr;
+            auto acked = mAckedSnapshots.find(peer.first);
+            if (acked != mAckedSnapshots.end()) {
+                baseline = history.find(acked->second);
+            }
+
+            const auto *world = &snapshot;
+            if (interest) {
+                interest->filter(peer.first, snapshot, mFiltered);
+                world = &mFiltered;
+            }
+
+            auto selected = WorldSnapshot{};
+            if (scheduler) {
+                scheduler->select(peer.first, *world, baseline, selected);
+            } else {
+                selected = *world;
+            }
+
+            encodeSnapshotDelta(baseline, selected, mDeltaWriter);
+            auto packet = beginPacket(PacketType::REGISTRY_COMPONENT_DELTA);
+            writeComponentsDelta(getAppliedInputSequence(peer.first), packet);
+            send(std::move(packet), peer.second);
+
+            history.push(std::move(selected));
+        }
+    }
+
+    void
+    Server::sendEntitiesEntered(const std::string &clientID,
+                                std::string &&data) {
+        auto peer = mPeers.find(clientID);
+        if (peer == mPeers.end()) {
+            return;
+        }
+        send(PacketType::REGISTRY_ENTITIES_ENTERED, data, peer->second);
+    }
+
+    void
+    Server::sendEntitiesEntered(const std::string &clientID,
+                                OutboundPacket &&packet) {
+        assert(packet.getType() == PacketType::REGISTRY_ENTITIES_ENTERED);
+        auto peer = mPeers.find(clientID);
+        if (peer == mPeers.end()) {
+            return;
+        }
+        send(std::move(packet), peer->second);
+    }
+
+    void
+    Server::sendEntitiesLeft(const std::string &clientID,
+                             const std::vector<EntityID> &entities) {
+        auto peer = mPeers.find(clientID);
+        if (peer == mPeers.end() || entities.empty()) {
+            return;
+        }
+        auto packet = beginPacket(PacketType::REGISTRY_ENTITIES_LEFT);
+        serialize(entities, packet.stream());
+        send(std::move(packet), peer->second);
+    }
+
+    void
+    Server::handleSnapshotAck(const std::string &peerID,
+                              u32 sequence) {
+        // NOTE: The baseline itself is looked up when it is used, it might be in the per peer history
+        if (!sequence || isNewerSequence(sequence, mSnapshotSequence)) {
+            return;
+        }
+        auto acked = mAckedSnapshots.find(peerID);
+        if (acked == mAckedSnapshots.end()) {
+            mAckedSnapshots.emplace(peerID, sequence);
+        } else if (isNewerSequence(sequence, acked->second)) {
+            acked->second = sequence;
+        }
+    }
+
+    void
+    Server::handleInputSequence(const std::string &peerID,
+                                u32 sequence) {
+        if (!sequence) {
+            return;
+        }
+        auto last = mInputSequences.find(peerID);
+        if (last == mInputSequences.end()) {
+            mInputSequences.emplace(peerID, sequence);
+        } else if (isNewerSequence(sequence, last->second)) {
+            last->second = sequence;
+        }
+    }
+
+    u32
+    Server::getInputSequence(const std::string &peerID) const {
+        auto sequence = mInputSequences.find(peerID);
+        if (sequence == mInputSequences.end()) {
+            return 0;
+        }
+        return sequence->second;
+    }
+
+    void
+    Server::setAppliedInputs(const ClientDataManager &clientDataManager) {
+        for (auto &&peer: mPeers) {
+            mAppliedInputSequences[peer.first] = clientDataManager.getAppliedInputSequence(peer.first);
+        }
+    }
+
+    u32
+    Server::getAppliedInputSequence(const std::string &peerID) const {
+        auto sequence = mAppliedInputSequences.find(peerID);
+        if (sequence == mAppliedInputSequences.end()) {
+            return 0;
+        }
+        return sequence->second;
+    }
+
     void
     Server::sendNewEntities(EntityManager &manager,
                             std::string &&data) {
@@ -92,46 +318,56 @@ namespace oni {
         broadcast(type, std::move(data));
     }
 
+    void
+    Server::sendNewEntities(OutboundPacket &&packet) {
+        assert(packet.getType() == PacketType::REGISTRY_ADD_NEW_ENTITIES);
+        broadcast(std::move(packet));
+    }
+
     void
     Server::broadcastDeletedEntities(EntityManager &manager) {
-        auto type = PacketType::REGISTRY_DESTROYED_ENTITIES;
-        auto data = serialize(manager.getDeletedEntities());
+        const auto &deletedEntities = manager.getDeletedEntities();
+        if (deletedEntities.empty()) {
+            return;
+        }
+
+        auto packet = beginPacket(PacketType::REGISTRY_DESTROYED_ENTITIES);
+        serialize(deletedEntities, packet.stream());
         manager.clearDeletedEntitiesList();
 
-        broadcast(type, std::move(data));
+        broadcast(std::move(packet));
     }
 
     void
     Server::sendCarEntityID(EntityID entityID,
                             const std::string &peerID) {
-        auto packet = Packet_EntityID{entityID};
-        auto data = oni::serialize(packet);
-        auto type = PacketType::CAR_ENTITY_ID;
+        auto packet = beginPacket(PacketType::CAR_ENTITY_ID);
+        serialize(Packet_EntityID{entityID}, packet.stream());
 
-        send(type, data, mPeers[peerID]);
+        send(std::move(packet), mPeers[peerID]);
     }
 
     void
     Server::handleEvent_Collision(const oni::Event_Collision &event) {
-        auto data = oni::serialize(event);
-        auto packetType = oni::PacketType::EVENT_COLLISION;
+        auto packet = beginPacket(PacketType::EVENT_COLLISION);
+        serialize(event, packet.stream());
 
-        broadcast(packetType, std::move(data));
+        broadcast(std::move(packet));
     }
 
     void
     Server::handleEvent_SoundPlay(const oni::Event_SoundPlay &event) {
-        auto data = oni::serialize(event);
-        auto packetType = oni::PacketType::EVENT_SOUND_PLAY;
+        auto packet = beginPacket(PacketType::EVENT_SOUND_PLAY);
+        serialize(event, packet.stream());
 
-        broadcast(packetType, std::move(data));
+        broadcast(std::move(packet));
     }
 
     void
     Server::handleEvent_RocketLaunch(const oni::Event_RocketLaunch &event) {
-        auto data = oni::serialize(event);
-        auto packetType = oni::PacketType::EVENT_ROCKET_LAUNCH;
+        auto packet = beginPacket(PacketType::EVENT_ROCKET_LAUNCH);
+        serialize(event, packet.stream());
 
-        broadcast(packetType, std::move(data));
+        broadcast(std::move(packet));
     }
 }
@@ -0,0 +1,229 @@
+#include <oni-core/network/oni-network-snapshot-delta.h>
+
+#include <cassert>
+#include <cstring>
+
+#include <oni-core/util/oni-util-bit-stream.h>
+#include <oni-core/util/oni-util-profiler.h>
+
+
+namespace {
+    constexpr oni::u32 MAX_WORDS_PER_ENTITY = 1024;
+
+    oni::u32
+    loadWord(const oni::u8 *data) {
+        auto result = oni::u32{};
+        std::memcpy(&result, data, sizeof(result));
+        return result;
+    }
+
+    void
+    storeWord(oni::u8 *data,
+              oni::u32 value) {
+        std::memcpy(data, &value, sizeof(value));
+    }
+}
+
+namespace oni {
+    SnapshotHistory::SnapshotHistory(u32 capacity) {
+        assert(capacity);
+        mSnapshots.resize(capacity);
+    }
+
+    void
+    SnapshotHistory::push(WorldSnapshot &&snapshot) {
+        assert(snapshot.sequence);
+        auto &slot = mSnapshots[snapshot.sequence % mSnapshots.size()];
+        slot = std::move(snapshot);
+    }
+
+    const WorldSnapshot *
+    SnapshotHistory::find(u32 sequence) const {
+        if (!sequence) {
+            return nullptr;
+        }
+        const auto &slot = mSnapshots[sequence % mSnapshots.size()];
+        if (slot.sequence != sequence) {
+            return nullptr;
+        }
+        return &slot;
+    }
+
+    void
+    SnapshotHistory::clear() {
+        for (auto &&snapshot: mSnapshots) {
+            snapshot.sequence = 0;
+        }
+    }
+
+    void
+    encodeSnapshotDelta(const WorldSnapshot *baseline,
+                        const WorldSnapshot &current,
+                        BitWriter &writer) {
+        ONI_PROFILE_ZONE("encodeSnapshotDelta");
+        writer.clear();
+        writer.write(current.sequence, 32);
+        writer.write(baseline ? baseline->sequence : 0, 32);
+        writer.writeVarBits(static_cast<u32>(current.entities.size()));
+
+        auto prevID = EntityID{0};
+        auto baseIdx = size{0};
+        for (auto &&entity: current.entities) {
+            assert(entity.id >= prevID);
+            writer.writeVarBits(entity.id - prevID);
+            prevID = entity.id;
+
+            const auto *curr = current.data.data() + entity.offset;
+            const u8 *base = nullptr;
+            if (baseline) {
+                const auto &entities = baseline->entities;
+                while (baseIdx < entities.size() && entities[baseIdx].id < entity.id) {
+                    ++baseIdx;
+                }
+                // NOTE: An entity that gained or lost a component is sent in full, it is rare enough.
+                if (baseIdx < entities.size() && entities[baseIdx].id == entity.id &&
+                    entities[baseIdx].componentMask == entity.componentMask) {
+                    base = baseline->data.data() + entities[baseIdx].offset;
+                }
+            }
+
+            writer.writeBit(base != nullptr);
+            if (base) {
+                auto changed = std::memcmp(curr, base, entity.size) != 0;
+                writer.writeBit(changed);
+                if (!changed) {
+                    continue;
+                }
+            } else {
+                writer.writeVarBits(entity.componentMask);
+                writer.writeVarBits(entity.size / 4);
+            }
+
+            for (u32 i = 0; i < entity.size; i += 4) {
+                auto delta = loadWord(curr + i) ^ (base ? loadWord(base + i) : 0);
+                writer.writeBit(delta != 0);
+                if (delta) {
+                    auto width = bitWidth(delta);
+                    writer.write(width - 1u, 5);
+                    writer.write(delta, width);
+                }
+            }
+        }
+        writer.finish();
+    }
+
+    u32
+    entityDeltaBits(const u8 *base,
+                    const EntitySnapshot &entity,
+                    const u8 *data) {
+        // NOTE: Has to match encodeSnapshotDelta()
+        auto bits = u32{1};
+        if (base) {
+            ++bits;
+            if (std::memcmp(data, base, entity.size) == 0) {
+                return bits;
+            }
+        } else {
+            bits += 6 + bitWidth(entity.componentMask);
+            bits += 6 + bitWidth(entity.size / 4);
+        }
+
+        for (u32 i = 0; i < entity.size; i += 4) {
+            auto delta = loadWord(data + i) ^ (base ? loadWord(base + i) : 0);
+            ++bits;
+            if (delta) {
+                bits += 5 + bitWidth(delta);
+            }
+        }
+        return bits;
+    }
+
+    bool
+    decodeSnapshotDelta(const SnapshotHistory &history,
+                        const u8 *data,
+                        size size,
+                        WorldSnapshot &out) {
+        ONI_PROFILE_ZONE("decodeSnapshotDelta");
+        auto reader = BitReader(data, size);
+        auto sequence = reader.read(32);
+        auto baselineSequence = reader.read(32);
+        auto count = reader.readVarBits();
+        // NOTE: Every entity takes at least a byte
+        if (!reader.good() || !sequence || count > size) {
+            return false;
+        }
+
+        const WorldSnapshot *baseline = nullptr;
+        if (baselineSequence) {
+            baseline = history.find(baselineSequence);
+            if (!baseline) {
+                return false;
+            }
+        }
+
+        out.sequence = sequence;
+        out.entities.clear();
+        out.data.clear();
+        out.entities.reserve(count);
+
+        auto prevID = EntityID{0};
+        auto baseIdx = oni::size{0};
+        for (u32 e = 0; e < count; ++e) {
+            auto gap = reader.readVarBits();
+            if (e && !gap) {
+                return false;
+            }
+            auto entity = EntitySnapshot{};
+            entity.id = prevID + gap;
+            prevID = entity.id;
+
+            const u8 *base = nullptr;
+            if (reader.readBit()) {
+                if (!baseline) {
+                    return false;
+                }
+                const auto &entities = baseline->entities;
+                while (baseIdx < entities.size() && entities[baseIdx].id < entity.id) {
+                    ++baseIdx;
+                }
+                if (baseIdx >= entities.size() || entities[baseIdx].id != entity.id) {
+                    return false;
+                }
+                entity.componentMask = entities[baseIdx].componentMask;
+                entity.size = entities[baseIdx].size;
+                base = baseline->data.data() + entities[baseIdx].offset;
+
+                if (!reader.readBit()) {
+                    entity.offset = static_cast<u32>(out.data.size());
+                    out.data.insert(out.data.end(), base, base + entity.size);
+                    out.entities.push_back(entity);
+                    continue;
+                }
+            } else {
+                entity.componentMask = reader.readVarBits();
+                auto words = reader.readVarBits();
+                if (words > MAX_WORDS_PER_ENTITY) {
+                    return false;
+                }
+                entity.size = words * 4;
+            }
+
+            entity.offset = static_cast<u32>(out.data.size());
+            out.data.resize(entity.offset + entity.size);
+            auto *curr = out.data.data() + entity.offset;
+            for (u32 i = 0; i < entity.size; i += 4) {
+                auto delta = u32{0};
+                if (reader.readBit()) {
+                    auto width = static_cast<u8>(reader.read(5) + 1);
+                    delta = reader.read(width);
+                }
+                storeWord(curr + i, delta ^ (base ? loadWord(base + i) : 0));
+            }
+            if (!reader.good()) {
+                return false;
+            }
+            out.entities.push_back(entity);
+        }
+        return reader.good();
+    }
+}
@@ -0,0 +1,150 @@
+#include <oni-core/network/oni-network-stats.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include <oni-core/math/oni-math-function.h>
+#include <oni-core/util/oni-util-bit-stream.h>
+
+
+namespace {
+    // NOTE: Upper bound of the bucket the median payload falls in, good enough to tell small from big packets.
+    oni::u64
+    medianSize(const std::array<oni::u32, oni::NumPacketSizeBuckets> &sizes,
+               oni::u64 count) {
+        auto seen = oni::u64{0};
+        for (oni::u8 i = 0; i < oni::NumPacketSizeBuckets; ++i) {
+            seen += sizes[i];
+            if (seen * 2 >= count) {
+                return i ? oni::u64{1} << i : 0;
+            }
+        }
+        return oni::u64{1} << oni::NumPacketSizeBuckets;
+    }
+
+    void
+    add(oni::PacketTypeStats &stats,
+        bool sent,
+        oni::size bytes,
+        oni::u32 count,
+        oni::u64 handleNS) {
+        auto bucket = oni::packetSizeBucket(bytes);
+        if (sent) {
+            stats.packetsSent += count;
+            stats.bytesSent += bytes * count;
+            stats.sentSizes[bucket] += count;
+        } else {
+            stats.packetsReceived += count;
+            stats.bytesReceived += bytes * count;
+            stats.receivedSizes[bucket] += count;
+            stats.handleNS += handleNS;
+        }
+    }
+}
+
+namespace oni {
+    u8
+    packetSizeBucket(size bytes) {
+        if (bytes >= (size{1} << (NumPacketSizeBuckets - 2))) {
+            return NumPacketSizeBuckets - 1;
+        }
+        return bitWidth(static_cast<u32>(bytes));
+    }
+
+    const c8 *
+    packetTypeName(PacketType type) {
+        switch (type) {
+            case PacketType::UNKNOWN: return "UNKNOWN";
+            case PacketType::PING: return "PING";
+            case PacketType::MESSAGE: return "MESSAGE";
+            case PacketType::SETUP_SESSION: return "SETUP_SESSION";
+            case PacketType::CAR_ENTITY_ID: return "CAR_ENTITY_ID";
+            case PacketType::CLIENT_INPUT: return "CLIENT_INPUT";
+            case PacketType::REGISTRY_REPLACE_ALL_ENTITIES: return "REGISTRY_REPLACE_ALL_ENTITIES";
+            case PacketType::REGISTRY_ONLY_COMPONENT_UPDATE: return "REGISTRY_ONLY_COMPONENT_UPDATE";
+            case PacketType::REGISTRY_ADD_NEW_ENTITIES: return "REGISTRY_ADD_NEW_ENTITIES";
+            case PacketType::REGISTRY_DESTROYED_ENTITIES: return "REGISTRY_DESTROYED_ENTITIES";
+            case PacketType::EVENT_SOUND_PLAY: return "EVENT_SOUND_PLAY";
+            case PacketType::EVENT_COLLISION: return "EVENT_COLLISION";
+            case PacketType::EVENT_ROCKET_LAUNCH: return "EVENT_ROCKET_LAUNCH";
+            case PacketType::REGISTRY_COMPONENT_DELTA: return "REGISTRY_COMPONENT_DELTA";
+            case PacketType::SNAPSHOT_ACK: return "SNAPSHOT_ACK";
+            case PacketType::REGISTRY_ENTITIES_ENTERED: return "REGISTRY_ENTITIES_ENTERED";
+            case PacketType::REGISTRY_ENTITIES_LEFT: return "REGISTRY_ENTITIES_LEFT";
+        }
+        return "INVALID";
+    }
+
+    void
+    NetworkStats::recordSent(PacketType type,
+                             size bytes,
+                             u32 count) {
+        add(mTotal[enumCast(type)], true, bytes, count, 0);
+        add(mWindow[enumCast(type)], true, bytes, count, 0);
+    }
+
+    void
+    NetworkStats::recordReceived(PacketType type,
+                                 size bytes,
+                                 u64 handleNS) {
+        add(mTotal[enumCast(type)], false, bytes, 1, handleNS);
+        add(mWindow[enumCast(type)], false, bytes, 1, handleNS);
+    }
+
+    void
+    NetworkStats::recordDropped(PacketType type) {
+        ++mTotal[enumCast(type)].packetsDropped;
+        ++mWindow[enumCast(type)].packetsDropped;
+    }
+
+    const PacketTypeStats &
+    NetworkStats::get(PacketType type) const {
+        return mTotal[enumCast(type)];
+    }
+
+    std::string
+    NetworkStats::summarize(r64 elapsedSeconds) {
+        auto types = std::vector<u8>{};
+        for (size i = 0; i < mWindow.size(); ++i) {
+            if (mWindow[i].packetsSent || mWindow[i].packetsReceived) {
+                types.push_back(static_cast<u8>(i));
+            }
+        }
+        std::sort(types.begin(), types.end(), [this](u8 a,
+                                                     u8 b) {
+            return mWindow[a].bytesSent + mWindow[a].bytesReceived > mWindow[b].bytesSent + mWindow[b].bytesReceived;
+        });
+
+        auto seconds = max(elapsedSeconds, 1e-3);
+        auto result = std::string{};
+        c8 buffer[256];
+        for (auto type: types) {
+            const auto &stats = mWindow[type];
+            std::snprintf(buffer, sizeof(buffer),
+                          "%s%s out %.1fKB/s %.0f/s ~%lluB in %.1fKB/s %.0f/s ~%lluB handle %.2fms",
+                          result.empty() ? "" : " | ",
+                          packetTypeName(static_cast<PacketType>(type)),
+                          stats.bytesSent / seconds / 1000, stats.packetsSent / seconds,
+                          static_cast<unsigned long long>(medianSize(stats.sentSizes, stats.packetsSent)),
+                          stats.bytesReceived / seconds / 1000, stats.packetsReceived / seconds,
+                          static_cast<unsigned long long>(medianSize(stats.receivedSizes, stats.packetsReceived)),
+                          stats.handleNS * 1e-6);
+            result += buffer;
+            if (stats.packetsDropped) {
+                std::snprintf(buffer, sizeof(buffer), " dropped %llu",
+                              static_cast<unsigned long long>(stats.packetsDropped));
+                result += buffer;
+            }
+        }
+
+        mWindow.fill({});
+        return result;
+    }
+
+    void
+    NetworkStats::reset() {
+        mTotal.fill({});
+        mWindow.fill({});
+    }
+}
@@ -0,0 +1,145 @@
+#include <oni-core/physics/oni-physics-car-prediction.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include <oni-core/common/oni-common-const.h>
+#include <oni-core/physics/oni-physics-car.h>
+
+
+namespace {
+    // NOTE: Sequences wrap around, same rule as isNewerSequence() of the network snapshots
+    bool
+    isNewer(oni::u32 a,
+            oni::u32 b) {
+        return static_cast<oni::i32>(a - b) > 0;
+    }
+}
+
+namespace oni {
+    CarPrediction::CarPrediction(u32 historySize,
+                                 r64 tolerance,
+                                 u32 firstSequence) : mHistory(historySize),
+                                                      mNextSequence(firstSequence ? firstSequence : 1),
+                                                      mTolerance(tolerance) {
+        assert(historySize);
+    }
+
+    void
+    CarPrediction::reset(const CarState &state) {
+        mState = state;
+        mFirst = 0;
+        mCount = 0;
+        mLastAcked = 0;
+    }
+
+    u32
+    CarPrediction::predict(const CarConfig &config,
+                           const CarInput &input,
+                           r64 dt) {
+        auto sequence = mNextSequence++;
+        // NOTE: 0 means no input
+        if (!mNextSequence) {
+            mNextSequence = 1;
+        }
+
+        stepCar(mState.car, mState.pos, mState.ornt, config, input, dt);
+
+        auto capacity = static_cast<u32>(mHistory.size());
+        if (mCount == capacity) {
+            // NOTE: The server is too far behind, the oldest prediction can't be checked anymore.
+            mFirst = (mFirst + 1) % capacity;
+            --mCount;
+        }
+        auto &entry = mHistory[(mFirst + mCount) % capacity];
+        ++mCount;
+
+        entry.sequence = sequence;
+        entry.input = input;
+        entry.dt = dt;
+        entry.predicted = mState;
+        return sequence;
+    }
+
+    CarPrediction::Entry *
+    CarPrediction::find(u32 sequence) {
+        auto capacity = static_cast<u32>(mHistory.size());
+        for (u32 i = 0; i < mCount; ++i) {
+            auto &entry = mHistory[(mFirst + i) % capacity];
+            if (entry.sequence == sequence) {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    void
+    CarPrediction::reconcile(u32 ackedSequence,
+                             const CarState &authoritative,
+                             const CarConfig &config) {
+        // NOTE: Snapshot older than one already reconciled, arrived out of order.
+        if (mLastAcked && ackedSequence != mLastAcked && !isNewer(ackedSequence, mLastAcked)) {
+            return;
+        }
+        ++mStats.reconciliations;
+
+        // NOTE: When the server ticked again without a new input from us the acknowledged entry is already gone,
+        // the server state is newer than our prediction for it so take it as is and replay what is pending.
+        auto mispredicted = true;
+        const auto *acked = ackedSequence ? find(ackedSequence) : nullptr;
+        if (acked) {
+            auto dx = static_cast<r64>(acked->predicted.pos.x) - authoritative.pos.x;
+            auto dy = static_cast<r64>(acked->predicted.pos.y) - authoritative.pos.y;
+            auto correction = std::sqrt(dx * dx + dy * dy);
+            // NOTE: Wrapped to [-pi, pi], a car crossing +-pi is off by a full turn but points the same way
+            auto orntError = std::abs(std::remainder(static_cast<r64>(acked->predicted.ornt.value) -
+                                                     authoritative.ornt.value, r64{TWO_PI}));
+
+            mStats.lastCorrection = correction;
+            mStats.maxCorrection = std::max(mStats.maxCorrection, correction);
+            mStats.totalCorrection += correction;
+
+            mispredicted = correction > mTolerance || orntError > mTolerance;
+        } else if (ackedSequence && ackedSequence != mLastAcked) {
+            ++mStats.historyMisses;
+        }
+        mLastAcked = ackedSequence;
+
+        // NOTE: Everything up to the acknowledged input is part of the server state now
+        auto capacity = static_cast<u32>(mHistory.size());
+        while (mCount && !isNewer(mHistory[mFirst].sequence, ackedSequence)) {
+            mFirst = (mFirst + 1) % capacity;
+            --mCount;
+        }
+
+        if (!mispredicted) {
+            return;
+        }
+        if (acked) {
+            ++mStats.mispredictions;
+        }
+
+        mState = authoritative;
+        for (u32 i = 0; i < mCount; ++i) {
+            auto &entry = mHistory[(mFirst + i) % capacity];
+            stepCar(mState.car, mState.pos, mState.ornt, config, entry.input, entry.dt);
+            entry.predicted = mState;
+        }
+    }
+
+    const CarState &
+    CarPrediction::getState() const {
+        return mState;
+    }
+
+    const CarPredictionStats &
+    CarPrediction::getStats() const {
+        return mStats;
+    }
+
+    u32
+    CarPrediction::getPendingCount() const {
+        return mCount;
+    }
+}
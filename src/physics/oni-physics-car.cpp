@@ -1,10 +1,40 @@
 #include <oni-core/physics/oni-physics-car.h>
+#include <oni-core/io/oni-io-input.h>
 #include <oni-core/io/oni-io-input-structure.h>
 #include <oni-core/component/oni-component-physics.h>
 #include <oni-core/math/oni-math-function.h>
 
+#include <GLFW/glfw3.h>
+
 
 namespace oni {
+    void
+    stepCar(Car &car,
+            WorldP3D &pos,
+            Orientation &ornt,
+            const CarConfig &config,
+            const CarInput &input,
+            r64 dt) {
+        auto steerInput = input.left - input.right;
+        if (car.smoothSteer) {
+            car.steer = applySmoothSteer(car, steerInput, dt);
+        } else {
+            car.steer = steerInput;
+        }
+
+        if (car.safeSteer) {
+            car.steer = applySafeSteer(car, steerInput);
+        }
+
+        car.steerAngle = car.steer * config.maxSteer;
+        if (input.nitro) {
+            car.velocity += vec2{static_cast<r32>(cos(ornt.value)),
+                                 static_cast<r32>(sin(ornt.value))};
+        }
+
+        tickCar(car, pos, ornt, config, input, dt);
+    }
+
     void
     tickCar(Car &car,
             WorldP3D &pos,
@@ -150,4 +180,32 @@ namespace oni {
         auto steer = steerInput * (1.0f - (avel / 280.0));
         return steer;
     }
+
+    void
+    mapCarInput(const Input &input,
+                CarInput &carInput) {
+        constexpr r32 steeringSensitivity = 0.9f;
+        carInput = {};
+
+        // TODO: This should not be exposed by the input class!
+        if (input.isPressed(GLFW_KEY_W) || input.isPressed(GLFW_KEY_UP)) {
+            // TODO: When using game-pad, this value will vary between (0.0f...1.0f)
+            carInput.throttle = 1.f;
+        }
+        if (input.isPressed(GLFW_KEY_A) || input.isPressed(GLFW_KEY_LEFT)) {
+            carInput.left = steeringSensitivity;
+        }
+        if (input.isPressed(GLFW_KEY_S) || input.isPressed(GLFW_KEY_DOWN)) {
+            carInput.throttle = -1.f;
+        }
+        if (input.isPressed(GLFW_KEY_D) || input.isPressed(GLFW_KEY_RIGHT)) {
+            carInput.right = steeringSensitivity;
+        }
+        if (input.isPressed(GLFW_KEY_LEFT_SHIFT)) {
+            carInput.nitro = true;
+        }
+        if (input.isPressed(GLFW_KEY_SPACE)) {
+            carInput.eBrake = 1.f;
+        }
+    }
 }
@@ -4,35 +4,20 @@
 #include <oni-core/physics/oni-physics-car.h>
 
 namespace oni {
-    System_Car::System_Car(EntityManager &em) : SystemTemplate(em) {}
+    System_Car::System_Car(EntityManager &em) : SystemTemplate(em) {
+        declareWrite<Tag_NetworkSyncComponent>();
+    }
 
     void
     System_Car::update(EntityTickContext &etc,
                        Car &car,
-                       CarInput &input,
-                       CarConfig &cc,
+                       const CarInput &input,
+                       const CarConfig &cc,
                        WorldP3D &pos,
                        Orientation &ornt) {
-        auto steerInput = input.left - input.right;
-        if (car.smoothSteer) {
-            car.steer = applySmoothSteer(car, steerInput, etc.dt);
-        } else {
-            car.steer = steerInput;
-        }
-
-        if (car.safeSteer) {
-            car.steer = applySafeSteer(car, steerInput);
-        }
-
-        car.steerAngle = car.steer * cc.maxSteer;
-        if (input.nitro) {
-            car.velocity += vec2{static_cast<r32>(cos(ornt.value)),
-                                 static_cast<r32>(sin(ornt.value))};
-        }
-
         const auto oldPos = pos;
         const auto oldOrnt = ornt;
-        tickCar(car, pos, ornt, cc, input, etc.dt);
+        stepCar(car, pos, ornt, cc, input, etc.dt);
 
         // TODO: This is probably not needed, client should be able to figure this out.
         auto velocity = car.velocityLocal.len();
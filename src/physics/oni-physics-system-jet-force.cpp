@@ -10,7 +10,7 @@ namespace oni {
     void
     System_JetForce::update(EntityTickContext &etc,
                             JetForce &jet,
-                            Orientation &ornt,
+                            const Orientation &ornt,
                             PhysicalBody &body) {
         if (!subAndZeroClip(jet.fuze, r32(etc.dt))) {
             body.value->ApplyForceToCenter(
@@ -18,16 +18,13 @@ namespace oni {
                            sin(ornt.value) * jet.force),
                     true);
         } else {
-            mExpiredForces.push_back(etc.id);
+            mCommands.remove<JetForce>(etc.id);
         }
     }
 
     void
     System_JetForce::postUpdate(EntityManager &mng,
                                 duration32 dt) {
-        for (auto &&id: mExpiredForces) {
-            mng.removeComponent<JetForce>(id);
-        }
-        mExpiredForces.clear();
+        mng.playback(mCommands);
     }
 }
@@ -3,14 +3,16 @@
 #include <oni-core/entities/oni-entities-manager.h>
 
 namespace oni {
-    System_PositionAndVelocity::System_PositionAndVelocity(EntityManager &em) : SystemTemplate(em) {}
+    System_PositionAndVelocity::System_PositionAndVelocity(EntityManager &em) : SystemTemplate(em) {
+        enableParallelUpdate();
+    }
 
     void
     System_PositionAndVelocity::update(EntityTickContext &etc,
                                        Velocity &velocity,
-                                       Acceleration &acc,
+                                       const Acceleration &acc,
                                        WorldP3D &pos,
-                                       Direction &dir) {
+                                       const Direction &dir) {
         velocity.current += acc.current * etc.dt;
         auto currentVelocity = velocity.current * etc.dt;
 
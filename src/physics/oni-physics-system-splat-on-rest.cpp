@@ -5,15 +5,16 @@
 namespace oni {
     System_SplatOnRest::System_SplatOnRest(EntityManager &em) : SystemTemplate(em) {
         assert(em.getSimMode() == SimMode::CLIENT);
+        declareStructural();
     }
 
     void
     System_SplatOnRest::update(EntityTickContext &etc,
-                               SplatOnRest &sor,
-                               PhysicalBody &body,
-                               Scale &scale,
-                               WorldP3D &pos,
-                               Orientation &ornt) {
+                               const SplatOnRest &sor,
+                               const PhysicalBody &body,
+                               const Scale &scale,
+                               const WorldP3D &pos,
+                               const Orientation &ornt) {
         if (!body.value->IsAwake()) {
             auto callback = [&etc]() {
                 etc.mng.deleteEntity(etc.id);
@@ -6,6 +6,8 @@ namespace oni {
     System_SyncPos::System_SyncPos(EntityManager &em) : SystemTemplate(em) {
         assert(em.getSimMode() == SimMode::SERVER ||
                em.getSimMode() == SimMode::CLIENT);
+        declareRead<Car>();
+        declareWrite<WorldP3D_History, Tag_NetworkSyncComponent>();
     }
 
     void
@@ -13,7 +15,7 @@ namespace oni {
                            PhysicalBody &body,
                            WorldP3D &ePos,
                            Orientation &ornt,
-                           Scale &scale) {
+                           const Scale &scale) {
         auto &bPos = body.value->GetPosition();
 
         if (!almost_Equal(ePos.x, bPos.x) ||
@@ -4,6 +4,7 @@ namespace oni {
     System_TimeToLive::System_TimeToLive(EntityManager &em) : SystemTemplate(em) {
         assert(em.getSimMode() == SimMode::CLIENT ||
                em.getSimMode() == SimMode::SERVER);
+        declareStructural();
     }
 
     void
@@ -31,6 +32,6 @@ namespace oni {
     void
     System_TimeToLive::postUpdate(EntityManager &mng,
                                   duration32 dt) {
-        mng.flushDeletions();
+        mng.flushCommands();
     }
 }
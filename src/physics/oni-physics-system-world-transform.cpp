@@ -0,0 +1,143 @@
+#include <oni-core/physics/oni-physics-system.h>
+
+#include <algorithm>
+
+#include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/math/oni-math-transformation.h>
+
+
+namespace {
+    bool
+    same(const oni::WorldP3D &a,
+         const oni::WorldP3D &b) {
+        return a.x == b.x && a.y == b.y && a.z == b.z;
+    }
+
+    bool
+    same(const oni::Orientation &a,
+         const oni::Orientation &b) {
+        return a.value == b.value;
+    }
+}
+
+namespace oni {
+    System_WorldTransform::System_WorldTransform(EntityManager &em,
+                                                 std::vector<EntityManager *> shadowMngs) : System(em) {
+        declareRead<EntityAttachment, EntityAttachmentShadow, EntityAttachee, WorldP3D, Orientation>();
+        declareWrite<WorldTransform>();
+        mMngs.push_back(&em);
+
+        // NOTE: Children in other managers are resolved the same way, down to their own attachments
+        for (auto *mng: shadowMngs) {
+            assert(mng && mng != &em);
+            declareRead<EntityAttachment, EntityAttachmentShadow, WorldP3D, Orientation>(*mng);
+            declareWrite<WorldTransform>(*mng);
+            mMngs.push_back(mng);
+        }
+    }
+
+    void
+    System_WorldTransform::update(EntityManager &mng,
+                                  duration32 dt) {
+        auto walk = [&](EntityID root) {
+            // NOTE: Attached entities are reached from their root
+            if (mng.has<EntityAttachee>(root)) {
+                return;
+            }
+            if (!mng.has<WorldP3D>(root) || !mng.has<Orientation>(root)) {
+                return;
+            }
+
+            pushChildren(mng, root, mng.get<WorldP3D>(root), mng.get<Orientation>(root), 1);
+            while (!mStack.empty()) {
+                auto node = mStack.back();
+                mStack.pop_back();
+                resolve(node);
+            }
+        };
+
+        {
+            auto view = mng.createView<EntityAttachment>();
+            for (auto &&id: view) {
+                walk(id);
+            }
+        }
+        {
+            auto view = mng.createView<EntityAttachmentShadow>();
+            for (auto &&id: view) {
+                // NOTE: Already walked with the EntityAttachment view
+                if (mng.has<EntityAttachment>(id)) {
+                    continue;
+                }
+                walk(id);
+            }
+        }
+    }
+
+    void
+    System_WorldTransform::postUpdate(EntityManager &mng,
+                                      duration32 dt) {}
+
+    void
+    System_WorldTransform::pushChildren(EntityManager &mng,
+                                        EntityID id,
+                                        const WorldP3D &pos,
+                                        const Orientation &ornt,
+                                        u8 depth) {
+        // NOTE: Parent pose is copied, creating WorldTransform of a child can move the ones already in the pool
+        auto push = [&](const EntityAttachment &attachment) {
+            assert(attachment.mngs.size() == attachment.entities.size());
+            for (size i = 0; i < attachment.entities.size(); ++i) {
+                mStack.push_back({attachment.mngs[i], attachment.entities[i], pos, ornt, depth});
+            }
+        };
+
+        if (mng.has<EntityAttachment>(id)) {
+            push(mng.get<EntityAttachment>(id));
+        }
+        if (mng.has<EntityAttachmentShadow>(id)) {
+            push(mng.get<EntityAttachmentShadow>(id));
+        }
+    }
+
+    void
+    System_WorldTransform::resolve(const Node &node) {
+        auto &mng = *node.mng;
+        // NOTE: Undeclared manager, SystemScheduler might be running its systems next to this one
+        assert(std::find(mMngs.begin(), mMngs.end(), &mng) != mMngs.end());
+        if (node.depth > 20) {
+            assert(false);
+            return;
+        }
+        // NOTE: Shadow children live in another manager and can be deleted without their parent knowing
+        if (!mng.valid(node.id)) {
+            return;
+        }
+        if (!mng.has<WorldP3D>(node.id) || !mng.has<Orientation>(node.id)) {
+            return;
+        }
+
+        const auto &pos = mng.get<WorldP3D>(node.id);
+        const auto &ornt = mng.get<Orientation>(node.id);
+        if (!mng.has<WorldTransform>(node.id)) {
+            // NOTE: All zero, which is also the resolved pose of all zero inputs
+            mng.createComponent<WorldTransform>(node.id);
+        }
+        auto &wt = mng.get<WorldTransform>(node.id);
+
+        if (!same(wt.localPos, pos) || !same(wt.localOrnt, ornt) ||
+            !same(wt.parentPos, node.parentPos) || !same(wt.parentOrnt, node.parentOrnt)) {
+            wt.localPos = pos;
+            wt.localOrnt = ornt;
+            wt.parentPos = node.parentPos;
+            wt.parentOrnt = node.parentOrnt;
+
+            wt.pos = pos;
+            wt.ornt = ornt;
+            localToWorldTransform(node.parentPos, node.parentOrnt, wt.pos, wt.ornt);
+        }
+
+        // NOTE: Clean children compare equal to what they cached and stop there
+        pushChildren(mng, node.id, wt.pos, wt.ornt, node.depth + 1);
+    }
+}
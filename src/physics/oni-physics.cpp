@@ -6,6 +6,7 @@
 #include <oni-core/math/oni-math-rand.h>
 #include <oni-core/game/oni-game-event.h>
 #include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/util/oni-util-profiler.h>
 
 
 namespace oni {
@@ -94,7 +95,7 @@ namespace oni {
         mPhysicsWorld = std::make_unique<b2World>(gravity);
         mPhysicsWorld->SetContactListener(mCollisionListener.get());
 
-        mRand = std::make_unique<Rand>(0, 0);
+        mRand = std::make_unique<Rand>(makeRandStream(RandStream::PHYSICS));
 
         // TODO: Can't get this working, its unreliable, when there are lot of collisions in the world, it keeps
         // skipping some of them!
@@ -106,6 +107,7 @@ namespace oni {
     void
     Physics::updatePhysWorld(EntityManager &em,
                              r64 dt) {
+        ONI_PROFILE_ZONE("Physics::updatePhysWorld");
         // TODO: entity registry has pointers to mPhysicsWorld internal data structures :(
         // One way to hide it is to provide a function in physics library that creates physical entities
         // for a given entity id an maintains an internal mapping between them without leaking the
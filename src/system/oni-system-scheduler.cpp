@@ -0,0 +1,96 @@
+#include <oni-core/system/oni-system-scheduler.h>
+
+#include <cassert>
+
+#include <oni-core/system/oni-system.h>
+#include <oni-core/util/oni-util-thread-pool.h>
+
+
+namespace oni {
+    SystemScheduler::SystemScheduler(ThreadPool &pool) : mPool(pool) {}
+
+    SystemScheduler::~SystemScheduler() = default;
+
+    void
+    SystemScheduler::add(System *system) {
+        assert(system);
+        mNodes.push_back({system, {}, 0});
+        mDirty = true;
+    }
+
+    size
+    SystemScheduler::getSystemCount() const {
+        return mNodes.size();
+    }
+
+    void
+    SystemScheduler::buildGraph() {
+        auto count = static_cast<u32>(mNodes.size());
+        for (auto &&node: mNodes) {
+            node.dependents.clear();
+            node.dependencyCount = 0;
+        }
+
+        // NOTE: Every conflicting pair gets an edge from the earlier to the later system. Some of the edges are
+        // redundant, but with a handful of systems per tick it is not worth doing a transitive reduction.
+        for (u32 i = 0; i < count; ++i) {
+            const auto &access = mNodes[i].system->getAccess();
+            for (u32 j = i + 1; j < count; ++j) {
+                if (access.conflicts(mNodes[j].system->getAccess())) {
+                    mNodes[i].dependents.push_back(j);
+                    ++mNodes[j].dependencyCount;
+                }
+            }
+        }
+
+        mPendingDependencies = std::make_unique<std::atomic<u32>[]>(count);
+        mDirty = false;
+    }
+
+    void
+    SystemScheduler::tick(duration32 dt) {
+        ONI_PROFILE_ZONE("SystemScheduler::tick");
+        if (mNodes.empty()) {
+            return;
+        }
+        if (mDirty) {
+            buildGraph();
+        }
+
+        auto count = static_cast<u32>(mNodes.size());
+        for (u32 i = 0; i < count; ++i) {
+            mPendingDependencies[i] = mNodes[i].dependencyCount;
+        }
+        mRemaining = count;
+
+        for (u32 i = 0; i < count; ++i) {
+            if (!mNodes[i].dependencyCount) {
+                mPool.submit([this, i, dt]() { run(i, dt); });
+            }
+        }
+
+        mPool.helpUntil(mRemaining);
+    }
+
+    void
+    SystemScheduler::tickSerial(duration32 dt) {
+        for (auto &&node: mNodes) {
+            node.system->tick(dt);
+        }
+    }
+
+    void
+    SystemScheduler::run(u32 nodeIdx,
+                         duration32 dt) {
+        const auto &node = mNodes[nodeIdx];
+        node.system->tick(dt);
+
+        for (auto &&dependent: node.dependents) {
+            if (--mPendingDependencies[dependent] == 0) {
+                mPool.submit([this, dependent, dt]() { run(dependent, dt); });
+            }
+        }
+
+        --mRemaining;
+    }
+}
@@ -0,0 +1,115 @@
+#include <oni-core/util/oni-util-bit-stream.h>
+
+#include <cassert>
+
+
+namespace oni {
+    void
+    BitWriter::write(u32 value,
+                     u8 bits) {
+        assert(bits <= 32);
+        if (!bits) {
+            return;
+        }
+        auto mask = bits == 32 ? u64{0xFFFFFFFF} : (u64{1} << bits) - 1;
+        mScratch |= (value & mask) << mScratchBits;
+        mScratchBits += bits;
+        mBitCount += bits;
+
+        while (mScratchBits >= 8) {
+            mData.push_back(static_cast<u8>(mScratch & 0xFF));
+            mScratch >>= 8;
+            mScratchBits -= 8;
+        }
+    }
+
+    void
+    BitWriter::writeBit(bool value) {
+        write(value ? 1 : 0, 1);
+    }
+
+    void
+    BitWriter::writeVarBits(u32 value) {
+        auto width = bitWidth(value);
+        write(width, 6);
+        write(value, width);
+    }
+
+    void
+    BitWriter::finish() {
+        if (mScratchBits) {
+            mData.push_back(static_cast<u8>(mScratch & 0xFF));
+            mScratch = 0;
+            mScratchBits = 0;
+        }
+    }
+
+    const std::vector<u8> &
+    BitWriter::getData() const {
+        assert(!mScratchBits);
+        return mData;
+    }
+
+    size
+    BitWriter::getBitCount() const {
+        return mBitCount;
+    }
+
+    void
+    BitWriter::clear() {
+        mData.clear();
+        mScratch = 0;
+        mScratchBits = 0;
+        mBitCount = 0;
+    }
+
+    BitReader::BitReader(const u8 *data,
+                         size size) : mData(data), mSize(size) {}
+
+    u32
+    BitReader::read(u8 bits) {
+        assert(bits <= 32);
+        if (!bits) {
+            return 0;
+        }
+        while (mScratchBits < bits) {
+            if (mPos >= mSize) {
+                mGood = false;
+                return 0;
+            }
+            mScratch |= u64{mData[mPos++]} << mScratchBits;
+            mScratchBits += 8;
+        }
+
+        auto mask = bits == 32 ? u64{0xFFFFFFFF} : (u64{1} << bits) - 1;
+        auto result = static_cast<u32>(mScratch & mask);
+        mScratch >>= bits;
+        mScratchBits -= bits;
+        return result;
+    }
+
+    bool
+    BitReader::readBit() {
+        return read(1) != 0;
+    }
+
+    u32
+    BitReader::readVarBits() {
+        auto width = static_cast<u8>(read(6));
+        if (width > 32) {
+            mGood = false;
+            return 0;
+        }
+        return read(width);
+    }
+
+    bool
+    BitReader::good() const {
+        return mGood;
+    }
+
+    size
+    BitReader::getBitsLeft() const {
+        return (mSize - mPos) * 8 + mScratchBits;
+    }
+}
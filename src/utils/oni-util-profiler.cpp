@@ -0,0 +1,245 @@
+#include <oni-core/util/oni-util-profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <unordered_map>
+
+#if defined(__GNUG__)
+
+#include <cxxabi.h>
+
+#endif
+
+
+namespace {
+    constexpr oni::size PROFILE_SAMPLES_PER_THREAD = 32 * 1024;
+    constexpr oni::u32 PROFILE_BINARY_VERSION = 1;
+
+    thread_local oni::ProfileThreadBuffer *tProfileBuffer{};
+
+    // NOTE: System zones are named after typeid(), turn those back into something readable.
+    std::string
+    readableName(const oni::c8 *name) {
+#if defined(__GNUG__)
+        auto status = int{-1};
+        auto *demangled = abi::__cxa_demangle(name, nullptr, nullptr, &status);
+        if (status == 0 && demangled) {
+            auto result = std::string(demangled);
+            std::free(demangled);
+            return result;
+        }
+#endif
+        return name;
+    }
+
+    std::string
+    escapeJson(const std::string &value) {
+        auto result = std::string{};
+        result.reserve(value.size());
+        for (auto c: value) {
+            if (c == '"' || c == '\\') {
+                result.push_back('\\');
+            }
+            result.push_back(c);
+        }
+        return result;
+    }
+
+    template<class T>
+    void
+    writeLittleEndian(std::ofstream &out,
+                      T value) {
+        for (oni::size i = 0; i < sizeof(T); ++i) {
+            out.put(static_cast<char>((value >> (i * 8)) & 0xFF));
+        }
+    }
+}
+
+namespace oni {
+    ProfileThreadBuffer::ProfileThreadBuffer(u32 threadIdx,
+                                             size capacity) : mThreadIdx(threadIdx),
+                                                              mSlots(std::make_unique<Slot[]>(capacity)),
+                                                              mCapacity(capacity) {}
+
+    void
+    ProfileThreadBuffer::push(const c8 *name,
+                              u64 startNS,
+                              u64 endNS) {
+        auto idx = mHead.load(std::memory_order_relaxed);
+        // NOTE: Announce the overwrite before touching the slot, see copy().
+        mReserved.store(idx + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        auto &slot = mSlots[idx % mCapacity];
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.startNS.store(startNS, std::memory_order_relaxed);
+        slot.endNS.store(endNS, std::memory_order_relaxed);
+
+        mHead.store(idx + 1, std::memory_order_release);
+    }
+
+    void
+    ProfileThreadBuffer::copy(std::vector<ProfileSample> &out) const {
+        auto head = mHead.load(std::memory_order_acquire);
+        auto count = std::min<u64>(head, mCapacity);
+        auto first = head - count;
+
+        auto offset = out.size();
+        for (auto i = first; i < head; ++i) {
+            const auto &slot = mSlots[i % mCapacity];
+            out.push_back({slot.name.load(std::memory_order_relaxed),
+                           slot.startNS.load(std::memory_order_relaxed),
+                           slot.endNS.load(std::memory_order_relaxed)});
+        }
+
+        // NOTE: Anything the owner started to overwrite while we were reading is torn, drop it.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        auto reserved = mReserved.load(std::memory_order_relaxed);
+        auto validFrom = reserved > mCapacity ? reserved - mCapacity : 0;
+        if (validFrom > first) {
+            auto torn = std::min<u64>(validFrom - first, count);
+            out.erase(out.begin() + offset, out.begin() + offset + torn);
+        }
+    }
+
+    u32
+    ProfileThreadBuffer::getThreadIdx() const {
+        return mThreadIdx;
+    }
+
+    Profiler::Profiler() = default;
+
+    Profiler &
+    Profiler::get() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    void
+    Profiler::setEnabled(bool enabled) {
+        mEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    u64
+    Profiler::now() {
+        return static_cast<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void
+    Profiler::record(const c8 *name,
+                     u64 startNS,
+                     u64 endNS) {
+        getThreadBuffer().push(name, startNS, endNS);
+    }
+
+    ProfileThreadBuffer &
+    Profiler::getThreadBuffer() {
+        if (!tProfileBuffer) {
+            // NOTE: Only taken once per thread, buffers are kept around after their thread exits so the samples
+            // can still be exported.
+            auto lock = std::lock_guard<std::mutex>(mBuffersMutex);
+            auto threadIdx = static_cast<u32>(mBuffers.size());
+            mBuffers.emplace_back(std::make_unique<ProfileThreadBuffer>(threadIdx, PROFILE_SAMPLES_PER_THREAD));
+            tProfileBuffer = mBuffers.back().get();
+        }
+        return *tProfileBuffer;
+    }
+
+    std::vector<std::pair<u32, std::vector<ProfileSample>>>
+    Profiler::collect() const {
+        auto result = std::vector<std::pair<u32, std::vector<ProfileSample>>>{};
+        auto lock = std::lock_guard<std::mutex>(mBuffersMutex);
+        for (auto &&buffer: mBuffers) {
+            auto &entry = result.emplace_back();
+            entry.first = buffer->getThreadIdx();
+            buffer->copy(entry.second);
+        }
+        return result;
+    }
+
+    bool
+    Profiler::exportChromeTrace(const std::string &path) const {
+        auto threads = collect();
+
+        auto origin = std::numeric_limits<u64>::max();
+        for (auto &&thread: threads) {
+            for (auto &&sample: thread.second) {
+                origin = std::min(origin, sample.startNS);
+            }
+        }
+
+        auto *file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            printf("Failed to open profiler capture file: %s\n", path.c_str());
+            return false;
+        }
+
+        auto names = std::unordered_map<const c8 *, std::string>{};
+        auto first = true;
+        std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+        for (auto &&thread: threads) {
+            for (auto &&sample: thread.second) {
+                auto name = names.find(sample.name);
+                if (name == names.end()) {
+                    name = names.emplace(sample.name, escapeJson(readableName(sample.name))).first;
+                }
+                std::fprintf(file, "%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                             first ? "" : ",",
+                             name->second.c_str(),
+                             thread.first,
+                             (sample.startNS - origin) / 1000.0,
+                             (sample.endNS - sample.startNS) / 1000.0);
+                first = false;
+            }
+        }
+        std::fprintf(file, "\n]}\n");
+        std::fclose(file);
+        return true;
+    }
+
+    bool
+    Profiler::exportBinary(const std::string &path) const {
+        auto threads = collect();
+
+        auto nameIndices = std::unordered_map<const c8 *, u32>{};
+        auto names = std::vector<std::string>{};
+        for (auto &&thread: threads) {
+            for (auto &&sample: thread.second) {
+                if (nameIndices.emplace(sample.name, static_cast<u32>(names.size())).second) {
+                    names.push_back(readableName(sample.name));
+                }
+            }
+        }
+
+        auto out = std::ofstream(path, std::ios::binary);
+        if (!out) {
+            printf("Failed to open profiler capture file: %s\n", path.c_str());
+            return false;
+        }
+
+        out.write("ONIP", 4);
+        writeLittleEndian<u32>(out, PROFILE_BINARY_VERSION);
+        writeLittleEndian<u32>(out, static_cast<u32>(names.size()));
+        for (auto &&name: names) {
+            writeLittleEndian<u32>(out, static_cast<u32>(name.size()));
+            out.write(name.data(), name.size());
+        }
+
+        writeLittleEndian<u32>(out, static_cast<u32>(threads.size()));
+        for (auto &&thread: threads) {
+            writeLittleEndian<u32>(out, thread.first);
+            writeLittleEndian<u64>(out, thread.second.size());
+            for (auto &&sample: thread.second) {
+                writeLittleEndian<u32>(out, nameIndices[sample.name]);
+                writeLittleEndian<u64>(out, sample.startNS);
+                writeLittleEndian<u64>(out, sample.endNS);
+            }
+        }
+        return static_cast<bool>(out);
+    }
+}
@@ -0,0 +1,148 @@
+#include <oni-core/util/oni-util-thread-pool.h>
+
+#include <cassert>
+
+
+namespace {
+    thread_local const oni::ThreadPool *tOwnerPool{};
+    thread_local oni::u16 tQueueIdx{0};
+}
+
+namespace oni {
+    ThreadPool::ThreadPool(u16 numWorkers) {
+        mQueues.reserve(numWorkers + 1);
+        for (u16 i = 0; i < numWorkers + 1; ++i) {
+            mQueues.emplace_back(std::make_unique<WorkQueue>());
+        }
+
+        mWorkers.reserve(numWorkers);
+        for (u16 i = 0; i < numWorkers; ++i) {
+            mWorkers.emplace_back(&ThreadPool::work, this, i + 1);
+        }
+    }
+
+    ThreadPool::~ThreadPool() {
+        mRunning = false;
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+        }
+        mSleepCV.notify_all();
+
+        for (auto &&worker: mWorkers) {
+            worker.join();
+        }
+    }
+
+    u16
+    ThreadPool::getWorkerCount() const {
+        return static_cast<u16>(mWorkers.size());
+    }
+
+    u16
+    ThreadPool::defaultWorkerCount() {
+        auto cores = std::thread::hardware_concurrency();
+        if (cores > 1) {
+            return static_cast<u16>(cores - 1);
+        }
+        return 0;
+    }
+
+    void
+    ThreadPool::submit(Job &&job) {
+        u16 idx = 0;
+        if (tOwnerPool == this) {
+            idx = tQueueIdx;
+        }
+
+        {
+            auto &queue = *mQueues[idx];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back(std::move(job));
+        }
+        ++mPendingJobs;
+
+        // NOTE: Taking the lock makes sure a worker that just found no work is either already waiting or will see
+        // the new pending count, otherwise the notification could get lost.
+        {
+            std::lock_guard<std::mutex> lock(mSleepMutex);
+        }
+        mSleepCV.notify_one();
+    }
+
+    void
+    ThreadPool::helpUntil(const std::atomic<u32> &remaining) {
+        u16 idx = 0;
+        if (tOwnerPool == this) {
+            idx = tQueueIdx;
+        }
+
+        auto job = Job{};
+        while (remaining.load(std::memory_order_acquire)) {
+            if (findJob(idx, job)) {
+                job();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void
+    ThreadPool::work(u16 queueIdx) {
+        tOwnerPool = this;
+        tQueueIdx = queueIdx;
+
+        auto job = Job{};
+        while (mRunning) {
+            if (findJob(queueIdx, job)) {
+                job();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mSleepMutex);
+            mSleepCV.wait(lock, [this]() {
+                return !mRunning || mPendingJobs.load() > 0;
+            });
+        }
+    }
+
+    bool
+    ThreadPool::findJob(u16 queueIdx,
+                        Job &job) {
+        if (popLocal(queueIdx, job) || steal(queueIdx, job)) {
+            --mPendingJobs;
+            return true;
+        }
+        return false;
+    }
+
+    bool
+    ThreadPool::popLocal(u16 queueIdx,
+                         Job &job) {
+        auto &queue = *mQueues[queueIdx];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            return false;
+        }
+        // NOTE: LIFO on the owner side keeps the most recently produced, and likely cache hot, work local.
+        job = std::move(queue.jobs.back());
+        queue.jobs.pop_back();
+        return true;
+    }
+
+    bool
+    ThreadPool::steal(u16 queueIdx,
+                      Job &job) {
+        auto count = mQueues.size();
+        for (size i = 1; i < count; ++i) {
+            auto &queue = *mQueues[(queueIdx + i) % count];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.jobs.empty()) {
+                continue;
+            }
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            return true;
+        }
+        return false;
+    }
+}
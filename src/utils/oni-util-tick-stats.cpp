@@ -0,0 +1,47 @@
+#include <oni-core/util/oni-util-tick-stats.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+namespace {
+    oni::u64
+    nearestRank(std::vector<oni::u64> &samples,
+                oni::r64 percentile) {
+        auto rank = static_cast<oni::size>(std::ceil(percentile * samples.size()));
+        auto idx = rank ? rank - 1 : 0;
+        std::nth_element(samples.begin(), samples.begin() + idx, samples.end());
+        return samples[idx];
+    }
+}
+
+namespace oni {
+    TickStats::TickStats(size expectedSamples) {
+        mSamples.reserve(expectedSamples);
+    }
+
+    void
+    TickStats::add(u64 durationNS) {
+        mSamples.push_back(durationNS);
+    }
+
+    TickStatsSummary
+    TickStats::summarize() {
+        auto result = TickStatsSummary{};
+        if (mSamples.empty()) {
+            return result;
+        }
+
+        // NOTE: Partially reorders the samples, which is fine as their order carries no meaning.
+        result.count = mSamples.size();
+        result.maxNS = *std::max_element(mSamples.begin(), mSamples.end());
+        result.p99NS = nearestRank(mSamples, 0.99);
+        result.p50NS = nearestRank(mSamples, 0.50);
+        return result;
+    }
+
+    void
+    TickStats::reset() {
+        mSamples.clear();
+    }
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include <oni-test/oni-test.h>
+
+namespace oni {
+    class OniTestEntitiesUpdate : public OniTest {
+    public:
+        void
+        run() override;
+    };
+}
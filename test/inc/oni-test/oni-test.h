@@ -1,3 +1,5 @@
+#pragma once
+
 namespace oni {
     class OniTest {
     public:
@@ -1,8 +1,78 @@
+#include <oni-test/oni-test-bit-stream.h>
 #include <oni-test/oni-test-enum.h>
+#include <oni-test/oni-test-interpolation.h>
+#include <oni-test/oni-test-memory-stream.h>
+#include <oni-test/oni-test-profiler.h>
+#include <oni-test/oni-test-rand.h>
+#include <oni-test/oni-test-snapshot-buffer.h>
+#include <oni-test/oni-test-spatial-grid.h>
+#include <oni-test/oni-test-thread-pool.h>
+#include <oni-test/oni-test-tick-stats.h>
+#include <oni-test/oni-test-transformation.h>
+
+#if defined(ONI_TEST_ENGINE)
+
+#include <oni-test/oni-test-car-prediction.h>
+#include <oni-test/oni-test-entities-update.h>
+#include <oni-test/oni-test-replay.h>
+
+#endif
+
+#if defined(ONI_TEST_GL)
+
+#include <oni-test/oni-test-stream-buffer.h>
+
+#endif
 
 int
 main() {
+    auto bitStreamTest = oni::OniTestBitStream();
+    bitStreamTest.run();
+
+    auto interpolationTest = oni::OniTestInterpolation();
+    interpolationTest.run();
+
+    auto memoryStreamTest = oni::OniTestMemoryStream();
+    memoryStreamTest.run();
+
+    auto threadPoolTest = oni::OniTestThreadPool();
+    threadPoolTest.run();
+
+    auto profilerTest = oni::OniTestProfiler();
+    profilerTest.run();
+
+    auto randTest = oni::OniTestRand();
+    randTest.run();
+
+    auto snapshotBufferTest = oni::OniTestSnapshotBuffer();
+    snapshotBufferTest.run();
+
+    auto spatialGridTest = oni::OniTestSpatialGrid();
+    spatialGridTest.run();
+
+    auto tickStatsTest = oni::OniTestTickStats();
+    tickStatsTest.run();
+
+    auto transformationTest = oni::OniTestTransformation();
+    transformationTest.run();
+
+#if defined(ONI_TEST_ENGINE)
+    auto carPredictionTest = oni::OniTestCarPrediction();
+    carPredictionTest.run();
+
+    auto entitiesUpdateTest = oni::OniTestEntitiesUpdate();
+    entitiesUpdateTest.run();
+
+    auto replayTest = oni::OniTestReplay();
+    replayTest.run();
+#endif
+
+#if defined(ONI_TEST_GL)
+    auto streamBufferTest = oni::OniTestStreamBuffer();
+    streamBufferTest.run();
+#endif
+
     auto enumTest = oni::OniTestEnum();
     enumTest.run();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,79 @@
+#include <oni-test/oni-test-bit-stream.h>
+
+#include <cassert>
+
+#include <oni-core/util/oni-util-bit-stream.h>
+
+
+namespace {
+    void
+    testRoundTrip() {
+        auto writer = oni::BitWriter{};
+        writer.writeBit(true);
+        writer.write(5, 3);
+        writer.write(0xDEADBEEF, 32);
+        writer.writeVarBits(0);
+        writer.writeVarBits(1000);
+        writer.write(0x7F, 7);
+        writer.finish();
+
+        assert(writer.getBitCount() == 1 + 3 + 32 + 6 + (6 + 10) + 7);
+        assert(writer.getData().size() == 9);
+
+        auto reader = oni::BitReader(writer.getData().data(), writer.getData().size());
+        assert(reader.readBit());
+        assert(reader.read(3) == 5);
+        assert(reader.read(32) == 0xDEADBEEF);
+        assert(reader.readVarBits() == 0);
+        assert(reader.readVarBits() == 1000);
+        assert(reader.read(7) == 0x7F);
+        assert(reader.good());
+    }
+
+    void
+    testOverflow() {
+        auto writer = oni::BitWriter{};
+        writer.write(3, 2);
+        writer.finish();
+
+        auto reader = oni::BitReader(writer.getData().data(), writer.getData().size());
+        assert(reader.getBitsLeft() == 8);
+        assert(reader.read(8) == 3);
+        assert(reader.getBitsLeft() == 0);
+        assert(reader.good());
+        assert(reader.read(1) == 0);
+        assert(!reader.good());
+    }
+
+    void
+    testBitWidth() {
+        assert(oni::bitWidth(0) == 0);
+        assert(oni::bitWidth(1) == 1);
+        assert(oni::bitWidth(255) == 8);
+        assert(oni::bitWidth(256) == 9);
+        assert(oni::bitWidth(0xFFFFFFFF) == 32);
+    }
+
+    void
+    testClear() {
+        auto writer = oni::BitWriter{};
+        writer.write(0xFFFF, 13);
+        writer.clear();
+        writer.write(1, 1);
+        writer.finish();
+
+        assert(writer.getBitCount() == 1);
+        assert(writer.getData().size() == 1);
+        assert(writer.getData()[0] == 1);
+    }
+}
+
+namespace oni {
+    void
+    OniTestBitStream::run() {
+        testRoundTrip();
+        testOverflow();
+        testBitWidth();
+        testClear();
+    }
+}
@@ -0,0 +1,244 @@
+#include <oni-test/oni-test-car-prediction.h>
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include <oni-core/common/oni-common-const.h>
+#include <oni-core/physics/oni-physics-car.h>
+#include <oni-core/physics/oni-physics-car-prediction.h>
+
+
+namespace {
+    constexpr oni::r64 dt = 1 / 60.0;
+
+    bool
+    near(oni::r64 a,
+         oni::r64 b) {
+        return std::abs(a - b) < 1e-4;
+    }
+
+    oni::CarState
+    makeStart(const oni::CarConfig &config,
+              oni::r32 ornt = 0.f) {
+        auto state = oni::CarState{};
+        state.car.applyConfiguration(config);
+        state.ornt.value = ornt;
+        return state;
+    }
+
+    oni::CarInput
+    makeInput(oni::u32 i) {
+        auto input = oni::CarInput{};
+        input.throttle = 1.f;
+        input.left = (i % 3) ? 0.f : 1.f;
+        return input;
+    }
+
+    // NOTE: What the server arrives at after applying the given inputs, the same stepCar() the prediction uses
+    oni::CarState
+    simulate(oni::CarState state,
+             const oni::CarConfig &config,
+             const std::vector<oni::CarInput> &inputs) {
+        for (auto &&input: inputs) {
+            oni::stepCar(state.car, state.pos, state.ornt, config, input, dt);
+        }
+        return state;
+    }
+
+    bool
+    samePosition(const oni::CarState &a,
+                 const oni::CarState &b) {
+        return a.pos.x == b.pos.x && a.pos.y == b.pos.y && a.ornt.value == b.ornt.value;
+    }
+
+    void
+    testOutOfOrderAcks() {
+        auto config = oni::CarConfig{};
+        auto start = makeStart(config);
+        auto prediction = oni::CarPrediction();
+        prediction.reset(start);
+
+        auto inputs = std::vector<oni::CarInput>{};
+        auto sequences = std::vector<oni::u32>{};
+        for (oni::u32 i = 0; i < 5; ++i) {
+            inputs.push_back(makeInput(i));
+            sequences.push_back(prediction.predict(config, inputs.back(), dt));
+        }
+        assert(sequences.front() == 1);
+        assert(prediction.getPendingCount() == 5);
+        auto predicted = prediction.getState();
+        assert(samePosition(predicted, simulate(start, config, inputs)));
+
+        auto acked3 = simulate(start, config, {inputs.begin(), inputs.begin() + 3});
+        prediction.reconcile(sequences[2], acked3, config);
+        assert(prediction.getStats().reconciliations == 1);
+        assert(prediction.getStats().mispredictions == 0);
+        assert(near(prediction.getStats().lastCorrection, 0));
+        assert(prediction.getPendingCount() == 2);
+        assert(samePosition(prediction.getState(), predicted));
+
+        // NOTE: Older snapshot arriving late, even with a wrong state it is ignored
+        auto acked2 = simulate(start, config, {inputs.begin(), inputs.begin() + 2});
+        acked2.pos.x += 10.f;
+        prediction.reconcile(sequences[1], acked2, config);
+        assert(prediction.getStats().reconciliations == 1);
+        assert(prediction.getPendingCount() == 2);
+        assert(samePosition(prediction.getState(), predicted));
+
+        // NOTE: Off by a meter, rewound to the server state and the two pending inputs replayed
+        auto acked4 = simulate(start, config, {inputs.begin(), inputs.begin() + 4});
+        acked4.pos.x += 1.f;
+        prediction.reconcile(sequences[3], acked4, config);
+        assert(prediction.getStats().reconciliations == 2);
+        assert(prediction.getStats().mispredictions == 1);
+        assert(near(prediction.getStats().lastCorrection, 1));
+        assert(near(prediction.getStats().maxCorrection, 1));
+        assert(prediction.getPendingCount() == 1);
+        assert(samePosition(prediction.getState(), simulate(acked4, config, {inputs[4]})));
+        assert(!samePosition(prediction.getState(), predicted));
+
+        prediction.reconcile(sequences[4], prediction.getState(), config);
+        assert(prediction.getStats().mispredictions == 1);
+        assert(prediction.getPendingCount() == 0);
+        assert(prediction.getStats().historyMisses == 0);
+    }
+
+    void
+    testDuplicateAck() {
+        auto config = oni::CarConfig{};
+        auto start = makeStart(config);
+        auto prediction = oni::CarPrediction();
+        prediction.reset(start);
+
+        auto inputs = std::vector<oni::CarInput>{makeInput(0), makeInput(1)};
+        for (auto &&input: inputs) {
+            prediction.predict(config, input, dt);
+        }
+        auto acked = simulate(start, config, inputs);
+        prediction.reconcile(2, acked, config);
+        assert(prediction.getPendingCount() == 0);
+
+        auto pending = makeInput(2);
+        auto sequence = prediction.predict(config, pending, dt);
+        assert(sequence == 3);
+
+        // NOTE: The server ticked once more without input from us, it acks 2 again but the car moved on
+        auto server = simulate(acked, config, {oni::CarInput{}});
+        prediction.reconcile(2, server, config);
+        assert(prediction.getStats().reconciliations == 2);
+        assert(prediction.getStats().mispredictions == 0);
+        assert(prediction.getStats().historyMisses == 0);
+        assert(prediction.getPendingCount() == 1);
+        assert(samePosition(prediction.getState(), simulate(server, config, {pending})));
+
+        // NOTE: Nothing pending, plain snap
+        prediction.reconcile(3, prediction.getState(), config);
+        server = simulate(prediction.getState(), config, {oni::CarInput{}});
+        prediction.reconcile(3, server, config);
+        assert(prediction.getPendingCount() == 0);
+        assert(samePosition(prediction.getState(), server));
+        assert(prediction.getStats().historyMisses == 0);
+    }
+
+    void
+    testHistoryOverflow() {
+        auto config = oni::CarConfig{};
+        auto start = makeStart(config);
+        auto prediction = oni::CarPrediction(4);
+        prediction.reset(start);
+
+        auto inputs = std::vector<oni::CarInput>{};
+        for (oni::u32 i = 0; i < 10; ++i) {
+            inputs.push_back(makeInput(i));
+            prediction.predict(config, inputs.back(), dt);
+        }
+        assert(prediction.getPendingCount() == 4);
+
+        // NOTE: Input 2 fell out of the history, the server state is taken and the 4 kept inputs replayed
+        auto acked = simulate(start, config, {inputs.begin(), inputs.begin() + 2});
+        prediction.reconcile(2, acked, config);
+        assert(prediction.getStats().historyMisses == 1);
+        assert(prediction.getStats().mispredictions == 0);
+        assert(prediction.getPendingCount() == 4);
+        assert(samePosition(prediction.getState(), simulate(acked, config, {inputs.begin() + 6, inputs.end()})));
+
+        // NOTE: Same ack again is not another miss
+        prediction.reconcile(2, acked, config);
+        assert(prediction.getStats().historyMisses == 1);
+    }
+
+    void
+    testSequenceWrap() {
+        auto config = oni::CarConfig{};
+        auto start = makeStart(config);
+        auto prediction = oni::CarPrediction(128, 0.01, 0xFFFFFFFEu);
+        prediction.reset(start);
+
+        auto inputs = std::vector<oni::CarInput>{};
+        auto sequences = std::vector<oni::u32>{};
+        for (oni::u32 i = 0; i < 4; ++i) {
+            inputs.push_back(makeInput(i));
+            sequences.push_back(prediction.predict(config, inputs.back(), dt));
+        }
+        assert(sequences[0] == 0xFFFFFFFEu);
+        assert(sequences[1] == 0xFFFFFFFFu);
+        // NOTE: 0 is no input
+        assert(sequences[2] == 1);
+        assert(sequences[3] == 2);
+
+        auto predicted = prediction.getState();
+        prediction.reconcile(sequences[1], simulate(start, config, {inputs.begin(), inputs.begin() + 2}), config);
+        assert(prediction.getPendingCount() == 2);
+        assert(samePosition(prediction.getState(), predicted));
+
+        // NOTE: Before the wrap, older
+        prediction.reconcile(sequences[0], start, config);
+        assert(prediction.getStats().reconciliations == 1);
+        assert(prediction.getPendingCount() == 2);
+
+        prediction.reconcile(sequences[3], predicted, config);
+        assert(prediction.getStats().reconciliations == 2);
+        assert(prediction.getStats().mispredictions == 0);
+        assert(prediction.getStats().historyMisses == 0);
+        assert(prediction.getPendingCount() == 0);
+    }
+
+    void
+    testOrientationWrap() {
+        auto config = oni::CarConfig{};
+        auto start = makeStart(config, oni::PI - 0.001f);
+        auto prediction = oni::CarPrediction();
+        prediction.reset(start);
+
+        auto inputs = std::vector<oni::CarInput>{makeInput(1), makeInput(2)};
+        for (auto &&input: inputs) {
+            prediction.predict(config, input, dt);
+        }
+        auto predicted = prediction.getState();
+
+        // NOTE: A full turn apart, the server wrapped to -PI, it points the same way
+        auto acked = simulate(start, config, {inputs[0]});
+        acked.ornt.value -= oni::TWO_PI;
+        prediction.reconcile(1, acked, config);
+        assert(prediction.getStats().mispredictions == 0);
+        assert(samePosition(prediction.getState(), predicted));
+
+        acked = predicted;
+        acked.ornt.value += 0.1f;
+        prediction.reconcile(2, acked, config);
+        assert(prediction.getStats().mispredictions == 1);
+        assert(samePosition(prediction.getState(), acked));
+    }
+}
+
+namespace oni {
+    void
+    OniTestCarPrediction::run() {
+        testOutOfOrderAcks();
+        testDuplicateAck();
+        testHistoryOverflow();
+        testSequenceWrap();
+        testOrientationWrap();
+    }
+}
@@ -0,0 +1,113 @@
+#include <oni-test/oni-test-entities-update.h>
+
+#include <cassert>
+#include <vector>
+
+#include <oni-core/component/oni-component-physics.h>
+#include <oni-core/entities/oni-entities-manager.h>
+#include <oni-core/util/oni-util-thread-pool.h>
+
+
+namespace {
+    // NOTE: Enough for several chunks of updateParallel<Velocity>()
+    constexpr oni::u32 EntityCount = 10 * 1000;
+
+    struct World {
+        oni::u32 alive{0};
+        oni::u32 accelerated{0};
+        oni::r64 velocity{0};
+    };
+
+    World
+    capture(oni::EntityManager &em) {
+        auto world = World{};
+        auto view = em.createView<oni::Velocity>();
+        for (auto &&id: view) {
+            ++world.alive;
+            if (em.has<oni::Acceleration>(id)) {
+                ++world.accelerated;
+            }
+            world.velocity += em.get<oni::Velocity>(id).current;
+        }
+        return world;
+    }
+
+    bool
+    same(const World &a,
+         const World &b) {
+        return a.alive == b.alive && a.accelerated == b.accelerated && a.velocity == b.velocity;
+    }
+
+    struct Result {
+        // NOTE: What a system running later in the same tick sees
+        World beforeFlush{};
+        World afterFlush{};
+        std::vector<oni::u32> order{};
+    };
+
+    Result
+    tick(oni::ThreadPool *pool) {
+        auto em = oni::EntityManager(oni::SimMode::CLIENT, nullptr);
+        em.setThreadPool(pool);
+
+        auto ids = std::vector<oni::EntityID>{};
+        for (oni::u32 i = 0; i < EntityCount; ++i) {
+            auto id = em.createEntity();
+            em.createComponent<oni::Velocity>(id, static_cast<oni::r32>(i % 13), 10.f);
+            ids.push_back(id);
+        }
+
+        auto result = Result{};
+        auto &order = result.order;
+        auto middle = ids[EntityCount / 2];
+
+        em.getCommandBuffer().invoke([&order]() { order.push_back(0); });
+        em.updateParallel<oni::Velocity>([&order, middle](oni::EntityTickContext &etc,
+                                                          oni::Velocity &velocity) {
+            velocity.current += 1.f;
+            if (etc.id % 3 == 0) {
+                etc.mng.markForDeletion(etc.id);
+            } else if (etc.id % 3 == 1) {
+                etc.mng.createComponent<oni::Acceleration>(etc.id, 1.f, 2.f);
+            }
+            if (etc.id == middle) {
+                etc.mng.getCommandBuffer().invoke([&order]() { order.push_back(1); });
+            }
+        }, 1 / 60.f);
+        em.getCommandBuffer().invoke([&order]() { order.push_back(2); });
+
+        result.beforeFlush = capture(em);
+        em.flushCommands();
+        result.afterFlush = capture(em);
+        return result;
+    }
+
+    void
+    testSerialAndParallelAgree() {
+        auto serial = tick(nullptr);
+
+        auto pool = oni::ThreadPool(3);
+        auto parallel = tick(&pool);
+
+        // NOTE: Deletions wait for flushCommands() in both modes, component changes are in by the time
+        // update returns.
+        assert(serial.beforeFlush.alive == EntityCount);
+        assert(serial.beforeFlush.accelerated > 0);
+        assert(same(serial.beforeFlush, parallel.beforeFlush));
+
+        assert(serial.afterFlush.alive < EntityCount);
+        assert(same(serial.afterFlush, parallel.afterFlush));
+
+        // NOTE: Commands recorded from the update land between the ones recorded before and after it
+        auto expected = std::vector<oni::u32>{0, 1, 2};
+        assert(serial.order == expected);
+        assert(parallel.order == expected);
+    }
+}
+
+namespace oni {
+    void
+    OniTestEntitiesUpdate::run() {
+        testSerialAndParallelAgree();
+    }
+}
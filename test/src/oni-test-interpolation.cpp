@@ -0,0 +1,148 @@
+#include <oni-test/oni-test-interpolation.h>
+
+#include <cassert>
+#include <cmath>
+
+#include <oni-core/common/oni-common-const.h>
+#include <oni-core/network/oni-network-interpolation.h>
+
+
+namespace {
+    bool
+    near(oni::r32 a,
+         oni::r32 b) {
+        return std::abs(a - b) < 1e-4f;
+    }
+
+    oni::InterpolationConfig
+    makeConfig() {
+        auto config = oni::InterpolationConfig{};
+        config.delay = 0.1;
+        config.maxExtrapolation = 0.25;
+        config.capacity = 32;
+        return config;
+    }
+
+    void
+    testBracketing() {
+        auto buffer = oni::InterpolationBuffer(makeConfig());
+        auto pos = oni::WorldP3D{};
+        auto ornt = oni::Orientation{};
+        assert(!buffer.sample(1, 1.0, pos, ornt));
+
+        buffer.push(1, 1.0, {0.f, 0.f, 0.5f}, {0.f});
+        buffer.push(1, 2.0, {10.f, 20.f, 0.5f}, {1.f});
+
+        // NOTE: Render time is now - delay
+        assert(buffer.sample(1, 1.6, pos, ornt));
+        assert(near(pos.x, 5.f));
+        assert(near(pos.y, 10.f));
+        assert(near(pos.z, 0.5f));
+        assert(near(ornt.value, 0.5f));
+
+        // NOTE: Before the first snapshot it holds there
+        assert(buffer.sample(1, 0.5, pos, ornt));
+        assert(near(pos.x, 0.f));
+
+        assert(buffer.getStats().interpolated == 1);
+        assert(buffer.getStats().extrapolated == 0);
+    }
+
+    void
+    testOrientationWrap() {
+        auto buffer = oni::InterpolationBuffer(makeConfig());
+        buffer.push(1, 1.0, {}, {oni::PI - 0.1f});
+        buffer.push(1, 2.0, {}, {-oni::PI + 0.1f});
+
+        auto pos = oni::WorldP3D{};
+        auto ornt = oni::Orientation{};
+        assert(buffer.sample(1, 1.6, pos, ornt));
+        // NOTE: The short way round goes through PI, not through 0
+        assert(near(ornt.value, oni::PI));
+
+        assert(buffer.sample(1, 1.35, pos, ornt));
+        assert(near(ornt.value, oni::PI - 0.05f));
+    }
+
+    void
+    testExtrapolation() {
+        auto buffer = oni::InterpolationBuffer(makeConfig());
+        buffer.push(1, 1.0, {0.f, 0.f, 0.f}, {0.f});
+        buffer.push(1, 2.0, {10.f, -10.f, 0.f}, {0.5f});
+
+        auto pos = oni::WorldP3D{};
+        auto ornt = oni::Orientation{};
+        assert(buffer.sample(1, 2.2, pos, ornt));
+        assert(near(pos.x, 11.f));
+        assert(near(pos.y, -11.f));
+        assert(near(ornt.value, 0.55f));
+        assert(buffer.getStats().extrapolated == 1);
+        assert(buffer.getStats().starved == 0);
+
+        // NOTE: Past maxExtrapolation it stops at the limit and stays there
+        assert(buffer.sample(1, 2.6, pos, ornt));
+        assert(near(pos.x, 12.5f));
+        assert(near(ornt.value, 0.625f));
+        assert(buffer.sample(1, 5.0, pos, ornt));
+        assert(near(pos.x, 12.5f));
+        assert(near(pos.y, -12.5f));
+        assert(buffer.getStats().extrapolated == 1);
+        assert(buffer.getStats().starved == 2);
+    }
+
+    void
+    testOutOfOrder() {
+        auto buffer = oni::InterpolationBuffer(makeConfig());
+        buffer.push(1, 2.0, {20.f, 0.f, 0.f}, {});
+        buffer.push(1, 1.0, {10.f, 0.f, 0.f}, {});
+        buffer.push(1, 2.0, {30.f, 0.f, 0.f}, {});
+        assert(buffer.getStats().outOfOrder == 2);
+
+        // NOTE: Other entities are buffered on their own
+        buffer.push(2, 1.0, {}, {});
+        assert(buffer.getStats().outOfOrder == 2);
+
+        auto pos = oni::WorldP3D{};
+        auto ornt = oni::Orientation{};
+        assert(buffer.sample(1, 1.6, pos, ornt));
+        assert(near(pos.x, 20.f));
+        assert(buffer.sample(1, 3.0, pos, ornt));
+        assert(near(pos.x, 20.f));
+        // NOTE: A single snapshot has no velocity to extrapolate with
+        assert(buffer.getStats().starved == 1);
+    }
+
+    void
+    testPrune() {
+        auto buffer = oni::InterpolationBuffer(makeConfig());
+        for (auto i = 1; i <= 5; ++i) {
+            buffer.push(1, i, {i * 10.f, 0.f, 0.f}, {});
+        }
+
+        auto pos = oni::WorldP3D{};
+        auto ornt = oni::Orientation{};
+        assert(buffer.sample(1, 3.6, pos, ornt));
+        assert(near(pos.x, 35.f));
+
+        // NOTE: Everything is behind the render time, the last two stay for extrapolation
+        buffer.prune(10.1);
+        assert(buffer.sample(1, 3.6, pos, ornt));
+        assert(near(pos.x, 40.f));
+        assert(buffer.sample(1, 4.6, pos, ornt));
+        assert(near(pos.x, 45.f));
+
+        buffer.remove(1);
+        assert(!buffer.sample(1, 4.6, pos, ornt));
+    }
+}
+
+namespace oni {
+    void
+    OniTestInterpolation::run() {
+        testBracketing();
+        testOrientationWrap();
+        testExtrapolation();
+        testOutOfOrder();
+        testPrune();
+    }
+}
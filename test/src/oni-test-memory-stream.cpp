@@ -0,0 +1,54 @@
+#include <oni-test/oni-test-memory-stream.h>
+
+#include <cassert>
+#include <istream>
+#include <string>
+
+#include <oni-core/util/oni-util-memory-stream.h>
+
+
+namespace {
+    void
+    testRead() {
+        auto data = std::string("hello world");
+        auto buffer = oni::MemoryInputBuffer(data.data(), data.size());
+        auto stream = std::istream(&buffer);
+
+        auto word = std::string{};
+        stream >> word;
+        assert(word == "hello");
+        stream >> word;
+        assert(word == "world");
+
+        stream >> word;
+        assert(stream.eof());
+    }
+
+    void
+    testSeek() {
+        auto data = std::string("0123456789");
+        auto buffer = oni::MemoryInputBuffer(data.data(), data.size());
+        auto stream = std::istream(&buffer);
+
+        stream.seekg(4);
+        assert(stream.get() == '4');
+        assert(stream.tellg() == 5);
+
+        stream.seekg(-2, std::ios_base::end);
+        assert(stream.get() == '8');
+
+        stream.seekg(-3, std::ios_base::cur);
+        assert(stream.get() == '6');
+
+        stream.seekg(20);
+        assert(stream.fail());
+    }
+}
+
+namespace oni {
+    void
+    OniTestMemoryStream::run() {
+        testRead();
+        testSeek();
+    }
+}
@@ -0,0 +1,49 @@
+#include <oni-test/oni-test-profiler.h>
+
+#include <cassert>
+#include <vector>
+
+#include <oni-core/util/oni-util-profiler.h>
+
+
+namespace {
+    void
+    testRingWrapAround() {
+        auto buffer = oni::ProfileThreadBuffer(0, 8);
+        for (oni::u64 i = 0; i < 20; ++i) {
+            buffer.push("zone", i, i + 1);
+        }
+
+        auto samples = std::vector<oni::ProfileSample>();
+        buffer.copy(samples);
+
+        assert(samples.size() == 8);
+        for (oni::u64 i = 0; i < samples.size(); ++i) {
+            assert(samples[i].startNS == 12 + i);
+            assert(samples[i].endNS == 13 + i);
+        }
+    }
+
+    void
+    testPartialRing() {
+        auto buffer = oni::ProfileThreadBuffer(3, 8);
+        buffer.push("a", 1, 2);
+        buffer.push("b", 3, 4);
+
+        auto samples = std::vector<oni::ProfileSample>();
+        buffer.copy(samples);
+
+        assert(buffer.getThreadIdx() == 3);
+        assert(samples.size() == 2);
+        assert(samples[0].startNS == 1);
+        assert(samples[1].startNS == 3);
+    }
+}
+
+namespace oni {
+    void
+    OniTestProfiler::run() {
+        testRingWrapAround();
+        testPartialRing();
+    }
+}
@@ -0,0 +1,133 @@
+#include <oni-test/oni-test-rand.h>
+
+#include <cassert>
+#include <vector>
+
+#include <oni-core/math/oni-math-rand.h>
+
+
+namespace {
+    void
+    testExplicitSeed() {
+        auto a = oni::Rand(1, 2);
+        auto b = oni::Rand(1, 2);
+        auto c = oni::Rand(1, 3);
+        auto differs = false;
+        for (auto i = 0; i < 16; ++i) {
+            auto value = a.next_u32();
+            assert(value == b.next_u32());
+            differs |= value != c.next_u32();
+            assert(a.next_u64() == b.next_u64());
+            c.next_u64();
+        }
+        assert(differs);
+    }
+
+    void
+    testSplit() {
+        auto rand = oni::Rand(42);
+        auto first = rand.split();
+        auto fresh = oni::Rand(42);
+        assert(first.next_u64() == fresh.next_u64());
+        assert(first.next_u32() == fresh.next_u32());
+
+        auto jumped = oni::Rand(42);
+        jumped.jump();
+        assert(rand.next_u64() == jumped.next_u64());
+        assert(rand.next_u32() == jumped.next_u32());
+    }
+
+    void
+    testStreams() {
+        oni::setRandMasterSeed(42);
+        auto entities = oni::makeRandStream(oni::RandStream::ENTITIES);
+        auto physics = oni::makeRandStream(oni::RandStream::PHYSICS);
+        auto value = entities.next_u64();
+        assert(value == oni::makeRandStream(oni::RandStream::ENTITIES).next_u64());
+        assert(value != physics.next_u64());
+        oni::setRandMasterSeed(0);
+    }
+
+    // NOTE: Batch lanes of one stream must not replay the scalar draws of any stream, its own included
+    void
+    testStreamLanesIndependent() {
+        constexpr auto NumLanes = oni::Rand::NumRandLanes;
+        constexpr auto PerLane = 128;
+        oni::setRandMasterSeed(42);
+
+        for (auto s = 0; s < static_cast<int>(oni::RandStream::LAST); ++s) {
+            auto batch = oni::makeRandStream(static_cast<oni::RandStream>(s));
+            auto lanes = std::vector<oni::r32>(NumLanes * PerLane);
+            batch.fill_r32(lanes.data(), lanes.size(), 0.f, 1.f);
+
+            for (auto t = 0; t < static_cast<int>(oni::RandStream::LAST); ++t) {
+                auto scalar = oni::makeRandStream(static_cast<oni::RandStream>(t));
+                auto draws = std::vector<oni::r32>(PerLane);
+                for (auto &&draw: draws) {
+                    draw = scalar.next_r32();
+                }
+                for (auto l = 0; l < NumLanes; ++l) {
+                    auto matches = 0;
+                    for (auto i = 0; i < PerLane; ++i) {
+                        matches += lanes[l + i * NumLanes] == draws[i];
+                    }
+                    assert(matches == 0);
+                }
+            }
+        }
+        oni::setRandMasterSeed(0);
+    }
+
+    void
+    testBounded() {
+        auto rand = oni::Rand(7);
+        auto seen = std::vector<bool>(6);
+        for (auto i = 0; i < 1000; ++i) {
+            auto value = rand.next<oni::u8>(3, 9);
+            assert(value >= 3 && value < 9);
+            seen[value - 3] = true;
+            assert(rand.next<oni::u64>(5, oni::u64{1} << 63u) >= 5);
+        }
+        for (auto s: seen) {
+            assert(s);
+        }
+    }
+
+    void
+    testFill() {
+        auto a = oni::Rand(11);
+        auto b = oni::Rand(11);
+        // NOTE: Not a multiple of the lane count to cover the tail
+        auto values = std::vector<oni::r32>(1001);
+        auto same = std::vector<oni::r32>(values.size());
+        a.fill_r32(values.data(), values.size(), -2.f, 3.f);
+        b.fill_r32(same.data(), same.size(), -2.f, 3.f);
+        assert(values == same);
+        for (auto value: values) {
+            assert(value >= -2.f && value < 3.f);
+        }
+
+        auto ints = std::vector<oni::u32>(1001);
+        a.fill_u32(ints.data(), ints.size(), 10, 17);
+        for (auto value: ints) {
+            assert(value >= 10 && value < 17);
+        }
+
+        a.fill_norm(values.data(), values.size(), 5.f, 0.f);
+        for (auto value: values) {
+            assert(value == 5.f);
+        }
+    }
+}
+
+namespace oni {
+    void
+    OniTestRand::run() {
+        testExplicitSeed();
+        testSplit();
+        testStreams();
+        testStreamLanesIndependent();
+        testBounded();
+        testFill();
+    }
+}
@@ -0,0 +1,137 @@
+#include <oni-test/oni-test-replay.h>
+
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+
+#include <oni-core/entities/oni-entities-replay.h>
+
+
+namespace {
+    constexpr auto KeyW = static_cast<oni::oniKeyPress>(87);
+    constexpr auto KeyA = static_cast<oni::oniKeyPress>(65);
+
+    std::string
+    replayPath() {
+        return (std::filesystem::temp_directory_path() / "oni-test-replay.onir").string();
+    }
+
+    oni::Input
+    makeInput(bool left) {
+        auto input = oni::Input{};
+        input.setPressed(KeyW);
+        if (left) {
+            input.setPressed(KeyA);
+        }
+        return input;
+    }
+
+    void
+    record(const std::string &path) {
+        auto recorder = oni::ReplayRecorder{};
+        auto opened = recorder.open(path, 0x0123456789ABCDEFu);
+        assert(opened);
+        recorder.recordWorld("world");
+
+        recorder.recordClientJoined("alice", 7);
+        recorder.recordInput("alice", makeInput(false));
+        recorder.endTick(1 / 60.0);
+
+        recorder.recordClientJoined("bob", 9);
+        // NOTE: Same as the last one, stored as a single bit
+        recorder.recordInput("alice", makeInput(false));
+        recorder.recordInput("bob", makeInput(true));
+        recorder.endTick(1 / 30.0);
+
+        recorder.endTick(1 / 60.0);
+
+        recorder.recordClientLeft("alice");
+        recorder.recordInput("bob", makeInput(false));
+        recorder.endTick(1 / 60.0);
+
+        assert(recorder.getTickCount() == 4);
+    }
+
+    void
+    testRoundTrip() {
+        auto path = replayPath();
+        record(path);
+
+        auto reader = oni::ReplayReader{};
+        auto opened = reader.open(path);
+        assert(opened);
+        assert(reader.getWorld() == "world");
+        assert(reader.getRandMasterSeed() == 0x0123456789ABCDEFu);
+
+        auto tick = oni::ReplayTick{};
+        auto read = reader.next(tick);
+        assert(read);
+        assert(tick.dt == 1 / 60.0);
+        assert(tick.events.size() == 2);
+        assert(tick.events[0].type == oni::ReplayEventType::CLIENT_JOINED);
+        assert(tick.events[0].clientID == "alice");
+        assert(tick.events[0].carEntity == 7);
+        assert(tick.events[1].type == oni::ReplayEventType::CLIENT_INPUT);
+        assert(tick.events[1].clientID == "alice");
+        assert(tick.events[1].input.isPressed(KeyW));
+        assert(!tick.events[1].input.isPressed(KeyA));
+
+        read = reader.next(tick);
+        assert(read);
+        assert(tick.dt == 1 / 30.0);
+        assert(tick.events.size() == 3);
+        assert(tick.events[0].type == oni::ReplayEventType::CLIENT_JOINED);
+        assert(tick.events[0].clientID == "bob");
+        assert(tick.events[0].carEntity == 9);
+        assert(tick.events[1].clientID == "alice");
+        assert(tick.events[1].input.isPressed(KeyW));
+        assert(!tick.events[1].input.isPressed(KeyA));
+        assert(tick.events[2].clientID == "bob");
+        assert(tick.events[2].input.isPressed(KeyA));
+
+        read = reader.next(tick);
+        assert(read);
+        assert(tick.events.empty());
+
+        read = reader.next(tick);
+        assert(read);
+        assert(tick.events.size() == 2);
+        assert(tick.events[0].type == oni::ReplayEventType::CLIENT_LEFT);
+        assert(tick.events[0].clientID == "alice");
+        assert(tick.events[1].type == oni::ReplayEventType::CLIENT_INPUT);
+        assert(!tick.events[1].input.isPressed(KeyA));
+
+        read = reader.next(tick);
+        assert(!read);
+        assert(reader.getTickCount() == 4);
+
+        std::remove(path.c_str());
+    }
+
+    void
+    testTruncatedTail() {
+        auto path = replayPath();
+        record(path);
+        // NOTE: As if the server crashed while writing the last tick
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+
+        auto reader = oni::ReplayReader{};
+        auto opened = reader.open(path);
+        assert(opened);
+
+        auto tick = oni::ReplayTick{};
+        while (reader.next(tick)) {}
+        assert(reader.getTickCount() == 3);
+
+        std::remove(path.c_str());
+    }
+}
+
+namespace oni {
+    void
+    OniTestReplay::run() {
+        testRoundTrip();
+        testTruncatedTail();
+    }
+}
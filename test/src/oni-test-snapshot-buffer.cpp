@@ -0,0 +1,55 @@
+#include <oni-test/oni-test-snapshot-buffer.h>
+
+#include <cassert>
+#include <thread>
+
+#include <oni-core/util/oni-util-snapshot-buffer.h>
+
+
+namespace {
+    void
+    testLatestWins() {
+        auto buffer = oni::SnapshotBuffer<oni::u32>();
+        assert(!buffer.acquire());
+
+        buffer.back() = 1;
+        buffer.publish();
+        buffer.back() = 2;
+        buffer.publish();
+
+        assert(buffer.acquire());
+        assert(buffer.front() == 2);
+        assert(!buffer.acquire());
+        assert(buffer.front() == 2);
+    }
+
+    void
+    testConcurrentMonotonic() {
+        constexpr oni::u32 count = 100 * 1000;
+        auto buffer = oni::SnapshotBuffer<oni::u32>();
+
+        auto writer = std::thread([&]() {
+            for (oni::u32 i = 1; i <= count; ++i) {
+                buffer.back() = i;
+                buffer.publish();
+            }
+        });
+
+        auto last = oni::u32{0};
+        while (last != count) {
+            if (buffer.acquire()) {
+                assert(buffer.front() > last);
+                last = buffer.front();
+            }
+        }
+        writer.join();
+    }
+}
+
+namespace oni {
+    void
+    OniTestSnapshotBuffer::run() {
+        testLatestWins();
+        testConcurrentMonotonic();
+    }
+}
@@ -0,0 +1,101 @@
+#include <oni-test/oni-test-spatial-grid.h>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include <oni-core/math/oni-math-spatial-grid.h>
+
+
+namespace {
+    std::vector<oni::EntityID>
+    query(const oni::SpatialGrid &grid,
+          oni::r32 minX,
+          oni::r32 minY,
+          oni::r32 maxX,
+          oni::r32 maxY) {
+        auto result = std::vector<oni::EntityID>{};
+        grid.query(minX, minY, maxX, maxY, [&](oni::EntityID id) { result.push_back(id); });
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    void
+    testQuery() {
+        auto grid = oni::SpatialGrid(4.f);
+        grid.update(1, 0.f, 0.f, 0.5f);
+        grid.update(2, 10.f, 0.f, 0.5f);
+        // NOTE: Center outside, edge inside
+        grid.update(3, -5.5f, 0.f, 1.9f);
+        // NOTE: Bigger than half a cell
+        grid.update(4, 40.f, 40.f, 38.f);
+        assert(grid.getCount() == 4);
+
+        assert((query(grid, -4.f, -4.f, 4.f, 4.f) == std::vector<oni::EntityID>{1, 3, 4}));
+        assert((query(grid, 8.f, -1.f, 12.f, 1.f) == std::vector<oni::EntityID>{2}));
+        assert((query(grid, 8.f, 2.f, 12.f, 3.f) == std::vector<oni::EntityID>{4}));
+        assert(query(grid, -100.f, -100.f, -90.f, -90.f).empty());
+        // NOTE: Spans more cells than are occupied
+        assert((query(grid, -1e5f, -1e5f, 1e5f, 1e5f) == std::vector<oni::EntityID>{1, 2, 3, 4}));
+    }
+
+    void
+    testMove() {
+        auto grid = oni::SpatialGrid(4.f);
+        for (oni::EntityID id = 0; id < 8; ++id) {
+            grid.update(id, 1.f, 1.f, 0.5f);
+        }
+        grid.update(3, 100.f, 100.f, 0.5f);
+        grid.update(5, 1.5f, 1.5f, 0.5f);
+        assert((query(grid, 99.f, 99.f, 101.f, 101.f) == std::vector<oni::EntityID>{3}));
+        assert((query(grid, 0.f, 0.f, 2.f, 2.f) == std::vector<oni::EntityID>{0, 1, 2, 4, 5, 6, 7}));
+
+        // NOTE: Growing past half a cell and back
+        grid.update(0, 1.f, 1.f, 10.f);
+        assert((query(grid, 10.f, 10.f, 10.5f, 10.5f) == std::vector<oni::EntityID>{0}));
+        grid.update(0, 1.f, 1.f, 0.5f);
+        assert(query(grid, 10.f, 10.f, 10.5f, 10.5f).empty());
+
+        grid.remove(6);
+        grid.remove(42);
+        assert(grid.getCount() == 7);
+        assert((query(grid, 0.f, 0.f, 2.f, 2.f) == std::vector<oni::EntityID>{0, 1, 2, 4, 5, 7}));
+    }
+
+    void
+    testRemoveStale() {
+        auto grid = oni::SpatialGrid(4.f);
+        for (oni::EntityID id = 0; id < 100; ++id) {
+            grid.update(id, static_cast<oni::r32>(id % 10), static_cast<oni::r32>(id / 10), 0.5f);
+        }
+        grid.removeStale();
+        assert(grid.getCount() == 100);
+
+        for (oni::EntityID id = 0; id < 100; id += 2) {
+            grid.update(id, static_cast<oni::r32>(id % 10), static_cast<oni::r32>(id / 10), 0.5f);
+        }
+        // NOTE: Removed explicitly after being updated, the sweep must not count it twice
+        grid.remove(0);
+        grid.removeStale();
+        assert(grid.getCount() == 49);
+
+        auto all = query(grid, -10.f, -10.f, 20.f, 20.f);
+        assert(all.size() == 49);
+        for (auto id: all) {
+            assert(id % 2 == 0 && id != 0);
+        }
+
+        grid.clear();
+        assert(grid.getCount() == 0);
+        assert(query(grid, -10.f, -10.f, 20.f, 20.f).empty());
+    }
+}
+
+namespace oni {
+    void
+    OniTestSpatialGrid::run() {
+        testQuery();
+        testMove();
+        testRemoveStale();
+    }
+}
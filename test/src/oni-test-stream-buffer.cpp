@@ -0,0 +1,206 @@
+#include <oni-test/oni-test-stream-buffer.h>
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <EGL/egl.h>
+#include <GL/glew.h>
+
+#include <oni-core/graphic/buffer/oni-graphic-stream-buffer.h>
+
+
+namespace {
+    constexpr GLsizei ViewSize = 64;
+    constexpr GLsizei VertexSize = 4 * sizeof(GLfloat);
+    constexpr GLsizei VerticesPerRegion = 64;
+    // NOTE: One pixel each, enough to wrap the ring many times over
+    constexpr oni::u32 BatchCount = 2000;
+
+    struct Context {
+        EGLDisplay display{EGL_NO_DISPLAY};
+        EGLSurface surface{EGL_NO_SURFACE};
+        EGLContext context{EGL_NO_CONTEXT};
+    };
+
+    // NOTE: Headless core profile context, under Mesa this runs on llvmpipe when there is no GPU.
+    bool
+    createContext(Context &ctx) {
+        // NOTE: No window system needed, only applies to Mesa and doesn't override what the caller set
+        setenv("EGL_PLATFORM", "surfaceless", 0);
+
+        ctx.display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        if (ctx.display == EGL_NO_DISPLAY || !eglInitialize(ctx.display, nullptr, nullptr)) {
+            return false;
+        }
+
+        EGLint configAttribs[] = {EGL_RED_SIZE, 8,
+                                  EGL_GREEN_SIZE, 8,
+                                  EGL_BLUE_SIZE, 8,
+                                  EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+                                  EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+                                  EGL_NONE};
+        auto config = EGLConfig{};
+        auto configCount = EGLint{0};
+        if (!eglChooseConfig(ctx.display, configAttribs, &config, 1, &configCount) || !configCount) {
+            return false;
+        }
+
+        EGLint surfaceAttribs[] = {EGL_WIDTH, ViewSize, EGL_HEIGHT, ViewSize, EGL_NONE};
+        ctx.surface = eglCreatePbufferSurface(ctx.display, config, surfaceAttribs);
+        if (ctx.surface == EGL_NO_SURFACE || !eglBindAPI(EGL_OPENGL_API)) {
+            return false;
+        }
+
+        EGLint contextAttribs[] = {EGL_CONTEXT_MAJOR_VERSION, 4,
+                                   EGL_CONTEXT_MINOR_VERSION, 4,
+                                   EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                                   EGL_NONE};
+        ctx.context = eglCreateContext(ctx.display, config, EGL_NO_CONTEXT, contextAttribs);
+        if (ctx.context == EGL_NO_CONTEXT || !eglMakeCurrent(ctx.display, ctx.surface, ctx.surface, ctx.context)) {
+            return false;
+        }
+
+        // NOTE: glewInit() also sets up GLX, which fails without an X display. Only the GL entry points are needed.
+        glewExperimental = GL_TRUE;
+        return glewContextInit() == GLEW_OK;
+    }
+
+    void
+    destroyContext(Context &ctx) {
+        if (ctx.display == EGL_NO_DISPLAY) {
+            return;
+        }
+        eglMakeCurrent(ctx.display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        if (ctx.context != EGL_NO_CONTEXT) {
+            eglDestroyContext(ctx.display, ctx.context);
+        }
+        if (ctx.surface != EGL_NO_SURFACE) {
+            eglDestroySurface(ctx.display, ctx.surface);
+        }
+        eglTerminate(ctx.display);
+    }
+
+    GLuint
+    compileShader(GLenum type,
+                  const char *source) {
+        auto shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, nullptr);
+        glCompileShader(shader);
+        auto status = GLint{};
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+        assert(status);
+        return shader;
+    }
+
+    // NOTE: Draws points at the position in xy with red from z
+    GLuint
+    createProgram() {
+        auto program = glCreateProgram();
+        auto vertex = compileShader(GL_VERTEX_SHADER,
+                                    "#version 330 core\n"
+                                    "layout(location = 0) in vec4 p;\n"
+                                    "flat out float v;\n"
+                                    "void main() { gl_Position = vec4(p.xy, 0, 1); v = p.z; }\n");
+        auto fragment = compileShader(GL_FRAGMENT_SHADER,
+                                      "#version 330 core\n"
+                                      "flat in float v;\n"
+                                      "out vec4 c;\n"
+                                      "void main() { c = vec4(v, 0, 0, 1); }\n");
+        glAttachShader(program, vertex);
+        glAttachShader(program, fragment);
+        glLinkProgram(program);
+        glDeleteShader(vertex);
+        glDeleteShader(fragment);
+        auto status = GLint{};
+        glGetProgramiv(program, GL_LINK_STATUS, &status);
+        assert(status);
+        return program;
+    }
+
+    oni::u8
+    batchValue(oni::u32 batch) {
+        return static_cast<oni::u8>(batch % 255 + 1);
+    }
+
+    // NOTE: Every batch draws to its own pixel and nothing waits on the GPU in between, so a region overwritten
+    // while its draws are still in flight shows up as a pixel with the wrong value.
+    void
+    testRingWrap() {
+        auto program = createProgram();
+        glUseProgram(program);
+        glViewport(0, 0, ViewSize, ViewSize);
+        glClearColor(0, 0, 0, 1);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        auto stream = oni::StreamBuffer(VerticesPerRegion * VertexSize, VertexSize);
+        auto vao = GLuint{};
+        glGenVertexArrays(1, &vao);
+        glBindVertexArray(vao);
+        stream.bind();
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, VertexSize, nullptr);
+        stream.unbind();
+
+        for (oni::u32 batch = 0; batch < BatchCount; ++batch) {
+            // NOTE: Varying sizes so batches straddle region boundaries
+            auto count = static_cast<GLsizei>(1 + (batch * 7) % VerticesPerRegion);
+            auto px = static_cast<GLfloat>(batch % ViewSize);
+            auto py = static_cast<GLfloat>(batch / ViewSize);
+            auto value = batchValue(batch) / 255.f;
+
+            auto *vertex = static_cast<GLfloat *>(stream.begin());
+            for (GLsizei i = 0; i < count; ++i) {
+                vertex[0] = (px + 0.5f) / (ViewSize / 2.f) - 1.f;
+                vertex[1] = (py + 0.5f) / (ViewSize / 2.f) - 1.f;
+                vertex[2] = value;
+                vertex[3] = 1.f;
+                vertex += 4;
+            }
+            auto first = stream.end(vertex);
+            assert(first >= 0);
+            assert(first + count <= VerticesPerRegion * oni::StreamBuffer::DefaultRegionCount);
+
+            glDrawArrays(GL_POINTS, first, count);
+        }
+
+        auto pixels = std::vector<oni::u8>(ViewSize * ViewSize * 4);
+        glReadPixels(0, 0, ViewSize, ViewSize, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        for (oni::u32 batch = 0; batch < BatchCount; ++batch) {
+            assert(pixels[batch * 4] == batchValue(batch));
+        }
+        assert(glGetError() == GL_NO_ERROR);
+
+        const auto &stats = stream.getStats();
+        assert(stats.batches == BatchCount);
+        // NOTE: Every region is reused many times, each reuse waits on its fence
+        assert(stats.fenceWaits > BatchCount / VerticesPerRegion);
+        assert(stats.stalls <= stats.fenceWaits);
+        assert(stats.stalls || !stats.stallNs);
+        printf("StreamBuffer: %u batches, %u fence waits, %u stalls, %llu ns stalled\n", stats.batches,
+               stats.fenceWaits, stats.stalls, static_cast<unsigned long long>(stats.stallNs));
+
+        stream.resetStats();
+        assert(!stream.getStats().batches);
+        assert(!stream.getStats().fenceWaits);
+
+        glDeleteVertexArrays(1, &vao);
+        glDeleteProgram(program);
+    }
+}
+
+namespace oni {
+    void
+    OniTestStreamBuffer::run() {
+        auto ctx = Context{};
+        if (!createContext(ctx) || !StreamBuffer::isSupported()) {
+            printf("StreamBuffer: skipped, no headless GL 4.4 context\n");
+            destroyContext(ctx);
+            return;
+        }
+
+        testRingWrap();
+        destroyContext(ctx);
+    }
+}
@@ -0,0 +1,56 @@
+#include <oni-test/oni-test-thread-pool.h>
+
+#include <cassert>
+
+#include <oni-core/util/oni-util-thread-pool.h>
+
+
+namespace {
+    void
+    testNoWorkers() {
+        auto pool = oni::ThreadPool(0);
+        assert(pool.getWorkerCount() == 0);
+
+        auto remaining = std::atomic<oni::u32>{3};
+        auto counter = 0;
+        for (auto i = 0; i < 3; ++i) {
+            pool.submit([&]() {
+                ++counter;
+                --remaining;
+            });
+        }
+        pool.helpUntil(remaining);
+
+        assert(counter == 3);
+    }
+
+    void
+    testNestedSubmit() {
+        constexpr oni::u32 count = 1000;
+        auto pool = oni::ThreadPool(3);
+        auto remaining = std::atomic<oni::u32>{count * 2};
+        auto counter = std::atomic<oni::u32>{0};
+
+        for (oni::u32 i = 0; i < count; ++i) {
+            pool.submit([&]() {
+                pool.submit([&]() {
+                    ++counter;
+                    --remaining;
+                });
+                ++counter;
+                --remaining;
+            });
+        }
+        pool.helpUntil(remaining);
+
+        assert(counter == count * 2);
+    }
+}
+
+namespace oni {
+    void
+    OniTestThreadPool::run() {
+        testNoWorkers();
+        testNestedSubmit();
+    }
+}
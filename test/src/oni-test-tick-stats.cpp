@@ -0,0 +1,47 @@
+#include <oni-test/oni-test-tick-stats.h>
+
+#include <cassert>
+
+#include <oni-core/util/oni-util-tick-stats.h>
+
+
+namespace {
+    void
+    testEmpty() {
+        auto stats = oni::TickStats(16);
+        auto summary = stats.summarize();
+        assert(summary.count == 0);
+        assert(summary.maxNS == 0);
+    }
+
+    void
+    testPercentiles() {
+        auto stats = oni::TickStats(100);
+        // NOTE: Added in reverse to make sure order doesn't matter
+        for (oni::u64 i = 100; i > 0; --i) {
+            stats.add(i);
+        }
+
+        auto summary = stats.summarize();
+        assert(summary.count == 100);
+        assert(summary.p50NS == 50);
+        assert(summary.p99NS == 99);
+        assert(summary.maxNS == 100);
+
+        stats.reset();
+        stats.add(7);
+        summary = stats.summarize();
+        assert(summary.count == 1);
+        assert(summary.p50NS == 7);
+        assert(summary.p99NS == 7);
+        assert(summary.maxNS == 7);
+    }
+}
+
+namespace oni {
+    void
+    OniTestTickStats::run() {
+        testEmpty();
+        testPercentiles();
+    }
+}
@@ -0,0 +1,59 @@
+#include <oni-test/oni-test-transformation.h>
+
+#include <cassert>
+#include <cmath>
+
+#include <oni-core/common/oni-common-const.h>
+#include <oni-core/math/oni-math-transformation.h>
+
+
+namespace {
+    bool
+    near(oni::r32 a,
+         oni::r32 b) {
+        return std::abs(a - b) < 1e-4f;
+    }
+
+    void
+    testLocalToWorld() {
+        auto pos = oni::WorldP3D{1.f, 0.f, 0.3f};
+        auto ornt = oni::Orientation{0.25f};
+        oni::localToWorldTransform({10.f, 5.f, 0.9f}, {oni::HALF_PI}, pos, ornt);
+
+        assert(near(pos.x, 10.f));
+        assert(near(pos.y, 6.f));
+        // NOTE: Child z is not affected by the parent
+        assert(pos.z == 0.3f);
+        assert(near(ornt.value, oni::HALF_PI + 0.25f));
+    }
+
+    void
+    testNested() {
+        auto grandParentPos = oni::WorldP3D{3.f, -2.f, 0.f};
+        auto grandParentOrnt = oni::Orientation{0.7f};
+        auto parentPos = oni::WorldP3D{1.5f, 4.f, 0.f};
+        auto parentOrnt = oni::Orientation{-1.3f};
+        auto childPos = oni::WorldP3D{-2.f, 0.5f, 0.f};
+        auto childOrnt = oni::Orientation{0.1f};
+
+        auto expected = oni::createTransformation(grandParentPos, grandParentOrnt) *
+                        oni::createTransformation(parentPos, parentOrnt) *
+                        childPos.value;
+
+        // NOTE: Resolving the parent first and the child against it, as System_WorldTransform does
+        oni::localToWorldTransform(grandParentPos, grandParentOrnt, parentPos, parentOrnt);
+        oni::localToWorldTransform(parentPos, parentOrnt, childPos, childOrnt);
+
+        assert(near(childPos.x, expected.x));
+        assert(near(childPos.y, expected.y));
+        assert(near(childOrnt.value, 0.7f - 1.3f + 0.1f));
+    }
+}
+
+namespace oni {
+    void
+    OniTestTransformation::run() {
+        testLocalToWorld();
+        testNested();
+    }
+}
@@ -7,6 +7,7 @@
 
 #include <oni-core/component/oni-component-geometry.h>
 #include <oni-core/component/oni-component-visual.h>
+#include <oni-core/util/oni-util-snapshot-buffer.h>
 
 #include <oni-particle-editor/entities/oni-particle-editor-entities-fwd.h>
 #include <oni-particle-editor/entities/oni-particle-editor-entities-structure.h>
@@ -39,6 +40,18 @@ namespace oni {
         void
         _finish() override;
 
+        void
+        _publish() override;
+
+        void
+        _capturePrevious() override;
+
+        void
+        _attachRenderContext() override;
+
+        void
+        _detachRenderContext() override;
+
     protected:
         void
         initRenderer() override;
@@ -73,9 +86,13 @@ namespace oni {
         oni::AssetFilesIndex *mAssetFilesIdx{};
         oni::EntityManager *mEntityMng{};
         oni::Input *mInput{};
+        oni::ParticleManager *mParticleMng{};
         oni::Physics *mPhysics{};
         std::vector<oni::System *> mSystems{};
+        oni::SystemScheduler *mSystemScheduler{};
+        oni::ThreadPool *mThreadPool{};
         oni::SceneManager *mSceneMng{};
+        oni::SnapshotBuffer<oni::RenderSnapshot> *mRenderSnapshots{};
         oni::TextureManager *mTextureMng{};
         oni::Window *mWindow{};
         oni::ZLayerManager *mZLayerMng{};
@@ -12,6 +12,7 @@
 #include <oni-core/graphic/oni-graphic-brush.h>
 #include <oni-core/graphic/oni-graphic-debug-draw-box2d.h>
 #include <oni-core/graphic/oni-graphic-font-manager.h>
+#include <oni-core/graphic/oni-graphic-particle.h>
 #include <oni-core/graphic/oni-graphic-scene-manager.h>
 #include <oni-core/graphic/oni-graphic-system.h>
 #include <oni-core/graphic/oni-graphic-texture-manager.h>
@@ -21,6 +22,8 @@
 #include <oni-core/math/oni-math-z-layer-manager.h>
 #include <oni-core/physics/oni-physics-system.h>
 #include <oni-core/physics/oni-physics.h>
+#include <oni-core/system/oni-system-scheduler.h>
+#include <oni-core/util/oni-util-thread-pool.h>
 
 #include <oni-particle-editor/entities/oni-particle-editor-entities-structure.h>
 #include <oni-particle-editor/entities/oni-particle-editor-entities-factory.h>
@@ -53,10 +56,18 @@ namespace oni {
         mAssetFilesIdx = new AssetFilesIndex({{"oni-resources/textures"}},
                                              {{"oni-resources/audio", "index", "wav"}});
         mTextureMng = new oni::TextureManager(*mAssetFilesIdx);
+        mParticleMng = new oni::ParticleManager(*mTextureMng);
         mInput = new oni::Input();
         mZLayerMng = new oni::ZLayerManager();
         mPhysics = new oni::Physics();
         mEntityMng = new oni::EntityManager(SimMode::CLIENT, mPhysics);
+        mThreadPool = new oni::ThreadPool(oni::ThreadPool::defaultWorkerCount());
+        mSystemScheduler = new oni::SystemScheduler(*mThreadPool);
+        mEntityMng->setThreadPool(mThreadPool);
+        mRenderSnapshots = new oni::SnapshotBuffer<oni::RenderSnapshot>();
+
+        // NOTE: Render from snapshots and interpolate so the editor draws smoothly at any refresh rate.
+        setLoopMode(GameLoopMode::FIXED_STEP);
     }
 
     ParticleEditorGame::~ParticleEditorGame() {
@@ -119,11 +130,16 @@ namespace oni {
     ParticleEditorGame::initSystems() {
         mSystems.push_back(new oni::System_GrowOverTime(*mEntityMng));
         mSystems.push_back(new oni::System_MaterialTransition(*mEntityMng));
-        mSystems.push_back(new oni::System_ParticleEmitter(*mEntityMng, *mEntityMng, *mSceneMng, *mEntityFactory));
+        mSystems.push_back(new oni::System_ParticleEmitter(*mEntityMng, *mParticleMng, *mSceneMng));
         mSystems.push_back(new oni::System_TimeToLive(*mEntityMng));
         mSystems.push_back(new oni::System_SyncPos(*mEntityMng));
-        mSystems.push_back(new oni::System_ParticleEmitter(*mEntityMng, *mEntityMng, *mSceneMng, *mEntityFactory));
         mSystems.push_back(new oni::System_PositionAndVelocity(*mEntityMng));
+        // NOTE: After everything that moves entities
+        mSystems.push_back(new oni::System_WorldTransform(*mEntityMng));
+
+        for (auto &&system: mSystems) {
+            mSystemScheduler->add(system);
+        }
     }
 
     void
@@ -203,20 +219,10 @@ namespace oni {
 
     void
     ParticleEditorGame::_sim(r64 dt) {
-        for (auto &&system: mSystems) {
-            system->tick(dt);
-        }
+        mSystemScheduler->tick(dt);
 
 #if 0
-        auto view = mEntityMng->createView<EntityName>();
-        mInforSideBar.particleCount = 0;
-        for (auto &&id: view) {
-            auto entityName = view.get<EntityName>(id);
-            constexpr auto particle = EntityNameEditor::GET("simple-particle");
-            if (entityName == particle) {
-                ++mInforSideBar.particleCount;
-            }
-        }
+        mInforSideBar.particleCount = mParticleMng->getParticleCount();
 
         // NOTE: This is needed because AntTweakBar can only update the id field not the HashedString.
         mInforSideBar.entityName = EntityNameEditor::at(mInforSideBar.entityName.id);
@@ -227,7 +233,9 @@ namespace oni {
     ParticleEditorGame::_render(r64 dt) {
         mWindow->clear();
 
-        mSceneMng->submit(*mEntityMng);
+        mRenderSnapshots->acquire();
+        mSceneMng->submit(mRenderSnapshots->front(), getRenderAlpha());
+        mSceneMng->submit(*mParticleMng);
         mSceneMng->render();
 
 #if 0
@@ -308,6 +316,27 @@ namespace oni {
         mInput->reset();
     }
 
+    void
+    ParticleEditorGame::_publish() {
+        mSceneMng->capture(*mEntityMng, mRenderSnapshots->back());
+        mRenderSnapshots->publish();
+    }
+
+    void
+    ParticleEditorGame::_capturePrevious() {
+        mSceneMng->capturePrevious(*mEntityMng);
+    }
+
+    void
+    ParticleEditorGame::_attachRenderContext() {
+        mWindow->attachContext();
+    }
+
+    void
+    ParticleEditorGame::_detachRenderContext() {
+        mWindow->detachContext();
+    }
+
     void
     ParticleEditorGame::showFPS(i16 fps) {
         mInfoSideBar.fps = fps;